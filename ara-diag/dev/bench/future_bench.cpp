@@ -0,0 +1,109 @@
+/*
+ * ara::core::Future vs std::future.
+ * Plain std::chrono timing; allocation counts come from the replaced
+ * global operator new below.
+ */
+#include "ara/core/result_future.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <new>
+#include <thread>
+
+static std::atomic<std::uint64_t> g_allocs{0};
+
+void *operator new(std::size_t size) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+volatile int g_sink;
+
+template <typename F>
+void run(const char *name, int iterations, F &&body) {
+    const std::uint64_t allocsBefore = g_allocs.load();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) body(i);
+    const auto end = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    const double allocs = static_cast<double>(g_allocs.load() - allocsBefore) / iterations;
+    std::printf("%-40s %10.1f ns/op %6.2f allocs/op\n", name, ns, allocs);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const int n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const int handoffs = n / 20;
+
+    run("ara ready future GetResult", n, [](int i) {
+        ara::core::Future<int> f(ara::core::Result<int>{ i });
+        g_sink = f.GetResult().Value();
+    });
+    run("ara promise set before get_future", n, [](int i) {
+        ara::core::Promise<int> p;
+        p.set_value(i);
+        g_sink = p.get_future().GetResult().Value();
+    });
+    run("ara promise get_future before set", n, [](int i) {
+        ara::core::Promise<int> p;
+        auto f = p.get_future();
+        p.set_value(i);
+        g_sink = f.GetResult().Value();
+    });
+    run("std promise/future same thread", n, [](int i) {
+        std::promise<int> p;
+        auto f = p.get_future();
+        p.set_value(i);
+        g_sink = f.get();
+    });
+
+    run("ara ready then() x2", n, [](int i) {
+        auto f = ara::core::Future<int>(ara::core::Result<int>{ i })
+                     .then([](ara::core::Future<int> x) { return x.GetResult().Value() + 1; })
+                     .then([](ara::core::Future<int> x) { return x.GetResult().Value() * 2; });
+        g_sink = f.GetResult().Value();
+    });
+    run("ara pending then() x2", n, [](int i) {
+        ara::core::Promise<int> p;
+        auto f = p.get_future()
+                     .then([](ara::core::Future<int> x) { return x.GetResult().Value() + 1; })
+                     .then([](ara::core::Future<int> x) { return x.GetResult().Value() * 2; });
+        p.set_value(i);
+        g_sink = f.GetResult().Value();
+    });
+    run("std emulated continuation x2", n, [](int i) {
+        std::promise<int> p0, p1, p2;
+        auto f0 = p0.get_future();
+        auto f1 = p1.get_future();
+        auto f2 = p2.get_future();
+        p0.set_value(i);
+        p1.set_value(f0.get() + 1);
+        p2.set_value(f1.get() * 2);
+        g_sink = f2.get();
+    });
+
+    run("ara cross-thread handoff", handoffs, [](int i) {
+        ara::core::Promise<int> p;
+        auto f = p.get_future();
+        std::thread t([&p, i] { p.set_value(i); });
+        g_sink = f.GetResult().Value();
+        t.join();
+    });
+    run("std cross-thread handoff", handoffs, [](int i) {
+        std::promise<int> p;
+        auto f = p.get_future();
+        std::thread t([&p, i] { p.set_value(i); });
+        g_sink = f.get();
+        t.join();
+    });
+    return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * Batched sampler for monitor-internal debouncing. Monitors are spread over
+ * a small worker pool; each worker samples its monitors once per period in
+ * groups of batchSize and pushes the derived MonitorActions to the daemon
+ * with one ring operation per group.
+ */
+#ifndef ARA_DIAG_FDC_POLL_SCHEDULER_H_
+#define ARA_DIAG_FDC_POLL_SCHEDULER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "ara/diag/fdc_polling.h"
+#include "ara/diag/ipc/report_ring.h"
+
+namespace ara {
+namespace diag {
+namespace ipc {
+
+class FdcPollScheduler {
+public:
+    static FdcPollScheduler &Instance();
+
+    std::error_code Configure(const FdcPollingConfig &cfg);
+
+    // getFdc must stay valid until Remove(handle) returned.
+    void Add(std::uint32_t handle, const std::function<std::int8_t()> *getFdc);
+    void Remove(std::uint32_t handle);
+
+private:
+    struct Entry {
+        std::uint32_t handle;
+        const std::function<std::int8_t()> *getFdc;
+        std::int8_t lastFdc;
+        std::uint8_t lastQualified;   // 0 none, 1 passed, 2 failed
+    };
+
+    struct Worker {
+        std::mutex mutex;             // held while sampling; Remove() waits on it
+        std::vector<Entry> entries;
+        std::vector<ReportRecord> pending;
+        std::thread thread;
+    };
+
+    FdcPollScheduler() = default;
+    ~FdcPollScheduler();
+
+    void StartLocked();
+    void Run(Worker &worker);
+    void SampleBatch(Worker &worker, std::size_t first, std::size_t last);
+
+    std::mutex mutex_;                // guards configuration and worker list
+    std::condition_variable stopCv_;
+    bool stop_{false};
+    FdcPollingConfig cfg_{};
+    std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+} // namespace ipc
+} // namespace diag
+} // namespace ara
+
+#endif // ARA_DIAG_FDC_POLL_SCHEDULER_H_
@@ -0,0 +1,88 @@
+/*
+ * Client side of the ara-diag <-> diagnostic-manager transport.
+ * One channel per process; created lazily on the first Monitor::Offer() or
+ * Event request. Status subscriptions are served by a dispatcher thread that
+ * is started with the first subscription.
+ */
+#ifndef ARA_DIAG_IPC_CLIENT_H_
+#define ARA_DIAG_IPC_CLIENT_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include "ara/diag/ipc/report_ring.h"
+#include "ara/diag/monitor_types.h"
+
+namespace ara {
+namespace diag {
+namespace ipc {
+
+class ClientChannel {
+public:
+    using StatusCallback = std::function<void(std::uint8_t)>;
+
+    static ClientChannel &Instance();
+
+    ClientChannel(const ClientChannel &) = delete;
+    ClientChannel &operator=(const ClientChannel &) = delete;
+
+    // Register a monitor with the daemon. On success handle is set.
+    std::error_code Offer(const std::string &specifier, DebounceKind kind,
+                          const CounterBased &counter, const TimeBased &time,
+                          std::uint32_t &handle);
+    void StopOffer(std::uint32_t handle);
+
+    // Hot path: enqueue one report into the calling thread's lane. Returns
+    // false if it had to be dropped.
+    bool Report(std::uint32_t handle, MonitorAction action) noexcept;
+
+    // Enqueue several reports with at most one wakeup. Returns the number
+    // of records accepted.
+    std::size_t ReportBatch(const ReportRecord *records, std::size_t count) noexcept;
+
+    // Subscribe to status changes of an event. On success handle and the
+    // current status are set; callback runs on the dispatcher thread.
+    std::error_code Subscribe(const std::string &specifier, std::uint32_t intervalMs,
+                              StatusCallback callback, std::uint32_t &handle, std::uint8_t &status);
+    void Unsubscribe(std::uint32_t handle);
+
+    // One-shot status query over the handshake socket.
+    std::error_code QueryStatus(const std::string &specifier, std::uint8_t &status);
+
+private:
+    ClientChannel() = default;
+    ~ClientChannel();
+
+    std::error_code ConnectLocked();
+    std::error_code RequestLocked(HandshakeMessage &msg);
+    std::uint32_t ThreadLane() noexcept;
+    bool Push(ReportRing &ring, const ReportRecord &record) noexcept;
+    void Wakeup() noexcept;
+    void DispatchLoop();
+
+    std::mutex mutex_;          // guards the handshake socket and dispatcher start
+    int socketFd_{-1};
+    int eventFd_{-1};
+    int statusEventFd_{-1};
+    int stopFd_{-1};
+    ClientSegment *segment_{nullptr};
+    std::atomic<ReportRing *> lanes_{nullptr};             // segment_->reports once connected
+    std::atomic<bool> laneTaken_[kReportLanes - 1] = {};   // owned lanes; the last one is shared
+    std::mutex sharedLaneMutex_;                           // serialises producers of the shared lane
+
+    std::thread dispatcher_;
+    std::mutex callbacksMutex_;
+    std::unordered_map<std::uint32_t, StatusCallback> callbacks_;   // by subscription handle
+};
+
+} // namespace ipc
+} // namespace diag
+} // namespace ara
+
+#endif // ARA_DIAG_IPC_CLIENT_H_
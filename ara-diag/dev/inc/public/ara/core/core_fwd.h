@@ -0,0 +1,19 @@
+#ifndef ARA_CORE_CORE_FWD_H_
+#define ARA_CORE_CORE_FWD_H_
+
+#include <system_error>
+
+namespace ara {
+namespace core {
+
+// Forward declarations for headers that only name the core types.
+// Default template arguments live here and nowhere else.
+class InstanceSpecifier;
+template <typename T, typename E = std::error_code> class Result;
+template <typename T> class Future;
+template <typename T> class Promise;
+
+} // namespace core
+} // namespace ara
+
+#endif // ARA_CORE_CORE_FWD_H_
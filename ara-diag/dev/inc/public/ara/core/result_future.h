@@ -1,51 +1,436 @@
 #ifndef ARA_CORE_RESULT_FUTURE_H_
 #define ARA_CORE_RESULT_FUTURE_H_
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <system_error>
+#include <type_traits>
 #include <utility>
+#include <variant>
+
+#include "ara/core/core_fwd.h"
 
 namespace ara {
 namespace core {
 
-// Minimal Result<T> and Result<void> stubs (header-only).
-template <typename T>
+namespace detail {
+template <typename R> struct IsResult : std::false_type {};
+template <typename T, typename E> struct IsResult<Result<T, E>> : std::true_type {};
+} // namespace detail
+
+// Result<T, E> holds either a value or an error in one discriminated union;
+// T need not be default-constructible and may be move-only. Value() and
+// Error() require HasValue() / HasError() respectively.
+template <typename T, typename E>
 class Result {
+    static_assert(!std::is_same<T, E>::value, "value and error type must differ");
+
 public:
-    Result() noexcept : ok_(true) {}
-    explicit Result(const std::error_code &ec) noexcept : ok_(false), error_(ec) {}
-    explicit Result(T value) noexcept : ok_(true), value_(std::move(value)) {}
+    using value_type = T;
+    using error_type = E;
+
+    explicit Result(const T &v) noexcept(std::is_nothrow_copy_constructible<T>::value)
+        : storage_(std::in_place_index<0>, v) {}
+    explicit Result(T &&v) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : storage_(std::in_place_index<0>, std::move(v)) {}
+    explicit Result(const E &e) noexcept(std::is_nothrow_copy_constructible<E>::value)
+        : storage_(std::in_place_index<1>, e) {}
+    explicit Result(E &&e) noexcept(std::is_nothrow_move_constructible<E>::value)
+        : storage_(std::in_place_index<1>, std::move(e)) {}
+
+    template <typename... Args>
+    static Result FromValue(Args &&...args) {
+        return Result(std::in_place_index<0>, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    static Result FromError(Args &&...args) {
+        return Result(std::in_place_index<1>, std::forward<Args>(args)...);
+    }
+
+    bool HasValue() const noexcept { return storage_.index() == 0; }
+    bool HasError() const noexcept { return storage_.index() == 1; }
+    bool IsOk() const noexcept { return HasValue(); }
+    explicit operator bool() const noexcept { return HasValue(); }
+
+    const T &Value() const & noexcept { return *std::get_if<0>(&storage_); }
+    T &Value() & noexcept { return *std::get_if<0>(&storage_); }
+    T &&Value() && noexcept { return std::move(*std::get_if<0>(&storage_)); }
+
+    const E &Error() const & noexcept { return *std::get_if<1>(&storage_); }
+    E &&Error() && noexcept { return std::move(*std::get_if<1>(&storage_)); }
 
-    bool IsOk() const noexcept { return ok_; }
-    const std::error_code &Error() const noexcept { return error_; }
-    const T &Value() const & { return value_; }
-    T &&Value() && { return std::move(value_); }
+    template <typename U>
+    T ValueOr(U &&defaultValue) const & {
+        return HasValue() ? Value() : static_cast<T>(std::forward<U>(defaultValue));
+    }
+    template <typename U>
+    T ValueOr(U &&defaultValue) && {
+        return HasValue() ? std::move(*this).Value() : static_cast<T>(std::forward<U>(defaultValue));
+    }
+
+    // f(T) -> U; errors pass through unchanged.
+    template <typename F>
+    auto Map(F &&f) && -> Result<std::invoke_result_t<F, T &&>, E> {
+        using U = std::invoke_result_t<F, T &&>;
+        if (HasError()) return Result<U, E>{ std::move(*this).Error() };
+        if constexpr (std::is_void<U>::value) {
+            std::forward<F>(f)(std::move(*this).Value());
+            return Result<U, E>{};
+        } else {
+            return Result<U, E>{ std::forward<F>(f)(std::move(*this).Value()) };
+        }
+    }
+
+    // f(T) -> Result<U, E>; errors pass through unchanged.
+    template <typename F>
+    auto AndThen(F &&f) && -> std::invoke_result_t<F, T &&> {
+        using R = std::invoke_result_t<F, T &&>;
+        static_assert(detail::IsResult<R>::value, "AndThen callback must return a Result");
+        if (HasError()) return R{ std::move(*this).Error() };
+        return std::forward<F>(f)(std::move(*this).Value());
+    }
+
+    // f(E) -> Result<T, E>; values pass through unchanged.
+    template <typename F>
+    Result OrElse(F &&f) && {
+        if (HasValue()) return std::move(*this);
+        return std::forward<F>(f)(std::move(*this).Error());
+    }
+
+    template <typename F>
+    auto Map(F &&f) const & { return Result(*this).Map(std::forward<F>(f)); }
+    template <typename F>
+    auto AndThen(F &&f) const & { return Result(*this).AndThen(std::forward<F>(f)); }
+    template <typename F>
+    Result OrElse(F &&f) const & { return Result(*this).OrElse(std::forward<F>(f)); }
 
 private:
-    bool ok_{false};
-    T value_{};
-    std::error_code error_;
+    template <std::size_t I, typename... Args>
+    explicit Result(std::in_place_index_t<I> tag, Args &&...args) : storage_(tag, std::forward<Args>(args)...) {}
+
+    std::variant<T, E> storage_;
 };
 
-template <>
-class Result<void> {
+// Result<void, E> is just an optional error.
+template <typename E>
+class Result<void, E> {
 public:
-    Result() noexcept : ok_(true) {}
-    explicit Result(const std::error_code &ec) noexcept : ok_(false), error_(ec) {}
+    using value_type = void;
+    using error_type = E;
+
+    Result() noexcept = default;
+    explicit Result(const E &e) noexcept(std::is_nothrow_copy_constructible<E>::value) : error_(e) {}
+    explicit Result(E &&e) noexcept(std::is_nothrow_move_constructible<E>::value) : error_(std::move(e)) {}
+
+    static Result FromValue() noexcept { return Result{}; }
+    template <typename... Args>
+    static Result FromError(Args &&...args) { return Result{ E(std::forward<Args>(args)...) }; }
+
+    bool HasValue() const noexcept { return !error_.has_value(); }
+    bool HasError() const noexcept { return error_.has_value(); }
+    bool IsOk() const noexcept { return HasValue(); }
+    explicit operator bool() const noexcept { return HasValue(); }
+
+    // A successful Result<void> reports a default-constructed error.
+    E Error() const noexcept(std::is_nothrow_copy_constructible<E>::value) {
+        return error_.has_value() ? *error_ : E{};
+    }
+
+    template <typename F>
+    auto Map(F &&f) const -> Result<std::invoke_result_t<F>, E> {
+        using U = std::invoke_result_t<F>;
+        if (HasError()) return Result<U, E>{ *error_ };
+        if constexpr (std::is_void<U>::value) {
+            std::forward<F>(f)();
+            return Result<U, E>{};
+        } else {
+            return Result<U, E>{ std::forward<F>(f)() };
+        }
+    }
+
+    template <typename F>
+    auto AndThen(F &&f) const -> std::invoke_result_t<F> {
+        using R = std::invoke_result_t<F>;
+        static_assert(detail::IsResult<R>::value, "AndThen callback must return a Result");
+        if (HasError()) return R{ *error_ };
+        return std::forward<F>(f)();
+    }
+
+    template <typename F>
+    Result OrElse(F &&f) const {
+        if (HasValue()) return *this;
+        return std::forward<F>(f)(*error_);
+    }
+
+private:
+    std::optional<E> error_;
+};
+
+enum class FutureStatus : std::uint8_t {
+    kReady = 1,
+    kTimeout
+};
+
+namespace detail {
+
+// State shared by one Promise and one Future. Producer and consumer meet
+// through a single atomic word: whoever sets the second of {value,
+// continuation} runs the continuation. Blocking waiters fall back to a
+// condition variable only after a short spin.
+template <typename T>
+class SharedState {
+public:
+    void SetResult(Result<T> r) {
+        result_.emplace(std::move(r));
+        const std::uint32_t prev = flags_.fetch_or(kHasValue, std::memory_order_seq_cst);
+        if ((prev & kHasContinuation) != 0) {
+            continuation_->Run(std::move(*result_));
+            result_.reset();
+        }
+        if (waiters_.load(std::memory_order_seq_cst) != 0) {
+            std::lock_guard<std::mutex> lk(waitMutex_);
+            waitCv_.notify_all();
+        }
+    }
+
+    // The continuation may own move-only state (e.g. a Promise), so it is
+    // type-erased here instead of going through std::function.
+    template <typename F>
+    void SetContinuation(F fn) {
+        continuation_ = std::make_unique<ContinuationImpl<F>>(std::move(fn));
+        const std::uint32_t prev = flags_.fetch_or(kHasContinuation, std::memory_order_acq_rel);
+        if ((prev & kHasValue) != 0) {
+            continuation_->Run(std::move(*result_));
+            result_.reset();
+        }
+    }
+
+    bool IsReady() const noexcept { return (flags_.load(std::memory_order_acquire) & kHasValue) != 0; }
+
+    void Wait() {
+        for (int i = 0; i < kSpinCount; ++i) {
+            if (IsReady()) return;
+        }
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lk(waitMutex_);
+            waitCv_.wait(lk, [this] { return IsReady(); });
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
 
-    bool IsOk() const noexcept { return ok_; }
-    const std::error_code &Error() const noexcept { return error_; }
+    template <typename Rep, typename Period>
+    bool WaitFor(const std::chrono::duration<Rep, Period> &timeout) {
+        if (IsReady()) return true;
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        bool ready;
+        {
+            std::unique_lock<std::mutex> lk(waitMutex_);
+            ready = waitCv_.wait_for(lk, timeout, [this] { return IsReady(); });
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        return ready;
+    }
+
+    Result<T> TakeResult() { return std::move(*result_); }
 
 private:
-    bool ok_{false};
-    std::error_code error_;
+    struct Continuation {
+        virtual ~Continuation() = default;
+        virtual void Run(Result<T> r) = 0;
+    };
+
+    template <typename F>
+    struct ContinuationImpl final : Continuation {
+        explicit ContinuationImpl(F f) : fn(std::move(f)) {}
+        void Run(Result<T> r) override { fn(std::move(r)); }
+        F fn;
+    };
+
+    static constexpr std::uint32_t kHasValue = 0x1;
+    static constexpr std::uint32_t kHasContinuation = 0x2;
+    static constexpr int kSpinCount = 256;
+
+    std::atomic<std::uint32_t> flags_{0};
+    std::atomic<std::uint32_t> waiters_{0};
+    std::optional<Result<T>> result_;
+    std::unique_ptr<Continuation> continuation_;
+    std::mutex waitMutex_;
+    std::condition_variable waitCv_;
 };
 
-// Minimal Future<T> stub.
+// Maps the return type of a then() callback to the value type of the
+// resulting future: Result<U> and Future<U> are unwrapped, void stays void.
+template <typename R> struct FutureValue { using type = R; };
+template <typename U> struct FutureValue<Result<U>> { using type = U; };
+template <typename U> struct FutureValue<Future<U>> { using type = U; };
+
+} // namespace detail
+
+// Future<T> either owns a ready Result<T> inline (no allocation; the common
+// case for cached status) or shares state with a Promise<T>.
 template <typename T>
 class Future {
 public:
+    using ValueType = T;
+
     Future() noexcept = default;
-    // Add more functionality as needed by real implementation.
+    explicit Future(Result<T> ready) : ready_(std::move(ready)) {}
+
+    Future(Future &&) noexcept = default;
+    Future &operator=(Future &&) noexcept = default;
+    Future(const Future &) = delete;
+    Future &operator=(const Future &) = delete;
+
+    bool valid() const noexcept { return ready_.has_value() || static_cast<bool>(state_); }
+    bool is_ready() const noexcept { return ready_.has_value() || (state_ && state_->IsReady()); }
+
+    void wait() const {
+        if (!ready_ && state_) state_->Wait();
+    }
+
+    template <typename Rep, typename Period>
+    FutureStatus wait_for(const std::chrono::duration<Rep, Period> &timeout) const {
+        if (ready_ || !state_ || state_->WaitFor(timeout)) return FutureStatus::kReady;
+        return FutureStatus::kTimeout;
+    }
+
+    // Blocks until the result is available and moves it out; the future
+    // becomes invalid afterwards.
+    Result<T> GetResult() {
+        if (ready_) {
+            Result<T> r = std::move(*ready_);
+            ready_.reset();
+            return r;
+        }
+        if (!state_) return Result<T>{ std::make_error_code(std::future_errc::no_state) };
+        state_->Wait();
+        Result<T> r = state_->TakeResult();
+        state_.reset();
+        return r;
+    }
+
+    // Attach a continuation called with a ready Future<T>. Runs immediately
+    // if the value is already there, otherwise on the thread that fulfils
+    // the promise. Returns a future for the callback's result.
+    template <typename F>
+    auto then(F &&func) -> Future<typename detail::FutureValue<std::invoke_result_t<F, Future<T>>>::type> {
+        using R = std::invoke_result_t<F, Future<T>>;
+        using U = typename detail::FutureValue<R>::type;
+
+        if (ready_ || !state_) {
+            Future<T> self(GetResult());
+            return Wrap<U>(std::forward<F>(func), std::move(self));
+        }
+
+        Promise<U> promise;
+        Future<U> out = promise.get_future();
+        std::shared_ptr<detail::SharedState<T>> state = std::move(state_);
+        state->SetContinuation(
+            [p = std::move(promise), fn = std::decay_t<F>(std::forward<F>(func))](Result<T> r) mutable {
+                Fulfil(p, fn, Future<T>(std::move(r)));
+            });
+        return out;
+    }
+
+private:
+    template <typename U> friend class Promise;
+    template <typename U> friend class Future;
+
+    explicit Future(std::shared_ptr<detail::SharedState<T>> state) noexcept : state_(std::move(state)) {}
+
+    template <typename U, typename F>
+    static Future<U> Wrap(F &&func, Future<T> arg) {
+        using R = std::invoke_result_t<F, Future<T>>;
+        if constexpr (std::is_void<R>::value) {
+            func(std::move(arg));
+            return Future<U>(Result<U>{});
+        } else if constexpr (std::is_same<R, Result<U>>::value) {
+            return Future<U>(func(std::move(arg)));
+        } else if constexpr (std::is_same<R, Future<U>>::value) {
+            return func(std::move(arg));
+        } else {
+            return Future<U>(Result<U>{ func(std::move(arg)) });
+        }
+    }
+
+    template <typename U, typename F>
+    static void Fulfil(Promise<U> &p, F &fn, Future<T> arg) {
+        using R = std::invoke_result_t<F &, Future<T>>;
+        if constexpr (std::is_void<R>::value) {
+            fn(std::move(arg));
+            p.SetResult(Result<U>{});
+        } else if constexpr (std::is_same<R, Result<U>>::value) {
+            p.SetResult(fn(std::move(arg)));
+        } else if constexpr (std::is_same<R, Future<U>>::value) {
+            fn(std::move(arg)).then([p = std::move(p)](Future<U> f) mutable { p.SetResult(f.GetResult()); });
+        } else {
+            p.SetResult(Result<U>{ fn(std::move(arg)) });
+        }
+    }
+
+    std::optional<Result<T>> ready_;
+    std::shared_ptr<detail::SharedState<T>> state_;
+};
+
+// Promise<T> allocates shared state only if get_future() is called before
+// the value is set; otherwise the future is handed out already ready.
+template <typename T>
+class Promise {
+public:
+    Promise() = default;
+    Promise(Promise &&) noexcept = default;
+    Promise &operator=(Promise &&) noexcept = default;
+    Promise(const Promise &) = delete;
+    Promise &operator=(const Promise &) = delete;
+
+    ~Promise() {
+        if (state_ && !satisfied_) {
+            state_->SetResult(Result<T>{ std::make_error_code(std::future_errc::broken_promise) });
+        }
+    }
+
+    // Only one future per promise; later calls get one holding
+    // future_already_retrieved.
+    Future<T> get_future() {
+        if (retrieved_) return Future<T>(Result<T>{ std::make_error_code(std::future_errc::future_already_retrieved) });
+        retrieved_ = true;
+        if (pending_) {
+            Result<T> r = std::move(*pending_);
+            pending_.reset();
+            return Future<T>(std::move(r));
+        }
+        state_ = std::make_shared<detail::SharedState<T>>();
+        return Future<T>(state_);
+    }
+
+    template <typename U = T, typename = std::enable_if_t<!std::is_void<U>::value>>
+    void set_value(U value) { SetResult(Result<T>{ std::move(value) }); }
+
+    template <typename U = T, typename = std::enable_if_t<std::is_void<U>::value>>
+    void set_value() { SetResult(Result<T>{}); }
+
+    void SetError(std::error_code ec) { SetResult(Result<T>{ ec }); }
+
+    void SetResult(Result<T> r) {
+        if (satisfied_) return;
+        satisfied_ = true;
+        if (state_) state_->SetResult(std::move(r));
+        else pending_.emplace(std::move(r));
+    }
+
+private:
+    std::optional<Result<T>> pending_;
+    std::shared_ptr<detail::SharedState<T>> state_;
+    bool satisfied_{false};
+    bool retrieved_{false};
 };
 
 } // namespace core
@@ -3,14 +3,9 @@
 
 #include <functional>
 #include <cstdint> // <-- add this to make std::uint8_t available
+#include "ara/core/core_fwd.h"
 
 namespace ara {
-namespace core {
-class InstanceSpecifier;
-template <typename T> class Future;
-template <typename T> class Result;
-} // namespace core
-
 namespace diag {
 
 enum class ConditionType : std::uint8_t {
@@ -8,14 +8,9 @@
 #include <cstdint>
 #include <functional>
 #include <system_error>
+#include "ara/core/core_fwd.h"
 
 namespace ara {
-namespace core {
-class InstanceSpecifier;
-template <typename T> class Future;
-template <typename T> class Result;
-} // namespace core
-
 namespace diag {
 
 class DTCInformation {
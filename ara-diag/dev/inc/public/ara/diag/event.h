@@ -2,15 +2,14 @@
 #define ARA_DIAG_EVENT_H_
 
 #include "event_types.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include "ara/core/core_fwd.h"
 
 namespace ara {
-namespace core {
-class InstanceSpecifier; // forward declaration; real definition is expected in the project
-template <typename T> class Future;    // forward declare core types used by the API
-template <typename T> class Result;
-} // namespace core
-
 namespace diag {
 
 class Event {
@@ -23,7 +22,7 @@ public:
     Event &operator=(Event &&) = delete;
     Event &operator=(Event &) = delete;
 
-    ~Event() noexcept = default;
+    ~Event() noexcept;
 
     // Returns the current diagnostic event status.
     ara::core::Future<EventStatusByte> GetEventStatus();
@@ -31,8 +30,19 @@ public:
     // Register a notifier function which is called if a diagnostic event is changed.
     ara::core::Result<void> SetEventStatusChangedNotifier(std::function<void(EventStatusByte)> notifier);
 
+    // As above, but coalesced: at most one call per minInterval, carrying
+    // the latest status. An empty notifier removes the subscription.
+    ara::core::Result<void> SetEventStatusChangedNotifier(std::function<void(EventStatusByte)> notifier,
+                                                          std::chrono::milliseconds minInterval);
+
 private:
+    void Unsubscribe();
+
     const ara::core::InstanceSpecifier *specifierPtr_;
+    std::uint32_t subscription_{0};
+    // Last status pushed by diagnostic-manager; shared with the dispatcher
+    // callback. Holds a value above 0xFF until the first status is known.
+    std::shared_ptr<std::atomic<std::uint16_t>> cachedStatus_;
 };
 
 } // namespace diag
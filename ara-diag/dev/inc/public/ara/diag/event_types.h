@@ -4,7 +4,6 @@
 #include <cstdint>
 #include <type_traits>
 #include <initializer_list>
-#include <iostream>
 #include <thread>
 #include <chrono>
 
@@ -23,17 +22,14 @@ struct EventStatusByte {
     template <typename... Args>
     constexpr EventStatusByte(Args... bits) noexcept
         : value{0} {
-        std::cout << __func__ << ":" << __LINE__ << std::endl;
         (void)std::initializer_list<int>{(value |= static_cast<std::uint8_t>(bits), 0)...};
     }
 
     constexpr bool IsFailedAndTested() const noexcept {
-        std::cout << __func__ << ":" << __LINE__ << std::endl;
         return (value & static_cast<std::uint8_t>(EventStatusBit::FailedAndTested)) != 0;
     }
 
     constexpr bool IsPassedAndTested() const noexcept {
-        std::cout << __func__ << ":" << __LINE__ << std::endl;
         return (value & static_cast<std::uint8_t>(EventStatusBit::PassedAndTested)) != 0;
     }
 
@@ -0,0 +1,30 @@
+/*
+ * Polling of monitor-internal debouncing (getFaultDetectionCounter).
+ * Monitors constructed with a getFaultDetectionCounter callback are sampled
+ * by a shared scheduler once offered instead of each keeping its own timer.
+ */
+#ifndef ARA_DIAG_FDC_POLLING_H_
+#define ARA_DIAG_FDC_POLLING_H_
+
+#include <chrono>
+#include <cstdint>
+#include "ara/core/core_fwd.h"
+
+namespace ara {
+namespace diag {
+
+struct FdcPollingConfig {
+    std::chrono::microseconds period{std::chrono::milliseconds(10)}; // sampling period
+    std::uint32_t workerCount{1};     // threads sampling in parallel
+    std::uint32_t batchSize{64};      // monitors sampled and reported per batch
+    std::int8_t fdcThreshold{127};    // FDC at which kFdcThresholdReached is reported
+};
+
+// Must be called before the first monitor-internal Monitor is offered.
+// Returns device_or_resource_busy once the scheduler is running.
+ara::core::Result<void> ConfigureFdcPolling(const FdcPollingConfig &cfg);
+
+} // namespace diag
+} // namespace ara
+
+#endif // ARA_DIAG_FDC_POLLING_H_
@@ -0,0 +1,153 @@
+/*
+ * Shared-memory transport between ara-diag clients and diagnostic-manager.
+ *
+ * Each client process owns one ClientSegment mapped into both processes. It
+ * holds kReportLanes ReportRings: a reporting thread claims a lane of its
+ * own and is its single producer, threads that find none free share the last
+ * lane under a lock; the daemon is the single consumer of all of them. The
+ * StatusRing carries event status changes the other way. A Unix domain
+ * socket is used only for the handshake and subscription requests; reports
+ * and status changes travel through the rings.
+ *
+ * Reports of one thread keep their order. The daemon drains the lanes one
+ * after another, so reports of different threads are not ordered against
+ * each other.
+ */
+#ifndef ARA_DIAG_IPC_REPORT_RING_H_
+#define ARA_DIAG_IPC_REPORT_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "ara/diag/monitor_types.h"
+
+namespace ara {
+namespace diag {
+namespace ipc {
+
+constexpr std::uint32_t kRingMagic = 0x44494147;   // "DIAG"
+constexpr std::uint32_t kProtocolVersion = 3;
+constexpr std::uint32_t kRingCapacity = 1024;      // records per lane, power of two
+constexpr std::uint32_t kReportLanes = 8;          // report rings per client; the last one is shared
+constexpr std::uint32_t kStatusRingCapacity = 1024;
+constexpr std::size_t kMaxSpecifierLength = 128;   // including terminating '\0'
+constexpr std::size_t kCacheLine = 64;
+
+// Socket path used for the handshake; can be overridden with DM_IPC_SOCKET.
+constexpr const char *kDefaultSocketPath = "/tmp/diagnostic-manager.sock";
+constexpr const char *kSocketPathEnv = "DM_IPC_SOCKET";
+
+// One monitor report. Fixed size so the ring never needs framing.
+struct ReportRecord {
+    std::uint32_t handle{0};        // monitor handle assigned on Offer
+    std::uint32_t action{0};        // ara::diag::MonitorAction
+    std::uint64_t timestampNs{0};   // CLOCK_MONOTONIC at report time
+};
+static_assert(sizeof(ReportRecord) == 16, "ReportRecord must stay 16 bytes");
+
+// SPSC ring living in shared memory. Indices are free-running and wrap
+// naturally; head/tail/wake flag sit on separate cache lines.
+template <typename Record, std::uint32_t Capacity>
+struct SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "ring capacity must be a power of two");
+
+    std::uint32_t magic{kRingMagic};
+    std::uint32_t version{kProtocolVersion};
+    std::uint32_t capacity{Capacity};
+    std::uint32_t reserved{0};
+
+    alignas(kCacheLine) std::atomic<std::uint32_t> head{0};          // consumer position
+    alignas(kCacheLine) std::atomic<std::uint32_t> tail{0};          // producer position
+    std::atomic<std::uint64_t> dropped{0};                           // records lost on full ring
+    alignas(kCacheLine) std::atomic<std::uint32_t> consumerWaiting{0}; // consumer asks for eventfd wakeups
+
+    alignas(kCacheLine) Record records[Capacity];
+
+    // Producer side. Returns false if the ring is full.
+    bool TryPush(const Record &record) noexcept {
+        const std::uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) >= Capacity) return false;
+        records[t & (Capacity - 1)] = record;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side: after a push, true if the consumer must be woken up.
+    bool NeedsWakeup() const noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return consumerWaiting.load(std::memory_order_relaxed) != 0;
+    }
+
+    // Consumer side. Copies up to maxCount records and releases their slots.
+    std::size_t PopBatch(Record *out, std::size_t maxCount) noexcept {
+        const std::uint32_t h = head.load(std::memory_order_relaxed);
+        const std::uint32_t available = tail.load(std::memory_order_acquire) - h;
+        const std::size_t n = available < maxCount ? available : maxCount;
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = records[(h + i) & (Capacity - 1)];
+        }
+        head.store(h + static_cast<std::uint32_t>(n), std::memory_order_release);
+        return n;
+    }
+
+    bool Empty() const noexcept {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+    }
+};
+
+using ReportRing = SpscRing<ReportRecord, kRingCapacity>;
+
+// Event status change pushed by the daemon to a subscribed client.
+struct StatusRecord {
+    std::uint32_t handle{0};        // subscription handle assigned on Subscribe
+    std::uint32_t status{0};        // ara::diag::EventStatusByte value
+};
+static_assert(sizeof(StatusRecord) == 8, "StatusRecord must stay 8 bytes");
+
+using StatusRing = SpscRing<StatusRecord, kStatusRingCapacity>;
+
+// Layout of the memfd handed out on Hello.
+struct ClientSegment {
+    ReportRing reports[kReportLanes];   // client -> daemon
+    StatusRing status;                  // daemon -> client
+};
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "ring indices must be lock-free across processes");
+
+// Handshake messages exchanged over the SOCK_SEQPACKET socket.
+enum class MessageType : std::uint32_t {
+    kHello = 1,      // client -> daemon; reply carries segment memfd + report/status eventfds
+    kHelloAck,
+    kOffer,          // client -> daemon; register a monitor
+    kOfferAck,       // reply carries the monitor handle
+    kStopOffer,      // client -> daemon; no reply
+    kSubscribe,      // client -> daemon; event status changes of one event
+    kSubscribeAck,   // reply carries the subscription handle and current status
+    kUnsubscribe,    // client -> daemon; no reply
+    kGetStatus,      // client -> daemon; one-shot status query
+    kGetStatusAck
+};
+
+enum class DebounceKind : std::uint8_t {
+    kMonitorInternal = 0,
+    kCounterBased,
+    kTimeBased
+};
+
+struct HandshakeMessage {
+    MessageType type{MessageType::kHello};
+    std::uint32_t version{kProtocolVersion};
+    std::int32_t status{0};         // 0 on success, errno value otherwise
+    std::uint32_t handle{0};        // monitor or subscription handle
+    std::uint32_t intervalMs{0};    // kSubscribe: minimum time between two updates
+    std::uint8_t eventStatus{0};    // kSubscribeAck/kGetStatusAck: current status byte
+    DebounceKind debounceKind{DebounceKind::kMonitorInternal};
+    CounterBased counter{};
+    TimeBased time{};
+    char specifier[kMaxSpecifierLength]{};
+};
+
+} // namespace ipc
+} // namespace diag
+} // namespace ara
+
+#endif // ARA_DIAG_IPC_REPORT_RING_H_
@@ -4,13 +4,9 @@
 #include "monitor_types.h"
 #include <functional>
 #include <cstdint>
+#include "ara/core/core_fwd.h"
 
 namespace ara {
-namespace core {
-class InstanceSpecifier; // forward declaration
-template <typename T> class Result;
-} // namespace core
-
 namespace diag {
 
 class Monitor final {
@@ -34,7 +30,7 @@ public:
     Monitor &operator=(Monitor &&) = delete;
     Monitor &operator=(Monitor &) = delete;
 
-    ~Monitor() noexcept = default;
+    ~Monitor() noexcept;
 
     // Report monitor action
     void ReportMonitorAction(MonitorAction action);
@@ -49,6 +45,8 @@ private:
     std::function<std::int8_t()> getFDC_;
     CounterBased counterDefaults_{};
     TimeBased timeDefaults_{};
+    std::uint8_t debounceKind_{0};   // ipc::DebounceKind of the constructor used
+    std::uint32_t handle_{0};        // assigned by diagnostic-manager on Offer()
     bool offered_{false};
 };
 
@@ -3,13 +3,9 @@
 
 #include <functional>
 #include <mutex>
+#include "ara/core/core_fwd.h"
 
 namespace ara {
-namespace core {
-class InstanceSpecifier;
-template <typename T> class Result;
-} // namespace core
-
 namespace diag {
 
 class OperationCycle {
@@ -12,7 +12,8 @@ Condition::Condition(const ara::core::InstanceSpecifier &specifier)
 // Standalone: no diagnostic-manager backend available. Return not-supported
 // for operations that would require backend interaction.
 ara::core::Future<ConditionType> Condition::GetCondition() {
-    return ara::core::Future<ConditionType>{};
+    return ara::core::Future<ConditionType>{
+        ara::core::Result<ConditionType>{ std::make_error_code(std::errc::operation_not_supported) } };
 }
 
 ara::core::Result<void> Condition::SetCondition(ConditionType /*condition*/) {
@@ -14,6 +14,11 @@ namespace diag {
 DTCInformation::DTCInformation(const ara::core::InstanceSpecifier &specifier)
     : specifierPtr_(&specifier) {}
 
+ara::core::Future<DTCInformation::UdsDtcStatusByteType> DTCInformation::GetCurrentStatus(std::uint32_t /*dtc*/) {
+    return ara::core::Future<UdsDtcStatusByteType>{
+        ara::core::Result<UdsDtcStatusByteType>{ std::make_error_code(std::errc::operation_not_supported) } };
+}
+
 ara::core::Result<bool> DTCInformation::GetEventMemoryOverflow() {
     return ara::core::Result<bool>{ std::make_error_code(std::errc::operation_not_supported) };
 }
@@ -1,28 +1,89 @@
 #include "ara/diag/event.h"
 #include "ara/core/result_future.h"
 #include "ara/core/instance_specifier.h"
+#include "ipc_client.h"
 #include <system_error>
 
 
 namespace ara {
 namespace diag {
 
-// Minimal standalone stubs for the API so this library can build without a full diagnostic-manager backend.
-// Integrations can replace these with richer implementations that use the real ara::core::Future/Result APIs.
+namespace {
+
+constexpr std::uint16_t kNoStatus = 0x100;
+
+EventStatusByte to_status_byte(std::uint16_t value) noexcept {
+    EventStatusByte status;
+    status.value = static_cast<std::uint8_t>(value);
+    return status;
+}
+
+} // namespace
 
 Event::Event(const ara::core::InstanceSpecifier &specifier)
-    : specifierPtr_(&specifier) {
-    // minimal standalone implementation: store pointer to specifier
-    // Diagnostic-manager integration can enrich behavior in the real backend.
+    : specifierPtr_(&specifier) {}
+
+Event::~Event() noexcept {
+    Unsubscribe();
 }
 
 ara::core::Future<EventStatusByte> Event::GetEventStatus() {
-    return ara::core::Future<EventStatusByte>{};
+    // Ready future: no shared state is allocated for a synchronous answer.
+    // While subscribed the status pushed by diagnostic-manager is returned.
+    if (cachedStatus_) {
+        return ara::core::Future<EventStatusByte>{
+            ara::core::Result<EventStatusByte>{ to_status_byte(cachedStatus_->load(std::memory_order_acquire)) } };
+    }
+    std::uint8_t value = 0;
+    // Returns operation_not_supported when no diagnostic-manager is reachable.
+    std::error_code ec = ipc::ClientChannel::Instance().QueryStatus(specifierPtr_->GetName(), value);
+    if (ec) return ara::core::Future<EventStatusByte>{ ara::core::Result<EventStatusByte>{ ec } };
+    return ara::core::Future<EventStatusByte>{ ara::core::Result<EventStatusByte>{ to_status_byte(value) } };
+}
+
+ara::core::Result<void> Event::SetEventStatusChangedNotifier(std::function<void(EventStatusByte)> notifier) {
+    return SetEventStatusChangedNotifier(std::move(notifier), std::chrono::milliseconds{0});
+}
+
+ara::core::Result<void> Event::SetEventStatusChangedNotifier(std::function<void(EventStatusByte)> notifier,
+                                                             std::chrono::milliseconds minInterval) {
+    if (!notifier) {
+        Unsubscribe();
+        return ara::core::Result<void>{};
+    }
+    // A rejected request leaves the installed notifier in place.
+    if (minInterval.count() < 0) {
+        return ara::core::Result<void>{ std::make_error_code(std::errc::invalid_argument) };
+    }
+
+    // Notified only when diagnostic-manager derives a different status byte.
+    auto cache = std::make_shared<std::atomic<std::uint16_t>>(kNoStatus);
+    auto callback = [cache, notifier = std::move(notifier)](std::uint8_t value) {
+        cache->store(value, std::memory_order_release);
+        notifier(to_status_byte(value));
+    };
+    std::uint8_t current = 0;
+    std::uint32_t subscription = 0;
+    std::error_code ec = ipc::ClientChannel::Instance().Subscribe(
+        specifierPtr_->GetName(), static_cast<std::uint32_t>(minInterval.count()), std::move(callback),
+        subscription, current);
+    if (ec) return ara::core::Result<void>{ ec };
+    // A change pushed while the request was in flight is newer than the ack.
+    std::uint16_t expected = kNoStatus;
+    cache->compare_exchange_strong(expected, current, std::memory_order_acq_rel);
+    // Subscribed first, so no change falls between the old and new notifier.
+    Unsubscribe();
+    subscription_ = subscription;
+    cachedStatus_ = std::move(cache);
+    return ara::core::Result<void>{};
 }
 
-ara::core::Result<void> Event::SetEventStatusChangedNotifier(std::function<void(EventStatusByte)> /*notifier*/) {
-    return ara::core::Result<void>{ std::make_error_code(std::errc::operation_not_supported) };
+void Event::Unsubscribe() {
+    if (!cachedStatus_) return;
+    ipc::ClientChannel::Instance().Unsubscribe(subscription_);
+    cachedStatus_.reset();
+    subscription_ = 0;
 }
 
 } // namespace diag
-} // namespace ara
\ No newline at end of file
+} // namespace ara
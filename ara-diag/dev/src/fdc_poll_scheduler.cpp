@@ -0,0 +1,156 @@
+#include "fdc_poll_scheduler.h"
+
+#include "ara/core/result_future.h"
+#include "ipc_client.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+namespace ara {
+namespace diag {
+
+ara::core::Result<void> ConfigureFdcPolling(const FdcPollingConfig &cfg) {
+    std::error_code ec = ipc::FdcPollScheduler::Instance().Configure(cfg);
+    if (ec) return ara::core::Result<void>{ ec };
+    return ara::core::Result<void>{};
+}
+
+namespace ipc {
+
+namespace {
+
+constexpr std::int8_t kFdcFailed = 127;
+constexpr std::int8_t kFdcPassed = -128;
+constexpr std::uint8_t kNotQualified = 0;
+constexpr std::uint8_t kQualifiedPassed = 1;
+constexpr std::uint8_t kQualifiedFailed = 2;
+
+std::uint64_t monotonic_ns() noexcept {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+} // namespace
+
+FdcPollScheduler &FdcPollScheduler::Instance() {
+    static FdcPollScheduler scheduler;
+    return scheduler;
+}
+
+FdcPollScheduler::~FdcPollScheduler() {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        stop_ = true;
+    }
+    stopCv_.notify_all();
+    for (auto &w : workers_) {
+        if (w->thread.joinable()) w->thread.join();
+    }
+}
+
+std::error_code FdcPollScheduler::Configure(const FdcPollingConfig &cfg) {
+    if (cfg.workerCount == 0 || cfg.batchSize == 0 || cfg.period.count() <= 0) {
+        return std::make_error_code(std::errc::invalid_argument);
+    }
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (!workers_.empty()) return std::make_error_code(std::errc::device_or_resource_busy);
+    cfg_ = cfg;
+    return std::error_code{};
+}
+
+void FdcPollScheduler::StartLocked() {
+    for (std::uint32_t i = 0; i < cfg_.workerCount; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (auto &w : workers_) {
+        Worker *worker = w.get();
+        worker->thread = std::thread([this, worker] { Run(*worker); });
+    }
+}
+
+void FdcPollScheduler::Add(std::uint32_t handle, const std::function<std::int8_t()> *getFdc) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (workers_.empty()) StartLocked();
+
+    // Keep groups balanced: new monitors go to the least loaded worker.
+    Worker *target = workers_.front().get();
+    for (auto &w : workers_) {
+        std::lock_guard<std::mutex> wl(w->mutex);
+        if (w->entries.size() < target->entries.size()) target = w.get();
+    }
+    std::lock_guard<std::mutex> wl(target->mutex);
+    target->entries.push_back(Entry{handle, getFdc, 0, kNotQualified});
+}
+
+void FdcPollScheduler::Remove(std::uint32_t handle) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    for (auto &w : workers_) {
+        // Taking the worker mutex also waits for an in-flight sample of this monitor.
+        std::lock_guard<std::mutex> wl(w->mutex);
+        auto it = std::find_if(w->entries.begin(), w->entries.end(),
+                               [handle](const Entry &e) { return e.handle == handle; });
+        if (it != w->entries.end()) {
+            w->entries.erase(it);
+            return;
+        }
+    }
+}
+
+void FdcPollScheduler::SampleBatch(Worker &worker, std::size_t first, std::size_t last) {
+    const std::int8_t threshold = cfg_.fdcThreshold;
+    for (std::size_t i = first; i < last; ++i) {
+        Entry &e = worker.entries[i];
+        const std::int8_t fdc = (*e.getFdc)();
+
+        std::uint32_t actions[2];
+        int count = 0;
+        if (fdc >= threshold && e.lastFdc < threshold) {
+            actions[count++] = static_cast<std::uint32_t>(MonitorAction::kFdcThresholdReached);
+        }
+        if (fdc == kFdcFailed && e.lastQualified != kQualifiedFailed) {
+            actions[count++] = static_cast<std::uint32_t>(MonitorAction::kFailed);
+            e.lastQualified = kQualifiedFailed;
+        } else if (fdc == kFdcPassed && e.lastQualified != kQualifiedPassed) {
+            actions[count++] = static_cast<std::uint32_t>(MonitorAction::kPassed);
+            e.lastQualified = kQualifiedPassed;
+        }
+        e.lastFdc = fdc;
+
+        if (count == 0) continue;
+        const std::uint64_t now = monotonic_ns();
+        for (int a = 0; a < count; ++a) worker.pending.push_back(ReportRecord{e.handle, actions[a], now});
+    }
+
+    if (!worker.pending.empty()) {
+        ClientChannel::Instance().ReportBatch(worker.pending.data(), worker.pending.size());
+        worker.pending.clear();
+    }
+}
+
+void FdcPollScheduler::Run(Worker &worker) {
+    const auto period = cfg_.period;
+    const std::size_t batch = cfg_.batchSize;
+    auto next = std::chrono::steady_clock::now() + period;
+
+    std::unique_lock<std::mutex> lk(mutex_);
+    while (!stopCv_.wait_until(lk, next, [this] { return stop_; })) {
+        lk.unlock();
+        {
+            std::lock_guard<std::mutex> wl(worker.mutex);
+            const std::size_t n = worker.entries.size();
+            for (std::size_t first = 0; first < n; first += batch) {
+                SampleBatch(worker, first, std::min(n, first + batch));
+            }
+        }
+        // Skip missed periods instead of sampling back-to-back after a stall.
+        next += period;
+        const auto now = std::chrono::steady_clock::now();
+        if (next < now) next = now + period;
+        lk.lock();
+    }
+}
+
+} // namespace ipc
+} // namespace diag
+} // namespace ara
@@ -0,0 +1,363 @@
+#include "ipc_client.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace ara {
+namespace diag {
+namespace ipc {
+
+namespace {
+
+constexpr int kPushRetries = 64;
+
+std::uint64_t monotonic_ns() noexcept {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+const char *socket_path() {
+    const char *env = std::getenv(kSocketPathEnv);
+    return (env && *env) ? env : kDefaultSocketPath;
+}
+
+constexpr int kHelloFds = 3;   // segment memfd, report eventfd, status eventfd
+constexpr std::uint32_t kSharedLane = kReportLanes - 1;
+
+// Lane claimed by the calling thread on its first report, given back when
+// the thread exits. A thread that finds every lane taken stays on the
+// shared one.
+struct LaneClaim {
+    std::atomic<bool> *taken{nullptr};
+    std::uint32_t lane{kSharedLane};
+    bool chosen{false};
+    ~LaneClaim() {
+        if (taken != nullptr) taken->store(false, std::memory_order_release);
+    }
+};
+
+thread_local LaneClaim t_lane;
+
+// Receive one message plus up to kHelloFds descriptors passed with SCM_RIGHTS.
+ssize_t recv_with_fds(int sock, HandshakeMessage &msg, int *fds, int &fdCount) {
+    iovec iov{&msg, sizeof(msg)};
+    alignas(cmsghdr) char control[CMSG_SPACE(kHelloFds * sizeof(int))];
+    msghdr mh{};
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+    mh.msg_control = control;
+    mh.msg_controllen = sizeof(control);
+
+    ssize_t n;
+    do {
+        n = recvmsg(sock, &mh, MSG_CMSG_CLOEXEC);
+    } while (n < 0 && errno == EINTR);
+
+    fdCount = 0;
+    for (cmsghdr *c = CMSG_FIRSTHDR(&mh); n > 0 && c != nullptr; c = CMSG_NXTHDR(&mh, c)) {
+        if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS) continue;
+        fdCount = static_cast<int>((c->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+        if (fdCount > kHelloFds) fdCount = kHelloFds;
+        std::memcpy(fds, CMSG_DATA(c), static_cast<std::size_t>(fdCount) * sizeof(int));
+    }
+    return n;
+}
+
+} // namespace
+
+ClientChannel &ClientChannel::Instance() {
+    static ClientChannel channel;
+    return channel;
+}
+
+ClientChannel::~ClientChannel() {
+    if (dispatcher_.joinable()) {
+        const std::uint64_t one = 1;
+        (void)!write(stopFd_, &one, sizeof(one));
+        dispatcher_.join();
+    }
+    if (stopFd_ >= 0) close(stopFd_);
+    if (segment_ != nullptr) munmap(segment_, sizeof(ClientSegment));
+    if (statusEventFd_ >= 0) close(statusEventFd_);
+    if (eventFd_ >= 0) close(eventFd_);
+    if (socketFd_ >= 0) close(socketFd_);
+}
+
+std::error_code ClientChannel::ConnectLocked() {
+    if (lanes_.load(std::memory_order_relaxed) != nullptr) return std::error_code{};
+
+    int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (sock < 0) return std::error_code(errno, std::generic_category());
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path(), sizeof(addr.sun_path) - 1);
+    if (connect(sock, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        close(sock);
+        // No daemon running: behave like the standalone library.
+        return std::make_error_code(std::errc::operation_not_supported);
+    }
+
+    HandshakeMessage hello;
+    hello.type = MessageType::kHello;
+    if (send(sock, &hello, sizeof(hello), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(hello))) {
+        int err = errno;
+        close(sock);
+        return std::error_code(err, std::generic_category());
+    }
+
+    HandshakeMessage ack;
+    int fds[kHelloFds] = {-1, -1, -1};
+    int fdCount = 0;
+    ssize_t n = recv_with_fds(sock, ack, fds, fdCount);
+    if (n != static_cast<ssize_t>(sizeof(ack)) || ack.type != MessageType::kHelloAck || ack.status != 0 ||
+        fdCount != kHelloFds) {
+        for (int i = 0; i < fdCount; ++i) close(fds[i]);
+        close(sock);
+        if (n == static_cast<ssize_t>(sizeof(ack)) && ack.status != 0) {
+            return std::error_code(ack.status, std::generic_category());
+        }
+        return std::make_error_code(std::errc::protocol_error);
+    }
+
+    void *mem = mmap(nullptr, sizeof(ClientSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+    close(fds[0]);
+    if (mem == MAP_FAILED) {
+        int err = errno;
+        close(fds[1]);
+        close(fds[2]);
+        close(sock);
+        return std::error_code(err, std::generic_category());
+    }
+
+    auto *segment = static_cast<ClientSegment *>(mem);
+    if (segment->reports[0].magic != kRingMagic || segment->reports[0].version != kProtocolVersion) {
+        munmap(mem, sizeof(ClientSegment));
+        close(fds[1]);
+        close(fds[2]);
+        close(sock);
+        return std::make_error_code(std::errc::protocol_error);
+    }
+
+    socketFd_ = sock;
+    eventFd_ = fds[1];
+    statusEventFd_ = fds[2];
+    segment_ = segment;
+    lanes_.store(segment->reports, std::memory_order_release);
+    return std::error_code{};
+}
+
+std::error_code ClientChannel::RequestLocked(HandshakeMessage &msg) {
+    if (send(socketFd_, &msg, sizeof(msg), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(msg))) {
+        return std::error_code(errno, std::generic_category());
+    }
+    ssize_t n;
+    do {
+        n = recv(socketFd_, &msg, sizeof(msg), 0);
+    } while (n < 0 && errno == EINTR);
+    if (n != static_cast<ssize_t>(sizeof(msg))) return std::make_error_code(std::errc::protocol_error);
+    if (msg.status != 0) return std::error_code(msg.status, std::generic_category());
+    return std::error_code{};
+}
+
+std::error_code ClientChannel::Offer(const std::string &specifier, DebounceKind kind,
+                                     const CounterBased &counter, const TimeBased &time,
+                                     std::uint32_t &handle) {
+    if (specifier.empty() || specifier.size() >= kMaxSpecifierLength) {
+        return std::make_error_code(std::errc::invalid_argument);
+    }
+
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (auto ec = ConnectLocked()) return ec;
+
+    HandshakeMessage msg;
+    msg.type = MessageType::kOffer;
+    msg.debounceKind = kind;
+    msg.counter = counter;
+    msg.time = time;
+    std::memcpy(msg.specifier, specifier.c_str(), specifier.size() + 1);
+    if (auto ec = RequestLocked(msg)) return ec;
+    if (msg.type != MessageType::kOfferAck) return std::make_error_code(std::errc::protocol_error);
+
+    handle = msg.handle;
+    return std::error_code{};
+}
+
+void ClientChannel::StopOffer(std::uint32_t handle) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (socketFd_ < 0) return;
+    HandshakeMessage msg;
+    msg.type = MessageType::kStopOffer;
+    msg.handle = handle;
+    (void)send(socketFd_, &msg, sizeof(msg), MSG_NOSIGNAL);
+}
+
+std::error_code ClientChannel::Subscribe(const std::string &specifier, std::uint32_t intervalMs,
+                                         StatusCallback callback, std::uint32_t &handle,
+                                         std::uint8_t &status) {
+    if (specifier.empty() || specifier.size() >= kMaxSpecifierLength || !callback) {
+        return std::make_error_code(std::errc::invalid_argument);
+    }
+
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (auto ec = ConnectLocked()) return ec;
+    if (!dispatcher_.joinable()) {
+        stopFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (stopFd_ < 0) return std::error_code(errno, std::generic_category());
+        dispatcher_ = std::thread(&ClientChannel::DispatchLoop, this);
+    }
+
+    HandshakeMessage msg;
+    msg.type = MessageType::kSubscribe;
+    msg.intervalMs = intervalMs;
+    std::memcpy(msg.specifier, specifier.c_str(), specifier.size() + 1);
+    // The callback must be in place before the daemon can push the first change.
+    std::unique_lock<std::mutex> cbLock(callbacksMutex_);
+    if (auto ec = RequestLocked(msg)) return ec;
+    if (msg.type != MessageType::kSubscribeAck) return std::make_error_code(std::errc::protocol_error);
+    callbacks_[msg.handle] = std::move(callback);
+    cbLock.unlock();
+
+    handle = msg.handle;
+    status = msg.eventStatus;
+    return std::error_code{};
+}
+
+void ClientChannel::Unsubscribe(std::uint32_t handle) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    {
+        std::lock_guard<std::mutex> cbLock(callbacksMutex_);
+        callbacks_.erase(handle);
+    }
+    if (socketFd_ < 0) return;
+    HandshakeMessage msg;
+    msg.type = MessageType::kUnsubscribe;
+    msg.handle = handle;
+    (void)send(socketFd_, &msg, sizeof(msg), MSG_NOSIGNAL);
+}
+
+std::error_code ClientChannel::QueryStatus(const std::string &specifier, std::uint8_t &status) {
+    if (specifier.empty() || specifier.size() >= kMaxSpecifierLength) {
+        return std::make_error_code(std::errc::invalid_argument);
+    }
+
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (auto ec = ConnectLocked()) return ec;
+
+    HandshakeMessage msg;
+    msg.type = MessageType::kGetStatus;
+    std::memcpy(msg.specifier, specifier.c_str(), specifier.size() + 1);
+    if (auto ec = RequestLocked(msg)) return ec;
+    if (msg.type != MessageType::kGetStatusAck) return std::make_error_code(std::errc::protocol_error);
+    status = msg.eventStatus;
+    return std::error_code{};
+}
+
+// Dispatcher thread: blocks on the status eventfd and runs the callbacks of
+// every record in the status ring, outside the callbacks lock.
+void ClientChannel::DispatchLoop() {
+    constexpr std::size_t kBatch = 64;
+    StatusRecord batch[kBatch];
+    pollfd fds[2] = {{statusEventFd_, POLLIN, 0}, {stopFd_, POLLIN, 0}};
+
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[1].revents != 0) return;
+        std::uint64_t value;
+        (void)!read(statusEventFd_, &value, sizeof(value));
+
+        std::size_t n;
+        while ((n = segment_->status.PopBatch(batch, kBatch)) != 0) {
+            for (std::size_t i = 0; i < n; ++i) {
+                StatusCallback callback;
+                {
+                    std::lock_guard<std::mutex> lk(callbacksMutex_);
+                    auto it = callbacks_.find(batch[i].handle);
+                    if (it == callbacks_.end()) continue;
+                    callback = it->second;
+                }
+                callback(static_cast<std::uint8_t>(batch[i].status));
+            }
+        }
+    }
+}
+
+void ClientChannel::Wakeup() noexcept {
+    const std::uint64_t one = 1;
+    (void)!write(eventFd_, &one, sizeof(one));
+}
+
+std::uint32_t ClientChannel::ThreadLane() noexcept {
+    if (!t_lane.chosen) {
+        t_lane.chosen = true;
+        for (std::uint32_t i = 0; i < kSharedLane; ++i) {
+            if (!laneTaken_[i].exchange(true, std::memory_order_acquire)) {
+                t_lane.taken = &laneTaken_[i];
+                t_lane.lane = i;
+                break;
+            }
+        }
+    }
+    return t_lane.lane;
+}
+
+bool ClientChannel::Push(ReportRing &ring, const ReportRecord &record) noexcept {
+    for (int attempt = 0; attempt < kPushRetries; ++attempt) {
+        if (ring.TryPush(record)) return true;
+        // ring full: make sure the daemon is draining, then back off briefly
+        Wakeup();
+        std::this_thread::yield();
+    }
+    ring.dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool ClientChannel::Report(std::uint32_t handle, MonitorAction action) noexcept {
+    ReportRing *lanes = lanes_.load(std::memory_order_acquire);
+    if (lanes == nullptr) return false;
+
+    const ReportRecord record{handle, static_cast<std::uint32_t>(action), monotonic_ns()};
+    const std::uint32_t lane = ThreadLane();
+    bool pushed;
+    if (lane != kSharedLane) {
+        pushed = Push(lanes[lane], record);
+    } else {
+        std::lock_guard<std::mutex> lk(sharedLaneMutex_);
+        pushed = Push(lanes[lane], record);
+    }
+    if (pushed && lanes[lane].NeedsWakeup()) Wakeup();
+    return pushed;
+}
+
+std::size_t ClientChannel::ReportBatch(const ReportRecord *records, std::size_t count) noexcept {
+    ReportRing *lanes = lanes_.load(std::memory_order_acquire);
+    if (lanes == nullptr || count == 0) return 0;
+
+    const std::uint32_t lane = ThreadLane();
+    std::size_t pushed = 0;
+    {
+        std::unique_lock<std::mutex> lk(sharedLaneMutex_, std::defer_lock);
+        if (lane == kSharedLane) lk.lock();
+        for (std::size_t i = 0; i < count; ++i) {
+            if (Push(lanes[lane], records[i])) ++pushed;
+        }
+    }
+    if (pushed != 0 && lanes[lane].NeedsWakeup()) Wakeup();
+    return pushed;
+}
+
+} // namespace ipc
+} // namespace diag
+} // namespace ara
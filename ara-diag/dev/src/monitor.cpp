@@ -1,6 +1,8 @@
 #include "ara/diag/monitor.h"
 #include "ara/core/result_future.h"
 #include "ara/core/instance_specifier.h"
+#include "fdc_poll_scheduler.h"
+#include "ipc_client.h"
 #include <system_error>
 
 namespace ara {
@@ -12,9 +14,8 @@ Monitor::Monitor(const ara::core::InstanceSpecifier &specifier,
     : specifierPtr_(&specifier),
       initMonitor_(std::move(initMonitor)),
       getFDC_(std::move(getFaultDetectionCounter)),
-      offered_(false) {
-    // standalone stub: no backend integration
-}
+      debounceKind_(static_cast<std::uint8_t>(ipc::DebounceKind::kMonitorInternal)),
+      offered_(false) {}
 
 Monitor::Monitor(const ara::core::InstanceSpecifier &specifier,
                  std::function<void(InitMonitorReason)> initMonitor,
@@ -22,9 +23,8 @@ Monitor::Monitor(const ara::core::InstanceSpecifier &specifier,
     : specifierPtr_(&specifier),
       initMonitor_(std::move(initMonitor)),
       counterDefaults_(defaultValues),
-      offered_(false) {
-    // standalone stub
-}
+      debounceKind_(static_cast<std::uint8_t>(ipc::DebounceKind::kCounterBased)),
+      offered_(false) {}
 
 Monitor::Monitor(const ara::core::InstanceSpecifier &specifier,
                  std::function<void(InitMonitorReason)> initMonitor,
@@ -32,23 +32,37 @@ Monitor::Monitor(const ara::core::InstanceSpecifier &specifier,
     : specifierPtr_(&specifier),
       initMonitor_(std::move(initMonitor)),
       timeDefaults_(defaultValues),
-      offered_(false) {
-    // standalone stub
+      debounceKind_(static_cast<std::uint8_t>(ipc::DebounceKind::kTimeBased)),
+      offered_(false) {}
+
+Monitor::~Monitor() noexcept {
+    StopOffer();
 }
 
-void Monitor::ReportMonitorAction(MonitorAction /*action*/) {
-    // No backend available in standalone build: ignore
+void Monitor::ReportMonitorAction(MonitorAction action) {
+    // Reports are only forwarded once offered; without a daemon they are ignored.
+    if (!offered_) return;
+    ipc::ClientChannel::Instance().Report(handle_, action);
 }
 
 ara::core::Result<void> Monitor::Offer() {
-    // Standalone library: indicate operation not supported to callers.
-    // Real diagnostic-manager would set offered_ and return success or
-    // Diag-specific errors (e.g. OfferErrc::kAlreadyOffered).
-    return ara::core::Result<void>{ std::make_error_code(std::errc::operation_not_supported) };
+    if (offered_) {
+        return ara::core::Result<void>{ std::make_error_code(std::errc::already_connected) };
+    }
+    // Returns operation_not_supported when no diagnostic-manager is reachable.
+    std::error_code ec = ipc::ClientChannel::Instance().Offer(
+        specifierPtr_->GetName(), static_cast<ipc::DebounceKind>(debounceKind_),
+        counterDefaults_, timeDefaults_, handle_);
+    if (ec) return ara::core::Result<void>{ ec };
+    offered_ = true;
+    if (getFDC_) ipc::FdcPollScheduler::Instance().Add(handle_, &getFDC_);
+    return ara::core::Result<void>{};
 }
 
 void Monitor::StopOffer() {
-    // Standalone stub: nothing to stop
+    if (!offered_) return;
+    if (getFDC_) ipc::FdcPollScheduler::Instance().Remove(handle_);
+    ipc::ClientChannel::Instance().StopOffer(handle_);
     offered_ = false;
 }
 
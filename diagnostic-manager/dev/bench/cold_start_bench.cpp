@@ -0,0 +1,161 @@
+/*
+ * Cold-start time to ready of the diagnostic-manager binary.
+ *
+ * Usage: cold_start_bench <path/to/diagnostic-manager> [repeats]
+ *
+ * For synthetic manifests of increasing size (monitors with mixed debounce
+ * policies, one DTC per 4 monitors, one operation cycle per 100), the
+ * binary is started with $DM_MANIFEST and $DM_STARTUP_PROFILE set. "ready"
+ * is the time from fork until its "binary ready" line arrives on stdout,
+ * "in-process" the profiler's main()-to-ready time; the difference is
+ * exec, dynamic loading and static initialisation. The phase breakdown of
+ * the fastest run follows each row.
+ */
+#include "common/dm_startup_profile.h"
+#include "config/dm_config.h"
+#include "config/dm_manifest.h"
+#include "ara/diag/ipc/report_ring.h"
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace diagnostic_manager;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Run {
+    double readyMs{-1};
+    double inProcessMs{-1};
+    std::vector<std::pair<std::string, double>> phases;   // name, ms
+};
+
+bool write_manifest(const std::string &path, std::size_t monitors) {
+    config::ManifestBuilder builder;
+    const std::size_t cycles = monitors / 100 + 1;
+    for (std::size_t c = 0; c < cycles; ++c) builder.AddCycle("/ecu/OperationCycle_" + std::to_string(c));
+    for (std::size_t d = 0; d < monitors / 4; ++d) builder.AddDtc(static_cast<std::uint32_t>(0x100000 + d));
+    for (std::size_t i = 0; i < monitors; ++i) {
+        event::DebounceConfig cfg;
+        if (i % 4 == 1) cfg.jumpUp = true;
+        if (i % 4 == 2) cfg.mode = event::DebounceMode::TimeBased;
+        if (i % 4 == 3) cfg.mode = event::DebounceMode::MonitorInternal;
+        const std::string name = "/ecu/swc_" + std::to_string(i % 97) + "/DiagnosticMonitor_" + std::to_string(i);
+        builder.AddMonitor(name, cfg);
+        if (i / 4 < monitors / 4) builder.LinkDtc(name, static_cast<std::uint32_t>(0x100000 + i / 4));
+        builder.LinkCycle(name, "/ecu/OperationCycle_" + std::to_string(i / 100));
+    }
+    auto image = builder.Build();
+    if (image.HasError()) return false;
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(image.Value().data()), static_cast<std::streamsize>(image.Value().size()));
+    return static_cast<bool>(out);
+}
+
+void read_profile(const std::string &path, Run &run) {
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        char name[64];
+        unsigned long long start = 0, duration = 0;
+        if (std::sscanf(line.c_str(), "{\"phase\":\"%63[^\"]\",\"start_us\":%llu,\"duration_us\":%llu}", name, &start,
+                        &duration) == 3) {
+            run.phases.emplace_back(name, duration / 1000.0);
+        } else if (std::sscanf(line.c_str(), "{\"ready_us\":%llu", &start) == 1) {
+            run.inProcessMs = start / 1000.0;
+        }
+    }
+}
+
+Run run_once(const char *binary, const std::string &manifest, const std::string &profile, const std::string &socket) {
+    Run run;
+    int out[2];
+    if (pipe(out) != 0) return run;
+    const auto start = Clock::now();
+    const pid_t pid = fork();
+    if (pid == 0) {
+        dup2(out[1], STDOUT_FILENO);
+        close(out[0]);
+        close(out[1]);
+        if (!manifest.empty()) setenv(config::kManifestPathEnv, manifest.c_str(), 1);
+        setenv(common::kStartupProfileEnv, profile.c_str(), 1);
+        setenv(ara::diag::ipc::kSocketPathEnv, socket.c_str(), 1);
+        execl(binary, binary, static_cast<char *>(nullptr));
+        _exit(127);
+    }
+    close(out[1]);
+    if (pid < 0) {
+        close(out[0]);
+        return run;
+    }
+
+    std::string seen;
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(out[0], buf, sizeof(buf))) > 0) {
+        seen.append(buf, static_cast<std::size_t>(n));
+        if (seen.find("binary ready") != std::string::npos) {
+            run.readyMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            break;
+        }
+    }
+    kill(pid, SIGTERM);
+    while (read(out[0], buf, sizeof(buf)) > 0) {
+    }
+    close(out[0]);
+    waitpid(pid, nullptr, 0);
+    if (run.readyMs >= 0) read_profile(profile, run);
+    return run;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <path/to/diagnostic-manager> [repeats]\n", argv[0]);
+        return 2;
+    }
+    const char *binary = argv[1];
+    const int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+    const std::string base = "/tmp/dm_cold_start_" + std::to_string(getpid());
+    const std::string profile = base + ".profile";
+    const std::string socket = base + ".sock";
+
+    std::printf("%-9s %10s %14s\n", "monitors", "ready ms", "in-process ms");
+    for (std::size_t monitors : {std::size_t{0}, std::size_t{1000}, std::size_t{10000}, std::size_t{100000}}) {
+        std::string manifest;
+        if (monitors > 0) {
+            manifest = base + "_" + std::to_string(monitors) + ".dmm";
+            if (!write_manifest(manifest, monitors)) {
+                std::fprintf(stderr, "cannot write %s\n", manifest.c_str());
+                return 1;
+            }
+        }
+        Run best;
+        for (int r = 0; r < repeats; ++r) {
+            Run run = run_once(binary, manifest, profile, socket);
+            if (run.readyMs < 0) {
+                std::fprintf(stderr, "%s did not become ready\n", binary);
+                return 1;
+            }
+            if (best.readyMs < 0 || run.readyMs < best.readyMs) best = std::move(run);
+        }
+        std::printf("%-9zu %10.2f %14.2f\n", monitors, best.readyMs, best.inProcessMs);
+        for (const auto &phase : best.phases) std::printf("          %-26s %8.2f ms\n", phase.first.c_str(), phase.second);
+        if (!manifest.empty()) unlink(manifest.c_str());
+    }
+    unlink(profile.c_str());
+    unlink(socket.c_str());
+    return 0;
+}
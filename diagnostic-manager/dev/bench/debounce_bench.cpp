@@ -0,0 +1,189 @@
+/*
+ * Cost per pre-event report of each debounce policy.
+ *
+ * "raw" runs a policy's OnPreEvent over its group arrays, "mixed" dispatches
+ * the same reports through a per-report switch over interleaved policies (the
+ * layout before monitors were grouped), "DMEvent" goes through
+ * ReportPreEvents including id lookup, locking and notifications.
+ */
+#include "event/dm_debounce.h"
+#include "event/dm_event.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace diagnostic_manager::event;
+
+namespace {
+
+constexpr std::size_t kMonitors = 1024;
+constexpr std::size_t kBatch = 256;
+
+volatile std::uint32_t g_sink;
+
+// Pre-event pattern: mostly pre-passed with bursts of pre-failed, so counters
+// actually move between thresholds.
+std::vector<std::uint8_t> make_pattern(std::size_t n) {
+    std::vector<std::uint8_t> pattern(n);
+    std::uint32_t x = 12345;
+    for (auto &p : pattern) {
+        x = x * 1664525u + 1013904223u;
+        p = (x >> 24) < 96 ? 1 : 0;
+    }
+    return pattern;
+}
+
+DebounceConfig config_for(DebouncePolicy policy) {
+    DebounceConfig cfg;
+    cfg.failedThreshold = 8;
+    cfg.passedThreshold = 8;
+    cfg.fdcThreshold = 4;
+    switch (policy) {
+    case DebouncePolicy::CounterWithJumps:
+        cfg.jumpUp = cfg.jumpDown = true;
+        break;
+    case DebouncePolicy::Time:
+        cfg.mode = DebounceMode::TimeBased;
+        cfg.timeFailedThresholdMs = 1;
+        cfg.timePassedThresholdMs = 2;
+        break;
+    case DebouncePolicy::MonitorInternal:
+        cfg.mode = DebounceMode::MonitorInternal;
+        break;
+    case DebouncePolicy::Counter:
+    default:
+        break;
+    }
+    return cfg;
+}
+
+template <typename Policy>
+double bench_raw(const std::vector<std::uint8_t> &pattern) {
+    const DebounceConfig cfg = config_for(Policy::kPolicy);
+    std::vector<typename Policy::Params> params(kMonitors, Policy::MakeParams(cfg));
+    std::vector<typename Policy::State> states(kMonitors);
+    diagnostic_manager::common::TimerWheel wheel;
+    std::uint32_t decided = 0;
+
+    const auto now = DebounceClock::now();
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        const std::size_t slot = (i * 7) & (kMonitors - 1);
+        DebounceTimers timers{wheel, static_cast<std::uint32_t>(slot)};
+        const DebounceStep step = Policy::OnPreEvent(params[slot], states[slot], pattern[i] != 0, now, timers);
+        decided += static_cast<std::uint32_t>(step.state) + step.fdcReached;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    g_sink = decided;
+    return std::chrono::duration<double, std::nano>(end - start).count() / pattern.size();
+}
+
+// Per-monitor mode switch over an array of interleaved policies.
+struct MixedMonitor {
+    DebouncePolicy policy;
+    CounterDebounce::Params counterParams;
+    CounterJumpDebounce::Params jumpParams;
+    TimePolicy::Params timeParams;
+    CounterDebounce::State counter;
+    TimePolicy::State time;
+};
+
+__attribute__((noinline)) DebounceStep mixed_step(MixedMonitor &m, bool preFailed, DebounceClock::time_point now,
+                                                  DebounceTimers &timers) {
+    switch (m.policy) {
+    case DebouncePolicy::Counter:
+        return CounterDebounce::OnPreEvent(m.counterParams, m.counter, preFailed, now, timers);
+    case DebouncePolicy::CounterWithJumps: {
+        CounterJumpDebounce::State s{m.counter.counter};
+        DebounceStep step = CounterJumpDebounce::OnPreEvent(m.jumpParams, s, preFailed, now, timers);
+        m.counter.counter = s.counter;
+        return step;
+    }
+    case DebouncePolicy::Time:
+        return TimePolicy::OnPreEvent(m.timeParams, m.time, preFailed, now, timers);
+    case DebouncePolicy::MonitorInternal:
+    default:
+        return DebounceStep{};
+    }
+}
+
+double bench_mixed(const std::vector<std::uint8_t> &pattern) {
+    std::vector<MixedMonitor> monitors(kMonitors);
+    for (std::size_t i = 0; i < kMonitors; ++i) {
+        MixedMonitor &m = monitors[i];
+        m.policy = static_cast<DebouncePolicy>(i % 4);
+        const DebounceConfig cfg = config_for(m.policy);
+        m.counterParams = CounterDebounce::MakeParams(cfg);
+        m.jumpParams = CounterJumpDebounce::MakeParams(cfg);
+        m.timeParams = TimePolicy::MakeParams(cfg);
+    }
+    diagnostic_manager::common::TimerWheel wheel;
+    std::uint32_t decided = 0;
+
+    const auto now = DebounceClock::now();
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        const std::size_t slot = (i * 7) & (kMonitors - 1);
+        DebounceTimers timers{wheel, static_cast<std::uint32_t>(slot)};
+        const DebounceStep step = mixed_step(monitors[slot], pattern[i] != 0, now, timers);
+        decided += static_cast<std::uint32_t>(step.state) + step.fdcReached;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    g_sink = decided;
+    return std::chrono::duration<double, std::nano>(end - start).count() / pattern.size();
+}
+
+double bench_dm_event(DebouncePolicy policy, const std::vector<std::uint8_t> &pattern) {
+    const std::string prefix = "bench/" + std::to_string(static_cast<int>(policy)) + "/";
+    std::vector<MonitorId> ids;
+    for (std::size_t i = 0; i < kMonitors; ++i) {
+        ids.push_back(prefix + std::to_string(i));
+        DMEvent::RegisterMonitor(ids.back(), config_for(policy), nullptr);
+    }
+
+    std::vector<PreEventUpdate> batch(kBatch);
+    const std::size_t rounds = pattern.size() / kBatch;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < rounds; ++r) {
+        for (std::size_t j = 0; j < kBatch; ++j) {
+            const std::size_t i = r * kBatch + j;
+            batch[j] = PreEventUpdate{&ids[(i * 7) & (kMonitors - 1)], pattern[i] != 0};
+        }
+        g_sink = static_cast<std::uint32_t>(DMEvent::ReportPreEvents(batch.data(), batch.size()));
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    for (const MonitorId &id : ids) DMEvent::UnregisterMonitor(id);
+    return std::chrono::duration<double, std::nano>(end - start).count() / (rounds * kBatch);
+}
+
+const char *policy_name(DebouncePolicy policy) {
+    switch (policy) {
+    case DebouncePolicy::Counter: return "counter";
+    case DebouncePolicy::CounterWithJumps: return "counter+jumps";
+    case DebouncePolicy::Time: return "time";
+    case DebouncePolicy::MonitorInternal: return "monitor-internal";
+    }
+    return "?";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+    const std::vector<std::uint8_t> pattern = make_pattern(n);
+
+    std::printf("%-18s %10s %12s\n", "policy", "raw ns", "DMEvent ns");
+    const double raw[] = {bench_raw<CounterDebounce>(pattern), bench_raw<CounterJumpDebounce>(pattern),
+                          bench_raw<TimePolicy>(pattern), bench_raw<MonitorInternalPolicy>(pattern)};
+    for (int p = 0; p < 4; ++p) {
+        const auto policy = static_cast<DebouncePolicy>(p);
+        std::printf("%-18s %10.2f %12.2f\n", policy_name(policy), raw[p], bench_dm_event(policy, pattern));
+    }
+    std::printf("%-18s %10.2f\n", "mixed (switch)", bench_mixed(pattern));
+    return 0;
+}
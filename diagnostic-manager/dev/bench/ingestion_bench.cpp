@@ -0,0 +1,124 @@
+/*
+ * Pre-event throughput with 1 / 2 / 4 / 8 reporting threads.
+ *
+ * "direct" calls DMEvent::ReportPreEvent from every reporter, so all of them
+ * contend for the DMEvent lock. "queued" reports through DMIngestion: each
+ * reporter writes its own queue and the consumers apply batches. Both report
+ * the same pattern to 1024 counter-debounced monitors, each reporter to its
+ * own slice. "Mrep/s" counts until every report is applied (for "queued",
+ * including the final drain in Stop); "ns/rep" is the time a reporter spends
+ * per call. Reports rejected on a full queue are retried and counted as
+ * "retries".
+ */
+#include "event/dm_event.h"
+#include "event/dm_ingestion.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace diagnostic_manager::event;
+
+namespace {
+
+constexpr std::size_t kMonitors = 1024;
+constexpr std::size_t kReportsPerThread = 1 << 20;
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    double mreportsPerSec{0};
+    double nsPerReport{0};
+    std::uint64_t retries{0};
+};
+
+template <typename Report>
+Result run(std::size_t threads, Report &&report) {
+    std::atomic<std::size_t> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<std::uint64_t> reporterNs{0}, retries{0};
+    std::vector<std::thread> reporters;
+    for (std::size_t t = 0; t < threads; ++t) {
+        reporters.emplace_back([&, t] {
+            const std::size_t first = t * kMonitors / threads;
+            const std::size_t count = kMonitors / threads;
+            std::uint32_t x = 12345u + static_cast<std::uint32_t>(t);
+            std::uint64_t retried = 0;
+            ++ready;
+            while (!go.load(std::memory_order_acquire)) {
+            }
+            const auto start = Clock::now();
+            for (std::size_t i = 0; i < kReportsPerThread; ++i) {
+                x = x * 1664525u + 1013904223u;
+                retried += report(first + i % count, (x >> 24) < 96);
+            }
+            reporterNs += static_cast<std::uint64_t>(std::chrono::nanoseconds(Clock::now() - start).count());
+            retries += retried;
+        });
+    }
+    while (ready.load() != threads) {
+    }
+    const auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto &r : reporters) r.join();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    Result res;
+    const double total = static_cast<double>(threads * kReportsPerThread);
+    res.mreportsPerSec = total / elapsed / 1e6;
+    res.nsPerReport = static_cast<double>(reporterNs.load()) / total;
+    res.retries = retries.load();
+    return res;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t consumers = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 2;
+
+    std::vector<MonitorId> ids;
+    std::vector<MonitorHandle> handles;
+    for (std::size_t i = 0; i < kMonitors; ++i) {
+        DebounceConfig cfg;
+        cfg.failedThreshold = 8;
+        cfg.passedThreshold = 8;
+        ids.push_back("/ecu/swc_" + std::to_string(i % 97) + "/DiagnosticMonitor_" + std::to_string(i));
+        if (DMEvent::RegisterMonitor(ids.back(), cfg, nullptr).HasError()) return 1;
+        handles.push_back(*DMEvent::GetMonitorHandle(ids.back()));
+    }
+
+    std::printf("%zu consumer(s), %zu reports per reporter\n", consumers, kReportsPerThread);
+    std::printf("%-8s %-7s %9s %9s %10s\n", "threads", "path", "Mrep/s", "ns/rep", "retries");
+    for (std::size_t threads : {std::size_t{1}, std::size_t{2}, std::size_t{4}, std::size_t{8}}) {
+        const Result direct = run(threads, [&](std::size_t m, bool failed) -> std::uint64_t {
+            DMEvent::ReportPreEvent(ids[m], failed);
+            return 0;
+        });
+        std::printf("%-8zu %-7s %9.2f %9.1f %10s\n", threads, "direct", direct.mreportsPerSec, direct.nsPerReport, "-");
+
+        IngestionConfig cfg;
+        cfg.consumers = consumers;
+        if (DMIngestion::Start(cfg).HasError()) return 1;
+        const auto start = Clock::now();
+        Result queued = run(threads, [&](std::size_t m, bool failed) -> std::uint64_t {
+            std::uint64_t retried = 0;
+            while (DMIngestion::ReportPreEvent(handles[m], failed).HasError()) {
+                ++retried;
+                std::this_thread::yield();
+            }
+            return retried;
+        });
+        DMIngestion::Stop();
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        queued.mreportsPerSec = static_cast<double>(threads * kReportsPerThread) / elapsed / 1e6;
+        std::printf("%-8zu %-7s %9.2f %9.1f %10llu\n", threads, "queued", queued.mreportsPerSec, queued.nsPerReport,
+                    static_cast<unsigned long long>(queued.retries));
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * Stage-by-stage reaction time from a pre-event report to the DTC status
+ * notifier, with latency tracing on (common::LatencyTrace).
+ *
+ * Writer threads report a fixed total rate to 1024 counter-debounced
+ * monitors (threshold 3), each writer to its own slice, alternating three
+ * pre-failed and three pre-passed reports per monitor so that every third
+ * report qualifies. Each monitor's qualified notifier reports the status of
+ * its DTC. Reports are paced in 1 ms ticks and stamped when generated.
+ *
+ * "queued" reports through DMIngestion (Transport includes the queue);
+ * "batched" hands each tick's reports to DMEvent::ReportPreEvents, as the
+ * IPC server does with a drained ring.
+ *
+ *   latency_trace_bench [queued|batched] [writers=2] [reports/s=200000] [seconds=3]
+ */
+#include "common/dm_latency_trace.h"
+#include "dtc/dm_dtc.h"
+#include "event/dm_event.h"
+#include "event/dm_ingestion.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace diagnostic_manager;
+using common::LatencyTrace;
+using common::TraceStage;
+
+namespace {
+
+constexpr std::size_t kMonitors = 1024;
+constexpr dtc::DtcId kFirstDtc = 0x500000;
+
+using Clock = std::chrono::steady_clock;
+
+const char *const kStageNames[common::kTraceStages] = {"transport", "debounce", "notify",
+                                                       "dtc update", "dtc notify", "end to end"};
+
+void print_stage(TraceStage stage, const common::LatencyHistogram &h) {
+    std::printf("%-12s %10llu %9.2f %9.2f %9.2f %9.2f %9.2f\n", kStageNames[static_cast<std::size_t>(stage)],
+                static_cast<unsigned long long>(h.count), static_cast<double>(h.MeanNs()) / 1000.0,
+                static_cast<double>(h.PercentileNs(0.5)) / 1000.0, static_cast<double>(h.PercentileNs(0.99)) / 1000.0,
+                static_cast<double>(h.PercentileNs(0.999)) / 1000.0, static_cast<double>(h.maxNs) / 1000.0);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const bool queued = argc <= 1 || std::strcmp(argv[1], "batched") != 0;
+    const std::size_t writers = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 2;
+    const double rate = argc > 3 ? std::atof(argv[3]) : 200000.0;
+    const double seconds = argc > 4 ? std::atof(argv[4]) : 3.0;
+    if (writers == 0 || writers > kMonitors || rate <= 0) return 1;
+
+    std::vector<event::MonitorHandle> handles;
+    for (std::size_t i = 0; i < kMonitors; ++i) {
+        const dtc::DtcId dtc = kFirstDtc + static_cast<dtc::DtcId>(i);
+        if (dtc::DMDtc::RegisterDtc(dtc, [](dtc::DtcId, dtc::UdsStatusByte, dtc::UdsStatusByte) {}).HasError()) return 1;
+        const event::MonitorId id = "/ecu/trace_swc/DiagnosticMonitor_" + std::to_string(i);
+        const auto toDtc = [dtc](const event::MonitorId &, event::QualifiedState state) {
+            dtc::DMDtc::ReportDtcStatus(dtc, state == event::QualifiedState::QualifiedFailed ? 0x09 : 0x08);
+        };
+        if (event::DMEvent::RegisterMonitor(id, event::DebounceConfig{}, toDtc).HasError()) return 1;
+        handles.push_back(*event::DMEvent::GetMonitorHandle(id));
+    }
+    if (queued && event::DMIngestion::Start().HasError()) return 1;
+
+    LatencyTrace::Reset();
+    LatencyTrace::Enable(true);
+    const std::size_t perTick = std::max<std::size_t>(1, static_cast<std::size_t>(rate / 1000.0 / static_cast<double>(writers)));
+    const auto ticks = static_cast<std::size_t>(seconds * 1000.0);
+    std::atomic<std::uint64_t> reports{0}, rejected{0};
+    std::vector<std::thread> threads;
+    for (std::size_t w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            const std::size_t first = w * kMonitors / writers;
+            const std::size_t count = kMonitors / writers;
+            std::vector<event::HandlePreEventUpdate> batch;
+            std::uint64_t n = 0, lost = 0;
+            auto next = Clock::now();
+            for (std::size_t t = 0; t < ticks; ++t) {
+                batch.clear();
+                for (std::size_t i = 0; i < perTick; ++i, ++n) {
+                    const event::MonitorHandle h = handles[first + n % count];
+                    const bool preFailed = (n / count / 3) % 2 == 0;
+                    if (queued) {
+                        lost += event::DMIngestion::ReportPreEvent(h, preFailed).HasError();
+                    } else {
+                        batch.push_back(event::HandlePreEventUpdate{h, preFailed, LatencyTrace::NowNs()});
+                    }
+                }
+                if (!queued) event::DMEvent::ReportPreEvents(batch.data(), batch.size());
+                next += std::chrono::milliseconds(1);
+                std::this_thread::sleep_until(next);
+            }
+            reports.fetch_add(n, std::memory_order_relaxed);
+            rejected.fetch_add(lost, std::memory_order_relaxed);
+        });
+    }
+    for (auto &t : threads) t.join();
+    if (queued) event::DMIngestion::Stop();
+    LatencyTrace::Enable(false);
+
+    const common::LatencyTraceStatistics stats = LatencyTrace::GetStatistics();
+    std::printf("%s, %zu writer(s), %.0f reports/s for %.1f s: %llu reports, %llu rejected\n",
+                queued ? "queued" : "batched", writers, rate, seconds, static_cast<unsigned long long>(reports.load()),
+                static_cast<unsigned long long>(rejected.load()));
+    std::printf("%-12s %10s %9s %9s %9s %9s %9s\n", "stage (us)", "samples", "mean", "p50", "p99", "p999", "max");
+    for (std::size_t s = 0; s < common::kTraceStages; ++s) print_stage(static_cast<TraceStage>(s), stats.stages[s]);
+    return 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * Registers 100k monitors and 100k DTCs in bulk, the way a manifest load
+ * does, and prints the memory held per entity, split into hot records,
+ * side tables, lookup structures and debounce state.
+ */
+#include "dtc/dm_dtc.h"
+#include "event/dm_event.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace diagnostic_manager;
+
+namespace {
+
+constexpr std::size_t kEntities = 100000;
+
+void print(const char *what, const common::MemoryFootprint &f) {
+    std::printf("%-9s %8zu %10zu %10zu %10zu %10zu %10.1f %8.2f\n", what, f.entities, f.hotBytes, f.coldBytes,
+                f.indexBytes, f.debounceBytes, f.BytesPerEntity(), static_cast<double>(f.Total()) / (1 << 20));
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> ids;
+    std::vector<event::MonitorRegistration> monitors;
+    ids.reserve(kEntities);
+    for (std::size_t i = 0; i < kEntities; ++i) ids.push_back("/ecu/swc_" + std::to_string(i % 64) + "/Mon_" + std::to_string(i));
+    for (std::size_t i = 0; i < kEntities; ++i) {
+        event::DebounceConfig cfg;
+        if (i % 4 == 3) cfg.mode = event::DebounceMode::TimeBased;
+        monitors.push_back(event::MonitorRegistration{ids[i], cfg, nullptr});
+    }
+    if (event::DMEvent::RegisterMonitors(monitors.data(), monitors.size()).HasError()) return 1;
+
+    std::vector<dtc::DtcRegistration> dtcs;
+    for (std::size_t i = 0; i < kEntities; ++i) dtcs.push_back(dtc::DtcRegistration{static_cast<dtc::DtcId>(0x100000 + i), nullptr});
+    if (dtc::DMDtc::RegisterDtcs(dtcs.data(), dtcs.size()).HasError()) return 1;
+
+    std::printf("%-9s %8s %10s %10s %10s %10s %10s %8s\n", "registry", "entities", "hot B", "cold B", "index B",
+                "debounce B", "B/entity", "MiB");
+    print("monitors", event::DMEvent::GetMemoryFootprint());
+    print("dtcs", dtc::DMDtc::GetMemoryFootprint());
+    return 0;
+}
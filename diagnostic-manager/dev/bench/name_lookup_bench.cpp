@@ -0,0 +1,133 @@
+/*
+ * Name-to-instance resolution for 1k / 10k / 100k InstanceSpecifier names.
+ *
+ * Compares common::PerfectHash (as built by the bulk registration calls)
+ * with std::unordered_map<std::string, uint32_t>: build time for the whole
+ * set, and ns per lookup for registered names ("hit") and unknown names of
+ * the same shape ("miss"), passed as std::string like MonitorId. Like the
+ * registries, the perfect hash is paired with a table of entries by slot
+ * that views the names, and a lookup compares against the name there; KiB
+ * includes that table. Lookups go in a shuffled order so that neither
+ * structure benefits from insertion order.
+ */
+#include "common/dm_perfect_hash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using diagnostic_manager::common::PerfectHash;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile std::uint64_t g_sink;
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::vector<std::string> make_names(std::size_t n, const char *prefix) {
+    std::vector<std::string> names;
+    names.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        names.push_back(std::string(prefix) + "/swc_" + std::to_string(i % 97) + "/DiagnosticMonitor_" + std::to_string(i));
+    }
+    return names;
+}
+
+std::vector<std::string> shuffled(std::vector<std::string> order) {
+    std::uint32_t x = 2463534242u;
+    for (std::size_t i = order.size(); i > 1; --i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        std::swap(order[i - 1], order[x % i]);
+    }
+    return order;
+}
+
+template <typename F>
+double ns_per_lookup(const std::vector<std::string> &keys, int rounds, F &&find) {
+    const auto start = Clock::now();
+    std::uint64_t found = 0;
+    for (int r = 0; r < rounds; ++r) {
+        for (const std::string &k : keys) found += find(k);
+    }
+    g_sink = found;
+    return ms_since(start) * 1e6 / (static_cast<double>(keys.size()) * rounds);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const int repeats = argc > 1 ? std::atoi(argv[1]) : 3;
+
+    std::printf("%-8s %-14s %10s %10s %10s %10s\n", "names", "structure", "build ms", "hit ns", "miss ns", "KiB");
+    for (std::size_t n : {std::size_t{1000}, std::size_t{10000}, std::size_t{100000}}) {
+        const auto names = make_names(n, "/ecu");
+        const auto unknown = make_names(n, "/ecx");
+        const auto hits = shuffled(names);
+        const auto misses = shuffled(unknown);
+        const int rounds = static_cast<int>(std::max<std::size_t>(1, 2000000 / n));
+        const std::vector<std::string_view> views(names.begin(), names.end());
+        std::vector<char> blocks;
+        std::vector<std::size_t> blockAt;
+        for (std::string_view v : views) {
+            const auto len = static_cast<std::uint32_t>(v.size());
+            blockAt.push_back(blocks.size());
+            blocks.insert(blocks.end(), reinterpret_cast<const char *>(&len), reinterpret_cast<const char *>(&len) + sizeof len);
+            blocks.insert(blocks.end(), v.begin(), v.end());
+        }
+
+        double best[2][3] = {{1e30, 1e30, 1e30}, {1e30, 1e30, 1e30}};
+        std::size_t bytes[2] = {0, 0};
+        for (int r = 0; r < repeats; ++r) {
+            auto start = Clock::now();
+            auto built = PerfectHash::Build(views);
+            if (built.HasError()) {
+                std::fprintf(stderr, "PerfectHash::Build failed\n");
+                return 1;
+            }
+            const PerfectHash &ph = built.Value();
+            std::vector<const char *> bySlot(n);
+            for (std::size_t i = 0; i < n; ++i) bySlot[ph.Slot(views[i])] = blocks.data() + blockAt[i];
+            best[0][0] = std::min(best[0][0], ms_since(start));
+            bytes[0] = ph.MemoryBytes() + bySlot.capacity() * sizeof(const char *);
+            auto phFind = [&](const std::string &k) {
+                const char *b = bySlot[ph.Slot(k)];
+                std::uint32_t len;
+                std::memcpy(&len, b, sizeof len);
+                return std::string_view(b + sizeof len, len) == k ? 1u : 0u;
+            };
+            best[0][1] = std::min(best[0][1], ns_per_lookup(hits, rounds, phFind));
+            best[0][2] = std::min(best[0][2], ns_per_lookup(misses, rounds, phFind));
+
+            start = Clock::now();
+            std::unordered_map<std::string, std::uint32_t> map;
+            map.reserve(n);
+            for (std::size_t i = 0; i < n; ++i) map.emplace(names[i], static_cast<std::uint32_t>(i));
+            best[1][0] = std::min(best[1][0], ms_since(start));
+            auto mapFind = [&](const std::string &k) { return map.find(k) != map.end() ? 1u : 0u; };
+            best[1][1] = std::min(best[1][1], ns_per_lookup(hits, rounds, mapFind));
+            best[1][2] = std::min(best[1][2], ns_per_lookup(misses, rounds, mapFind));
+            // approximate: buckets plus one node (key, value, next, cached hash) per name
+            bytes[1] = map.bucket_count() * sizeof(void *) +
+                       n * (sizeof(std::string) + sizeof(std::uint32_t) + 2 * sizeof(void *) + names[0].size());
+        }
+        const char *labels[2] = {"PerfectHash", "unordered_map"};
+        for (int s = 0; s < 2; ++s) {
+            std::printf("%-8zu %-14s %10.2f %10.1f %10.1f %10zu\n", n, labels[s], best[s][0], best[s][1], best[s][2],
+                        bytes[s] / 1024);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+/*
+ * Fault storm: reporter threads repeat the same pre-failed report for
+ * monitors that are already qualified failed.
+ *
+ * Reports go by MonitorHandle with the repeat filter off (every report
+ * takes the DMEvent lock) and on (dropped before any shared state is
+ * touched). Prints ns per report per thread and the filter's count.
+ */
+#include "event/dm_event.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace diagnostic_manager::event;
+
+namespace {
+
+constexpr std::size_t kMonitors = 256;
+constexpr std::size_t kReportsPerThread = 1 << 20;
+
+double storm(std::size_t threads, const std::vector<MonitorHandle> &handles) {
+    std::atomic<std::size_t> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<std::uint64_t> totalNs{0};
+    std::vector<std::thread> reporters;
+    for (std::size_t t = 0; t < threads; ++t) {
+        reporters.emplace_back([&, t] {
+            ++ready;
+            while (!go.load(std::memory_order_acquire)) {
+            }
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < kReportsPerThread; ++i) {
+                DMEvent::ReportPreEvent(handles[(t * 31 + i) % kMonitors], true);
+            }
+            totalNs += static_cast<std::uint64_t>(std::chrono::nanoseconds(std::chrono::steady_clock::now() - start).count());
+        });
+    }
+    while (ready.load() != threads) {
+    }
+    go.store(true, std::memory_order_release);
+    for (auto &r : reporters) r.join();
+    return static_cast<double>(totalNs.load()) / static_cast<double>(threads * kReportsPerThread);
+}
+
+} // namespace
+
+int main() {
+    std::vector<MonitorHandle> handles;
+    for (std::size_t i = 0; i < kMonitors; ++i) {
+        const MonitorId id = "/ecu/swc_" + std::to_string(i % 7) + "/DiagnosticMonitor_" + std::to_string(i);
+        if (DMEvent::RegisterMonitor(id, DebounceConfig{}, nullptr).HasError()) return 1;
+        handles.push_back(*DMEvent::GetMonitorHandle(id));
+        for (int r = 0; r < 3; ++r) DMEvent::ReportPreEvent(handles.back(), true);   // qualified failed
+    }
+
+    std::printf("%-8s %12s %12s %14s\n", "threads", "off ns/rep", "on ns/rep", "filtered");
+    for (std::size_t threads : {std::size_t{1}, std::size_t{2}, std::size_t{4}, std::size_t{8}}) {
+        DMEvent::SetOverloadPolicy(OverloadPolicy{});
+        const double off = storm(threads, handles);
+        DMEvent::SetOverloadPolicy(OverloadPolicy{true, 0, OverloadAction::Drop});
+        const std::uint64_t before = DMEvent::GetOverloadStatistics().filtered;
+        const double on = storm(threads, handles);
+        std::printf("%-8zu %12.1f %12.1f %14llu\n", threads, off, on,
+                    static_cast<unsigned long long>(DMEvent::GetOverloadStatistics().filtered - before));
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * ara::core::Result codegen / cost compared with the previous layout
+ * (ok flag + default-constructed T + std::error_code side by side).
+ *
+ * The bench_* functions are noinline so their code can be compared with
+ *   objdump -d --no-show-raw-insn result_bench | c++filt | less
+ */
+#include "ara/core/result_future.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace legacy {
+
+template <typename T>
+class Result {
+public:
+    Result() noexcept : ok_(true) {}
+    explicit Result(const std::error_code &ec) noexcept : ok_(false), error_(ec) {}
+    explicit Result(T value) noexcept : ok_(true), value_(std::move(value)) {}
+
+    bool IsOk() const noexcept { return ok_; }
+    const std::error_code &Error() const noexcept { return error_; }
+    const T &Value() const & { return value_; }
+    T &&Value() && { return std::move(value_); }
+
+private:
+    bool ok_{false};
+    T value_{};
+    std::error_code error_;
+};
+
+} // namespace legacy
+
+namespace {
+
+struct StatusRecord {
+    std::uint32_t dtc;
+    std::uint8_t status;
+    std::uint64_t timestamp;
+};
+
+volatile std::uint32_t g_sink;
+
+} // namespace
+
+__attribute__((noinline)) ara::core::Result<std::uint8_t> bench_new_status(std::uint32_t key) {
+    if ((key & 15) == 0) return ara::core::Result<std::uint8_t>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    return ara::core::Result<std::uint8_t>{ static_cast<std::uint8_t>(key) };
+}
+
+__attribute__((noinline)) legacy::Result<std::uint8_t> bench_legacy_status(std::uint32_t key) {
+    if ((key & 15) == 0) return legacy::Result<std::uint8_t>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    return legacy::Result<std::uint8_t>{ static_cast<std::uint8_t>(key) };
+}
+
+__attribute__((noinline)) ara::core::Result<StatusRecord> bench_new_record(std::uint32_t key) {
+    if ((key & 15) == 0) return ara::core::Result<StatusRecord>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    return ara::core::Result<StatusRecord>{ StatusRecord{key, static_cast<std::uint8_t>(key), key * 3ull} };
+}
+
+__attribute__((noinline)) legacy::Result<StatusRecord> bench_legacy_record(std::uint32_t key) {
+    if ((key & 15) == 0) return legacy::Result<StatusRecord>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    return legacy::Result<StatusRecord>{ StatusRecord{key, static_cast<std::uint8_t>(key), key * 3ull} };
+}
+
+__attribute__((noinline)) ara::core::Result<std::string> bench_new_string(std::uint32_t key) {
+    if ((key & 15) == 0) return ara::core::Result<std::string>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    return ara::core::Result<std::string>{ std::string("monitor") };
+}
+
+__attribute__((noinline)) legacy::Result<std::string> bench_legacy_string(std::uint32_t key) {
+    if ((key & 15) == 0) return legacy::Result<std::string>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    return legacy::Result<std::string>{ std::string("monitor") };
+}
+
+template <typename F>
+static void run(const char *name, std::size_t size, int iterations, F &&body) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) body(static_cast<std::uint32_t>(i));
+    const auto end = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    std::printf("%-28s sizeof=%3zu %8.2f ns/op\n", name, size, ns);
+}
+
+int main(int argc, char **argv) {
+    const int n = argc > 1 ? std::atoi(argv[1]) : 10000000;
+
+    run("new    Result<uint8_t>", sizeof(ara::core::Result<std::uint8_t>), n, [](std::uint32_t i) {
+        auto r = bench_new_status(i);
+        g_sink = r.HasValue() ? r.Value() : 0u;
+    });
+    run("legacy Result<uint8_t>", sizeof(legacy::Result<std::uint8_t>), n, [](std::uint32_t i) {
+        auto r = bench_legacy_status(i);
+        g_sink = r.IsOk() ? r.Value() : 0u;
+    });
+    run("new    Result<StatusRecord>", sizeof(ara::core::Result<StatusRecord>), n, [](std::uint32_t i) {
+        auto r = bench_new_record(i);
+        g_sink = r.HasValue() ? r.Value().status : 0u;
+    });
+    run("legacy Result<StatusRecord>", sizeof(legacy::Result<StatusRecord>), n, [](std::uint32_t i) {
+        auto r = bench_legacy_record(i);
+        g_sink = r.IsOk() ? r.Value().status : 0u;
+    });
+    run("new    Result<std::string>", sizeof(ara::core::Result<std::string>), n, [](std::uint32_t i) {
+        auto r = bench_new_string(i);
+        g_sink = r.HasValue() ? static_cast<std::uint32_t>(r.Value().size()) : 0u;
+    });
+    run("legacy Result<std::string>", sizeof(legacy::Result<std::string>), n, [](std::uint32_t i) {
+        auto r = bench_legacy_string(i);
+        g_sink = r.IsOk() ? static_cast<std::uint32_t>(r.Value().size()) : 0u;
+    });
+    run("new    Result<void>", sizeof(ara::core::Result<void>), n, [](std::uint32_t i) {
+        auto r = (i & 15) == 0 ? ara::core::Result<void>{ std::make_error_code(std::errc::io_error) }
+                               : ara::core::Result<void>{};
+        g_sink = r.HasError() ? 1u : 0u;
+    });
+    return 0;
+}
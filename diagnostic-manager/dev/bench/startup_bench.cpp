@@ -0,0 +1,151 @@
+/*
+ * Registration cost at startup for 1k / 10k / 100k entities.
+ *
+ * "single" registers each entity with its own Register* call, "bulk" hands
+ * the same set to RegisterMonitors / RegisterDtcs / RegisterOperationCycles.
+ * Monitors use a mix of debounce policies. Each run happens in a forked
+ * child so it starts from empty tables, as at process start; times are
+ * wall-clock for the whole set, best of N runs.
+ */
+#include "dtc/dm_dtc.h"
+#include "event/dm_event.h"
+#include "operationcycle/dm_operation_cycle.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace diagnostic_manager;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+event::DebounceConfig config_for(std::size_t i) {
+    event::DebounceConfig cfg;
+    switch (i % 4) {
+    case 1: cfg.jumpUp = true; break;
+    case 2: cfg.mode = event::DebounceMode::TimeBased; break;
+    case 3: cfg.mode = event::DebounceMode::MonitorInternal; break;
+    default: break;
+    }
+    return cfg;
+}
+
+struct Names {
+    std::vector<std::string> monitors;
+    std::vector<std::string> cycles;
+};
+
+Names make_names(std::size_t n) {
+    Names names;
+    for (std::size_t i = 0; i < n; ++i) {
+        names.monitors.push_back("/ecu/swc_" + std::to_string(i % 97) + "/DiagnosticMonitor_" + std::to_string(i));
+        names.cycles.push_back("/ecu/OperationCycle_" + std::to_string(i));
+    }
+    return names;
+}
+
+struct Timing {
+    double monitors;
+    double dtcs;
+    double cycles;
+};
+
+Timing run_single(const Names &names, std::size_t n) {
+    Timing t{};
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < n; ++i) event::DMEvent::RegisterMonitor(names.monitors[i], config_for(i), nullptr);
+    t.monitors = ms_since(start);
+    start = Clock::now();
+    for (std::size_t i = 0; i < n; ++i) dtc::DMDtc::RegisterDtc(static_cast<dtc::DtcId>(i));
+    t.dtcs = ms_since(start);
+    start = Clock::now();
+    for (std::size_t i = 0; i < n; ++i) operation_cycle::DMOperationCycle::RegisterOperationCycle(names.cycles[i]);
+    t.cycles = ms_since(start);
+    return t;
+}
+
+// Descriptors are prepared before timing, as the manifest loader has them
+// ready from the mapped tables.
+Timing run_bulk(const Names &names, std::size_t n) {
+    std::vector<event::MonitorRegistration> monitors(n);
+    std::vector<dtc::DtcRegistration> dtcs(n);
+    std::vector<operation_cycle::OperationCycleRegistration> cycles(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        monitors[i].id = names.monitors[i];
+        monitors[i].cfg = config_for(i);
+        dtcs[i].dtc = static_cast<dtc::DtcId>(i);
+        cycles[i].id = names.cycles[i];
+    }
+
+    Timing t{};
+    auto start = Clock::now();
+    if (event::DMEvent::RegisterMonitors(monitors.data(), n).HasError()) std::fprintf(stderr, "RegisterMonitors failed\n");
+    t.monitors = ms_since(start);
+    start = Clock::now();
+    if (dtc::DMDtc::RegisterDtcs(dtcs.data(), n).HasError()) std::fprintf(stderr, "RegisterDtcs failed\n");
+    t.dtcs = ms_since(start);
+    start = Clock::now();
+    if (operation_cycle::DMOperationCycle::RegisterOperationCycles(cycles.data(), n).HasError()) {
+        std::fprintf(stderr, "RegisterOperationCycles failed\n");
+    }
+    t.cycles = ms_since(start);
+    return t;
+}
+
+// Run one measurement in a child process and read its result back.
+Timing run_forked(const Names &names, std::size_t n, bool bulk) {
+    Timing t{-1, -1, -1};
+    int fds[2];
+    if (pipe(fds) != 0) return t;
+    const pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        const Timing result = bulk ? run_bulk(names, n) : run_single(names, n);
+        const ssize_t written = write(fds[1], &result, sizeof(result));
+        _exit(written == static_cast<ssize_t>(sizeof(result)) ? 0 : 1);
+    }
+    close(fds[1]);
+    if (pid > 0) {
+        if (read(fds[0], &t, sizeof(t)) != static_cast<ssize_t>(sizeof(t))) t = Timing{-1, -1, -1};
+        waitpid(pid, nullptr, 0);
+    }
+    close(fds[0]);
+    return t;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const int repeats = argc > 1 ? std::atoi(argv[1]) : 3;
+
+    std::printf("%-8s %-7s %12s %12s %12s\n", "entities", "mode", "monitors ms", "dtcs ms", "cycles ms");
+    for (std::size_t n : {std::size_t{1000}, std::size_t{10000}, std::size_t{100000}}) {
+        const Names names = make_names(n);
+        Timing best[2] = {{1e30, 1e30, 1e30}, {1e30, 1e30, 1e30}};
+        for (int r = 0; r < repeats; ++r) {
+            for (int mode = 0; mode < 2; ++mode) {
+                const Timing t = run_forked(names, n, mode == 1);
+                best[mode].monitors = std::min(best[mode].monitors, t.monitors);
+                best[mode].dtcs = std::min(best[mode].dtcs, t.dtcs);
+                best[mode].cycles = std::min(best[mode].cycles, t.cycles);
+            }
+        }
+        for (int mode = 0; mode < 2; ++mode) {
+            std::printf("%-8zu %-7s %12.2f %12.2f %12.2f\n", n, mode == 0 ? "single" : "bulk",
+                        best[mode].monitors, best[mode].dtcs, best[mode].cycles);
+        }
+    }
+    return 0;
+}
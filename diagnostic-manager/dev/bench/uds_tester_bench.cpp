@@ -0,0 +1,205 @@
+/*
+ * Fault reporting under a diagnostic tester.
+ *
+ * Writer threads report pre-events by handle to counter-debounced
+ * monitors, picking monitors from a skewed fault distribution: `hot-share`
+ * of the reports go to the first 1% ("hot", flapping), the rest spread
+ * uniformly with few failures. Each monitor's qualified notifier reports
+ * the status of its DTC, as the event-to-DTC path of an ECU does.
+ *
+ * Meanwhile one tester thread issues UDS-like requests at typical rates:
+ *   0x19 02 reportDTCByStatusMask    every 20 ms  (status of all DTCs, masked)
+ *   0x19 04 per-DTC record read       every 5 ms   (status, suppression and event status of one DTC;
+ *                                                   the DM keeps no snapshot data)
+ *   0x14    clear all DTCs            every 1 s
+ *
+ * Prints writer throughput, tester response time percentiles per request
+ * and notifier lag: from the start of the call that caused a DTC status
+ * change to its DTC notifier running. Built with -DDM_LOCK_PROFILE=ON it
+ * also dumps the contention of the DM's registry locks.
+ *
+ *   uds_tester_bench [writers=4] [seconds=5] [hot-share=0.8] [dtcs=2000]
+ */
+#include "common/dm_lock_profile.h"
+#include "dtc/dm_dtc.h"
+#include "event/dm_event.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace diagnostic_manager;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr dtc::DtcId kFirstDtc = 0x400000;
+constexpr dtc::UdsStatusByte kTestFailed = 0x01;
+constexpr dtc::UdsStatusByte kConfirmed = 0x08;
+
+// Latency samples in ns, one set per thread, merged at the end.
+struct Samples {
+    std::vector<std::uint64_t> ns;
+    void Add(Clock::time_point since) {
+        ns.push_back(static_cast<std::uint64_t>(std::chrono::nanoseconds(Clock::now() - since).count()));
+    }
+};
+
+thread_local Clock::time_point t_callStart;   // start of the DM call that may notify
+thread_local Samples *t_lag = nullptr;
+
+std::mutex g_lagMutex;
+std::vector<std::unique_ptr<Samples>> g_lagSamples;
+
+Samples &thread_lag_samples() {
+    if (t_lag == nullptr) {
+        std::lock_guard<std::mutex> lk(g_lagMutex);
+        g_lagSamples.push_back(std::make_unique<Samples>());
+        t_lag = g_lagSamples.back().get();
+        t_lag->ns.reserve(1 << 20);
+    }
+    return *t_lag;
+}
+
+void print_percentiles(const char *what, std::vector<std::uint64_t> ns) {
+    if (ns.empty()) {
+        std::printf("%-22s %10s\n", what, "no samples");
+        return;
+    }
+    std::sort(ns.begin(), ns.end());
+    const auto at = [&](double q) {
+        return static_cast<double>(ns[std::min(ns.size() - 1, static_cast<std::size_t>(q * static_cast<double>(ns.size())))]) / 1000.0;
+    };
+    std::printf("%-22s %10zu %10.1f %10.1f %10.1f %10.1f\n", what, ns.size(), at(0.5), at(0.99), at(0.999),
+                static_cast<double>(ns.back()) / 1000.0);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t writers = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 4;
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 5.0;
+    const double hotShare = argc > 3 ? std::atof(argv[3]) : 0.8;
+    // at least one hot and one cold DTC
+    const std::size_t dtcs = static_cast<std::size_t>(std::max(argc > 4 ? std::atoi(argv[4]) : 2000, 2));
+    const std::size_t hot = std::max<std::size_t>(1, dtcs / 100);
+
+    std::vector<event::MonitorId> ids;
+    std::vector<event::MonitorHandle> handles;
+    for (std::size_t i = 0; i < dtcs; ++i) {
+        const dtc::DtcId dtc = kFirstDtc + static_cast<dtc::DtcId>(i);
+        if (dtc::DMDtc::RegisterDtc(dtc, [](dtc::DtcId, dtc::UdsStatusByte, dtc::UdsStatusByte) {
+                thread_lag_samples().Add(t_callStart);
+            }).HasError()) {
+            return 1;
+        }
+        ids.push_back("/ecu/swc_" + std::to_string(i % 31) + "/DiagnosticMonitor_" + std::to_string(i));
+        const auto toDtc = [dtc](const event::MonitorId &, event::QualifiedState state) {
+            if (state == event::QualifiedState::QualifiedFailed) {
+                dtc::DMDtc::ReportDtcStatus(dtc, kTestFailed | kConfirmed);
+            } else if (state == event::QualifiedState::QualifiedPassed) {
+                dtc::DMDtc::ReportDtcStatus(dtc, kConfirmed);
+            }
+        };
+        if (event::DMEvent::RegisterMonitor(ids.back(), event::DebounceConfig{}, toDtc).HasError()) return 1;
+        handles.push_back(*event::DMEvent::GetMonitorHandle(ids.back()));
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> reports{0};
+    std::vector<std::thread> threads;
+    const auto writersStart = Clock::now();
+    for (std::size_t w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            thread_lag_samples();
+            std::uint32_t x = 2463534242u + static_cast<std::uint32_t>(w) * 7919u;
+            const auto next = [&x] {
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                return x;
+            };
+            std::uint64_t n = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 256; ++i, ++n) {
+                    const bool toHot = (next() & 0xffff) < static_cast<std::uint32_t>(hotShare * 65536.0);
+                    const std::size_t m = toHot ? next() % hot : hot + next() % (dtcs - hot);
+                    const bool failed = (next() & 0xff) < (toHot ? 128u : 13u);   // 50% / 5%
+                    t_callStart = Clock::now();
+                    event::DMEvent::ReportPreEvent(handles[m], failed);
+                }
+            }
+            reports.fetch_add(n, std::memory_order_relaxed);
+        });
+    }
+
+    std::vector<std::uint64_t> maskQuery, recordRead, clear;
+    std::thread tester([&] {
+        thread_lag_samples();
+        const auto begin = Clock::now();
+        auto nextMask = begin, nextRecord = begin, nextClear = begin + std::chrono::seconds(1);
+        std::size_t record = 0;
+        std::size_t matched = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            const auto now = Clock::now();
+            if (now >= nextMask) {
+                nextMask += std::chrono::milliseconds(20);
+                const auto start = Clock::now();
+                for (std::size_t i = 0; i < dtcs; ++i) {
+                    const auto status = dtc::DMDtc::GetCurrentStatus(kFirstDtc + static_cast<dtc::DtcId>(i));
+                    if (status.has_value() && (*status & kConfirmed) != 0) ++matched;
+                }
+                maskQuery.push_back(static_cast<std::uint64_t>(std::chrono::nanoseconds(Clock::now() - start).count()));
+            }
+            if (now >= nextRecord) {
+                nextRecord += std::chrono::milliseconds(5);
+                const std::size_t i = record++ % dtcs;
+                const auto start = Clock::now();
+                dtc::DMDtc::GetCurrentStatus(kFirstDtc + static_cast<dtc::DtcId>(i));
+                dtc::DMDtc::GetDtcSuppression(kFirstDtc + static_cast<dtc::DtcId>(i));
+                event::DMEvent::GetEventStatus(ids[i]);
+                recordRead.push_back(static_cast<std::uint64_t>(std::chrono::nanoseconds(Clock::now() - start).count()));
+            }
+            if (now >= nextClear) {
+                nextClear += std::chrono::seconds(1);
+                const auto start = Clock::now();
+                for (std::size_t i = 0; i < dtcs; ++i) {
+                    t_callStart = Clock::now();
+                    dtc::DMDtc::ReportDtcStatus(kFirstDtc + static_cast<dtc::DtcId>(i), 0);
+                }
+                clear.push_back(static_cast<std::uint64_t>(std::chrono::nanoseconds(Clock::now() - start).count()));
+            }
+            std::this_thread::sleep_until(std::min({nextMask, nextRecord, nextClear}));
+        }
+        if (matched == 0) std::printf("(no confirmed DTCs seen by the tester)\n");
+    });
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true);
+    for (auto &t : threads) t.join();
+    const std::chrono::duration<double> elapsed = Clock::now() - writersStart;   // measured, not the requested time
+    tester.join();
+
+    std::vector<std::uint64_t> lag;
+    for (const auto &s : g_lagSamples) lag.insert(lag.end(), s->ns.begin(), s->ns.end());
+
+    std::printf("%zu writer(s), %zu DTCs, %.0f%% of reports to %zu hot DTCs, %.2f s\n", writers, dtcs,
+                hotShare * 100.0, hot, elapsed.count());
+    std::printf("writer throughput      %10.2f Mrep/s\n", static_cast<double>(reports.load()) / elapsed.count() / 1e6);
+    std::printf("%-22s %10s %10s %10s %10s %10s\n", "", "samples", "p50 us", "p99 us", "p999 us", "max us");
+    print_percentiles("tester 0x19 02 mask", maskQuery);
+    print_percentiles("tester 0x19 04 record", recordRead);
+    print_percentiles("tester 0x14 clear", clear);
+    print_percentiles("DTC notifier lag", lag);
+    if (common::LockProfile::Compiled()) common::LockProfile::Dump(stdout);
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * Soak run of time-based debouncing under the virtual clock.
+ *
+ * Usage: virtual_time_bench [monitors] [hours] [toggles per second]
+ *
+ * Registers time-based monitors with the default 12 s thresholds and
+ * simulates the given span one second at a time: each second a
+ * pseudo-random set of monitors flips between pre-failed and pre-passed,
+ * then DmClock::Advance(1s) runs the deadlines that fell due. Nothing
+ * sleeps, so wall time is the cost of reporting plus the scheduler. It is
+ * reported per simulated hour, with the qualifications that happened.
+ */
+#include "common/dm_clock.h"
+#include "event/dm_event.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace diagnostic_manager;
+using namespace std::chrono_literals;
+
+int main(int argc, char **argv) {
+    const std::size_t monitors = argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 100000;
+    const int hours = argc > 2 ? std::atoi(argv[2]) : 24;
+    const std::size_t toggles = argc > 3 ? static_cast<std::size_t>(std::atoll(argv[3])) : 100;
+
+    common::DmClock::UseVirtual();
+    std::atomic<std::uint64_t> failed{0}, passed{0};
+    const event::QualifiedNotifier notifier = [&](const event::MonitorId &, event::QualifiedState s) {
+        if (s == event::QualifiedState::QualifiedFailed) ++failed;
+        if (s == event::QualifiedState::QualifiedPassed) ++passed;
+    };
+    std::vector<std::string> ids;
+    std::vector<event::MonitorRegistration> regs;
+    ids.reserve(monitors);
+    for (std::size_t i = 0; i < monitors; ++i) {
+        ids.push_back("/ecu/swc_" + std::to_string(i % 97) + "/DiagnosticMonitor_" + std::to_string(i));
+    }
+    for (const std::string &id : ids) {
+        event::MonitorRegistration r{id, event::DebounceConfig{}, notifier};
+        r.cfg.mode = event::DebounceMode::TimeBased;
+        regs.push_back(r);
+    }
+    if (event::DMEvent::RegisterMonitors(regs.data(), regs.size()).HasError()) return 1;
+
+    std::vector<event::PreEventUpdate> batch(toggles);
+    std::vector<std::uint8_t> preFailed(monitors, 0);
+    std::uint32_t x = 2463534242u;
+    std::printf("%zu monitors, %zu toggles/s, %d h simulated\n", monitors, toggles, hours);
+    std::printf("%-5s %10s %12s %12s\n", "hour", "wall ms", "failed", "passed");
+    const auto start = std::chrono::steady_clock::now();
+    auto hourStart = start;
+    for (int h = 1; h <= hours; ++h) {
+        for (int s = 0; s < 3600; ++s) {
+            for (std::size_t t = 0; t < toggles; ++t) {
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                const std::size_t m = x % monitors;
+                preFailed[m] ^= 1;
+                batch[t] = event::PreEventUpdate{&ids[m], preFailed[m] != 0};
+            }
+            event::DMEvent::ReportPreEvents(batch.data(), batch.size());
+            common::DmClock::Advance(1s);
+        }
+        const auto now = std::chrono::steady_clock::now();
+        std::printf("%-5d %10.1f %12llu %12llu\n", h, std::chrono::duration<double, std::milli>(now - hourStart).count(),
+                    static_cast<unsigned long long>(failed.load()), static_cast<unsigned long long>(passed.load()));
+        hourStart = now;
+    }
+    std::printf("total %.2f s wall for %d h\n",
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), hours);
+    return 0;
+}
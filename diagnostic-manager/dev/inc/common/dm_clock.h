@@ -0,0 +1,60 @@
+/*
+ * Diagnostic Manager - Time source
+ * Everything time-dependent in the DM (time-based debouncing, status
+ * coalescing, the executor's timed tasks) reads DmClock::Now(). By default
+ * that is steady_clock. A virtual clock only moves when advanced, and only
+ * Advance runs timed work then: on the calling thread, in deadline order.
+ * That makes long time-based scenarios deterministic and as fast as the
+ * work they cause.
+ *
+ * Switch clocks only while no time-based monitor is armed and no timed
+ * task is queued; the real clock does not continue from virtual time.
+ * Users of absolute time points (the debounce timer wheel) compare
+ * Generation() and re-origin when the source changed.
+ */
+#ifndef DM_CLOCK_H
+#define DM_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "ara/core/result_future.h"
+
+namespace diagnostic_manager {
+namespace common {
+
+class DmClock {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static Clock::time_point Now() noexcept {
+        if (!virtual_.load(std::memory_order_acquire)) return Clock::now();
+        return Clock::time_point(Clock::duration(virtualNow_.load(std::memory_order_acquire)));
+    }
+
+    static bool IsVirtual() noexcept { return virtual_.load(std::memory_order_acquire); }
+
+    // Bumped by every UseVirtual/UseReal.
+    static std::uint64_t Generation() noexcept { return generation_.load(std::memory_order_acquire); }
+
+    // Freeze time at `start` (by default the current real time) until advanced.
+    static void UseVirtual(Clock::time_point start = Clock::now());
+
+    static void UseReal();
+
+    // Move virtual time forward by `d`. Each executor task that falls due on
+    // the way runs on this thread with Now() at its deadline, including tasks
+    // those post. operation_not_permitted on the real clock, invalid_argument
+    // for a negative duration. Not reentrant: must not be called from a task.
+    static ara::core::Result<void> Advance(Clock::duration d);
+
+private:
+    static std::atomic<bool> virtual_;
+    static std::atomic<Clock::rep> virtualNow_;
+    static std::atomic<std::uint64_t> generation_;
+};
+
+} // namespace common
+} // namespace diagnostic_manager
+
+#endif // DM_CLOCK_H
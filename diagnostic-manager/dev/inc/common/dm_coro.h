@@ -0,0 +1,226 @@
+/*
+ * Diagnostic Manager - Coroutine interface
+ * Awaitables over DMEvent, DMDtc, DMOperationCycle and the executor for
+ * C++20 coroutines. A waiting coroutine is linked into its monitor, DTC or
+ * operation cycle through a node in its own frame, so any number of
+ * outstanding waits block no thread and allocate nothing. The coroutine is
+ * resumed through a caller-supplied scheduler: any copyable type with
+ * `void Schedule(std::coroutine_handle<>)`.
+ *
+ *     auto state = co_await NextQualifiedState(id, LaneScheduler{});
+ *     auto status = co_await DtcStatusMatching(0x1234, 0x01);
+ *     auto active = co_await NextOperationCycleState("PowerCycle");
+ *     auto cleared = co_await ClearDtc(0x1234, appScheduler);
+ *
+ * Empty unless the compiler supports coroutines (-std=c++20).
+ */
+#ifndef DM_CORO_H
+#define DM_CORO_H
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <optional>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include "ara/core/result_future.h"
+#include "common/dm_executor.h"
+#include "dtc/dm_dtc.h"
+#include "event/dm_event.h"
+#include "operationcycle/dm_operation_cycle.h"
+
+namespace diagnostic_manager {
+namespace common {
+
+// Resume on the thread that completes the wait (e.g. the one reporting the
+// pre-event); the coroutine should hand off quickly.
+struct InlineScheduler {
+    void Schedule(std::coroutine_handle<> h) const { h.resume(); }
+};
+
+// Resume on an executor lane; inline if the executor cannot be started.
+struct LaneScheduler {
+    TaskLane lane{TaskLane::Latency};
+    void Schedule(std::coroutine_handle<> h) const {
+        if (Executor::Post(lane, [h] { h.resume(); }).HasError()) h.resume();
+    }
+};
+
+// co_await: the next qualified state of a monitor, once it changes.
+// no_such_file_or_directory if the monitor is unknown or unregistered
+// while waiting. `id` is only read before suspending.
+template <typename Scheduler = InlineScheduler>
+class NextQualifiedState : private event::QualifiedStateWaiter {
+public:
+    explicit NextQualifiedState(const event::MonitorId &id, Scheduler scheduler = Scheduler{})
+        : id_(id), scheduler_(std::move(scheduler)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> h) {
+        handle_ = h;
+        fire = &Resume;
+        auto added = event::DMEvent::AddQualifiedStateWaiter(id_, *this);
+        if (added.HasValue()) return true;   // may be resumed already: `this` is off limits
+        error_ = added.Error();
+        return false;
+    }
+
+    ara::core::Result<event::QualifiedState> await_resume() const {
+        using R = ara::core::Result<event::QualifiedState>;
+        if (error_) return R{ error_ };
+        if (unregistered) return R{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        return R{ state };
+    }
+
+private:
+    static void Resume(event::QualifiedStateWaiter &waiter) {
+        auto &self = static_cast<NextQualifiedState &>(waiter);
+        const Scheduler scheduler = self.scheduler_;   // the awaiter dies with the resumed frame
+        scheduler.Schedule(self.handle_);
+    }
+
+    const event::MonitorId &id_;
+    Scheduler scheduler_;
+    std::coroutine_handle<> handle_;
+    std::error_code error_;
+};
+
+// co_await: the status of a DTC, once any bit of `mask` is set (at once if
+// it is already). no_such_file_or_directory if the DTC is unknown or
+// unregistered while waiting, invalid_argument for an empty mask.
+template <typename Scheduler = InlineScheduler>
+class DtcStatusMatching : private dtc::DtcStatusWaiter {
+public:
+    DtcStatusMatching(dtc::DtcId dtc, dtc::UdsStatusByte statusMask, Scheduler scheduler = Scheduler{})
+        : dtc_(dtc), scheduler_(std::move(scheduler)) {
+        mask = statusMask;
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> h) {
+        handle_ = h;
+        fire = &Resume;
+        auto added = dtc::DMDtc::AddStatusWaiter(dtc_, *this);
+        if (added.HasValue()) return true;   // may be resumed already: `this` is off limits
+        error_ = added.Error();
+        return false;
+    }
+
+    ara::core::Result<dtc::UdsStatusByte> await_resume() const {
+        using R = ara::core::Result<dtc::UdsStatusByte>;
+        if (error_) return R{ error_ };
+        if (unregistered) return R{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        return R{ status };
+    }
+
+private:
+    static void Resume(dtc::DtcStatusWaiter &waiter) {
+        auto &self = static_cast<DtcStatusMatching &>(waiter);
+        const Scheduler scheduler = self.scheduler_;
+        scheduler.Schedule(self.handle_);
+    }
+
+    dtc::DtcId dtc_;
+    Scheduler scheduler_;
+    std::coroutine_handle<> handle_;
+    std::error_code error_;
+};
+
+// co_await: the state of an operation cycle, once it changes.
+// no_such_file_or_directory if the cycle is unknown or unregistered while
+// waiting. `id` is only read before suspending.
+template <typename Scheduler = InlineScheduler>
+class NextOperationCycleState : private operation_cycle::OpCycleStateWaiter {
+public:
+    explicit NextOperationCycleState(const operation_cycle::OpCycleId &id, Scheduler scheduler = Scheduler{})
+        : id_(id), scheduler_(std::move(scheduler)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> h) {
+        handle_ = h;
+        fire = &Resume;
+        auto added = operation_cycle::DMOperationCycle::AddStateWaiter(id_, *this);
+        if (added.HasValue()) return true;   // may be resumed already: `this` is off limits
+        error_ = added.Error();
+        return false;
+    }
+
+    ara::core::Result<bool> await_resume() const {
+        using R = ara::core::Result<bool>;
+        if (error_) return R{ error_ };
+        if (unregistered) return R{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        return R{ active };
+    }
+
+private:
+    static void Resume(operation_cycle::OpCycleStateWaiter &waiter) {
+        auto &self = static_cast<NextOperationCycleState &>(waiter);
+        const Scheduler scheduler = self.scheduler_;
+        scheduler.Schedule(self.handle_);
+    }
+
+    const operation_cycle::OpCycleId &id_;
+    Scheduler scheduler_;
+    std::coroutine_handle<> handle_;
+    std::error_code error_;
+};
+
+// co_await: run `f` on an executor lane and resume through the scheduler
+// with its result. Runs `f` inline if the executor cannot be started.
+template <typename F, typename Scheduler>
+class RunOnLane {
+public:
+    using ResultType = std::invoke_result_t<F &>;
+    static_assert(!std::is_void_v<ResultType>, "the operation must return its result");
+
+    RunOnLane(TaskLane lane, F f, Scheduler scheduler)
+        : lane_(lane), f_(std::move(f)), scheduler_(std::move(scheduler)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> h) {
+        handle_ = h;
+        // captures only `this`: fits the task's small-object buffer
+        if (Executor::Post(lane_, [this] { Complete(); }).HasValue()) return true;
+        result_.emplace(f_());
+        return false;
+    }
+
+    ResultType await_resume() { return std::move(*result_); }
+
+private:
+    void Complete() {
+        result_.emplace(f_());
+        const Scheduler scheduler = scheduler_;
+        scheduler.Schedule(handle_);
+    }
+
+    TaskLane lane_;
+    F f_;
+    Scheduler scheduler_;
+    std::coroutine_handle<> handle_;
+    std::optional<ResultType> result_;
+};
+
+template <typename F, typename Scheduler = InlineScheduler>
+RunOnLane<F, Scheduler> RunOn(TaskLane lane, F f, Scheduler scheduler = Scheduler{}) {
+    return RunOnLane<F, Scheduler>(lane, std::move(f), std::move(scheduler));
+}
+
+// co_await: reset the status byte of a DTC on the bulk lane. Status waiters
+// and the DTC's notifier run there as well.
+template <typename Scheduler = InlineScheduler>
+auto ClearDtc(dtc::DtcId dtc, Scheduler scheduler = Scheduler{}) {
+    return RunOn(TaskLane::Bulk, [dtc] { return dtc::DMDtc::ReportDtcStatus(dtc, 0); }, std::move(scheduler));
+}
+
+} // namespace common
+} // namespace diagnostic_manager
+
+#endif // __cpp_impl_coroutine
+
+#endif // DM_CORO_H
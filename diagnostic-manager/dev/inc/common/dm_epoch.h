@@ -0,0 +1,82 @@
+/*
+ * Diagnostic Manager - Epoch-based reclamation
+ * For objects that are replaced under a lock but used after unlocking, such
+ * as notifiers. A reader pins the epoch (EpochGuard) before it loads the
+ * pointer and keeps the pin until it is done with the object; a replaced
+ * object is retired and deleted once no pin that might still reach it is
+ * left. A pin is one increment on a per-thread stripe; retiring never waits
+ * for readers, so a notifier may replace or unregister itself.
+ */
+#ifndef DM_EPOCH_H
+#define DM_EPOCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace diagnostic_manager {
+namespace common {
+
+class Epoch {
+public:
+    // Delete `object` with `destroy` once no pin taken before this call is
+    // left. Call after the object was unpublished.
+    static void Retire(void *object, void (*destroy)(void *));
+
+    template <typename T>
+    static void Retire(const T *object) {
+        if (object != nullptr) Retire(const_cast<T *>(object), [](void *p) { delete static_cast<T *>(p); });
+    }
+
+    // Delete what can be deleted now; retiring does this as well.
+    static void Reclaim();
+
+    // Retired objects not deleted yet.
+    static std::size_t Pending();
+};
+
+// Pins the current epoch for its lifetime; may be nested.
+class EpochGuard {
+public:
+    EpochGuard() noexcept;
+    ~EpochGuard();
+    EpochGuard(const EpochGuard &) = delete;
+    EpochGuard &operator=(const EpochGuard &) = delete;
+
+private:
+    std::atomic<std::uint64_t> *pin_;
+};
+
+// Owning pointer whose object is retired rather than deleted when it is
+// replaced or the slot goes away. Get, Reset and destruction are guarded by
+// the owner's lock; the object returned by Get stays valid for as long as
+// an EpochGuard taken before the Get is held.
+template <typename T>
+class EpochSlot {
+public:
+    EpochSlot() = default;
+    EpochSlot(EpochSlot &&other) noexcept : object_(std::exchange(other.object_, nullptr)) {}
+    EpochSlot &operator=(EpochSlot &&other) noexcept {
+        Reset(std::unique_ptr<T>(std::exchange(other.object_, nullptr)));
+        return *this;
+    }
+    ~EpochSlot() { Epoch::Retire(object_); }
+
+    const T *Get() const noexcept { return object_; }
+
+    void Reset(std::unique_ptr<T> object = nullptr) {
+        const T *old = object_;
+        object_ = object.release();
+        Epoch::Retire(old);
+    }
+
+private:
+    T *object_{nullptr};
+};
+
+} // namespace common
+} // namespace diagnostic_manager
+
+#endif // DM_EPOCH_H
@@ -0,0 +1,92 @@
+/*
+ * Diagnostic Manager - Executor for background work
+ * Runs DM background tasks (time-based debounce expiry, deferred
+ * notification delivery) on named worker threads. Work is split into two
+ * lanes with separate queues and workers, so latency-critical tasks never
+ * wait behind bulk ones. Each worker can be pinned to a CPU and given a
+ * SCHED_FIFO priority or a nice value.
+ *
+ * Workers start on the first Start/Post; Configure must happen before that.
+ * Deadlines are on DmClock; under a virtual clock timed tasks run only from
+ * DmClock::Advance.
+ */
+#ifndef DM_EXECUTOR_H
+#define DM_EXECUTOR_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "ara/core/result_future.h"
+
+namespace diagnostic_manager {
+namespace common {
+
+enum class TaskLane : std::uint8_t {
+    Latency = 0,   // debounce deadlines, qualification results
+    Bulk = 1,      // coalesced status notifications and other deferrable work
+};
+
+struct WorkerOptions {
+    int cpu{-1};            // pin to this CPU; -1: no pinning
+    int fifoPriority{0};    // 1..99: SCHED_FIFO at this priority; 0: SCHED_OTHER
+    int nice{0};            // nice value under SCHED_OTHER
+};
+
+// Name the calling thread ("<name>", cut to 15 characters) and apply `opt`
+// to it. Used for the executor's workers and other DM-owned threads.
+std::error_code ApplyWorkerOptions(const std::string &name, const WorkerOptions &opt);
+
+struct LaneConfig {
+    std::size_t workers{1};
+    std::string name;                     // thread name prefix, "<name>-<i>" (15 chars max)
+    std::vector<WorkerOptions> options;   // per worker; missing entries use the defaults
+};
+
+struct ExecutorConfig {
+    LaneConfig latency{1, "dm-latency", {}};
+    LaneConfig bulk{1, "dm-bulk", {}};
+};
+
+class Executor {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Task = std::function<void()>;
+
+    // Set worker counts and thread options. device_or_resource_busy while
+    // running, invalid_argument for zero workers or a priority above 99.
+    static ara::core::Result<void> Configure(const ExecutorConfig &cfg);
+
+    // Start the workers if not running. Fails with the error of the first
+    // worker option that could not be applied (e.g. operation_not_permitted
+    // for SCHED_FIFO without privileges); no worker is left running then.
+    static ara::core::Result<void> Start();
+
+    // Queue `task` on `lane`, starting the workers if needed.
+    static ara::core::Result<void> Post(TaskLane lane, Task task);
+
+    // Queue `task` to run on `lane` no earlier than `when` (DmClock time).
+    static ara::core::Result<void> PostAt(TaskLane lane, Clock::time_point when, Task task);
+
+    // For DmClock::Advance: remove the earliest timed task of all lanes due
+    // at or before `until`. Returns false if there is none.
+    static bool TakeDueTask(Clock::time_point until, Clock::time_point &when, Task &task);
+
+    // Stop and join all workers and drop queued tasks. Must not be called
+    // from a task. Start/Post afterwards start a fresh set of workers.
+    static void Shutdown();
+
+    static bool Running() noexcept;
+
+    // Incremented by every Shutdown: tasks queued in an earlier epoch were
+    // dropped and will not run.
+    static std::uint64_t Epoch() noexcept;
+};
+
+} // namespace common
+} // namespace diagnostic_manager
+
+#endif // DM_EXECUTOR_H
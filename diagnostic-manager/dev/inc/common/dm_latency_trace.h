@@ -0,0 +1,125 @@
+/*
+ * Diagnostic Manager - End-to-end latency tracing
+ * Follows a report from the application to the DTC status notifier:
+ *
+ *   reported   ara-diag Monitor::ReportMonitorAction (ReportRecord timestamp),
+ *              or the DMEvent call for reporters without a timestamp
+ *   dispatched the DMEvent call applying it is entered
+ *   qualified  its debounce step changed the qualified state (under the lock)
+ *   notified   the monitor's qualified notifier is called
+ *   applied    a DTC status reported from that notifier is stored
+ *   delivered  the DTC status notifier is called
+ *
+ * Every traced report records Transport; the following stages are recorded
+ * only along the path a report actually takes, so a report that does not
+ * qualify ends after Transport. Qualifications from debounce deadlines and
+ * deferred (over-budget) pre-states carry no report and are not traced.
+ *
+ * Disabled by default; while disabled a report costs one relaxed load per
+ * DMEvent call. Times are CLOCK_MONOTONIC nanoseconds, the clock of
+ * ara::diag::ipc::ReportRecord::timestampNs.
+ */
+#ifndef DM_LATENCY_TRACE_H
+#define DM_LATENCY_TRACE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace diagnostic_manager {
+namespace common {
+
+enum class TraceStage : std::uint8_t {
+    Transport = 0,   // reported -> dispatched
+    Debounce,        // dispatched -> qualified, including the wait for the lock
+    Notify,          // qualified -> notified, behind earlier notifications of the call
+    DtcUpdate,       // notified -> applied
+    DtcNotify,       // applied -> delivered
+    EndToEnd         // reported -> delivered
+};
+
+constexpr std::size_t kTraceStages = 6;
+
+// Log-linear buckets: exact below 8 ns, then 8 per power of two (<= 12.5%
+// relative error).
+constexpr std::size_t kLatencyBuckets = 496;
+
+struct LatencyHistogram {
+    std::uint64_t count{0};
+    std::uint64_t sumNs{0};
+    std::uint64_t maxNs{0};
+    std::array<std::uint64_t, kLatencyBuckets> buckets{};
+
+    // Upper bound of the bucket holding the q-quantile (0 <= q <= 1),
+    // capped at maxNs; 0 without samples.
+    std::uint64_t PercentileNs(double q) const noexcept;
+    std::uint64_t MeanNs() const noexcept { return count == 0 ? 0 : sumNs / count; }
+
+    static std::size_t BucketOf(std::uint64_t ns) noexcept;
+    static std::uint64_t BucketUpperNs(std::size_t bucket) noexcept;
+};
+
+// LatencyHistogram filled concurrently with relaxed atomics; a Load taken
+// while samples are added may count some of them in some fields only.
+class AtomicLatencyHistogram {
+public:
+    void Add(std::uint64_t ns) noexcept;
+    LatencyHistogram Load() const noexcept;
+    void Clear() noexcept;
+
+private:
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sumNs_{0};
+    std::atomic<std::uint64_t> maxNs_{0};
+    std::atomic<std::uint64_t> buckets_[kLatencyBuckets]{};
+};
+
+struct LatencyTraceStatistics {
+    LatencyHistogram stages[kTraceStages];
+
+    const LatencyHistogram &operator[](TraceStage s) const { return stages[static_cast<std::size_t>(s)]; }
+};
+
+// Timestamps of the report whose qualified notifier runs on this thread.
+struct TraceContext {
+    std::uint64_t reportedNs;
+    std::uint64_t notifiedNs;
+};
+
+class LatencyTrace {
+public:
+    static void Enable(bool on) noexcept { enabled_.store(on, std::memory_order_relaxed); }
+    static bool Enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    static std::uint64_t NowNs() noexcept;
+
+    // Add one sample of `stage`; a negative span counts as 0.
+    static void Record(TraceStage stage, std::uint64_t fromNs, std::uint64_t toNs) noexcept;
+
+    static LatencyTraceStatistics GetStatistics();
+    static void Reset();
+
+    // Context of the qualified notifier running on this thread, or nullptr.
+    static const TraceContext *Current() noexcept;
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+// Makes `ctx` current for the enclosing scope (around a qualified notifier).
+class TraceContextScope {
+public:
+    explicit TraceContextScope(const TraceContext *ctx) noexcept;
+    ~TraceContextScope();
+    TraceContextScope(const TraceContextScope &) = delete;
+    TraceContextScope &operator=(const TraceContextScope &) = delete;
+
+private:
+    const TraceContext *previous_;
+};
+
+} // namespace common
+} // namespace diagnostic_manager
+
+#endif // DM_LATENCY_TRACE_H
@@ -0,0 +1,124 @@
+/*
+ * Diagnostic Manager - Lock contention profiling
+ * The registry mutexes of DMEvent, DMDtc and DMOperationCycle are
+ * ProfiledMutex. Built with -DDM_LOCK_PROFILE=ON, every acquisition is
+ * recorded per lock name: acquisitions, contended acquisitions (the lock
+ * was held when asked for), wait and hold time histograms, and per call
+ * site (the function taking the lock) counts and total wait and hold time.
+ * Otherwise ProfiledMutex is a plain std::mutex and nothing is recorded.
+ *
+ * Instances with the same name share their statistics. The diagnostic-manager
+ * binary writes the dump on SIGUSR1 and at exit to $DM_LOCK_PROFILE_OUT (a
+ * path, "-" for stderr).
+ */
+#ifndef DM_LOCK_PROFILE_H
+#define DM_LOCK_PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ara/core/result_future.h"
+#include "common/dm_latency_trace.h"
+
+namespace diagnostic_manager {
+namespace common {
+
+constexpr const char *kLockProfileOutEnv = "DM_LOCK_PROFILE_OUT";
+constexpr std::size_t kMaxLockSites = 16;   // per lock name; more are counted under "(other)"
+
+struct LockSiteStatistics {
+    const char *site{nullptr};     // function name
+    std::uint64_t acquisitions{0};
+    std::uint64_t contended{0};
+    std::uint64_t waitNs{0};       // total
+    std::uint64_t holdNs{0};       // total
+};
+
+struct LockStatistics {
+    const char *name{nullptr};
+    std::uint64_t acquisitions{0};
+    std::uint64_t contended{0};
+    LatencyHistogram wait;         // 0 for uncontended acquisitions
+    LatencyHistogram hold;
+    std::vector<LockSiteStatistics> sites;   // by total wait, then total hold, descending
+};
+
+class LockProfile {
+public:
+    static constexpr bool Compiled() noexcept {
+#if defined(DM_LOCK_PROFILE)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Locks taken so far, by total wait time, descending; empty unless compiled in.
+    static std::vector<LockStatistics> GetStatistics();
+
+    // Zero all counters; acquisitions made meanwhile may be partly lost.
+    static void Reset();
+
+    // Human-readable table of all locks with their `topSites` worst call sites.
+    static void Dump(std::FILE *out, std::size_t topSites = 5);
+
+    // Dump appended to `path` ("-": stderr); the error of fopen otherwise.
+    static ara::core::Result<void> DumpToFile(const std::string &path, std::size_t topSites = 5);
+};
+
+#if defined(DM_LOCK_PROFILE)
+
+struct LockClass;   // statistics of one lock name
+
+// Lockable like std::mutex; the call site defaults to the calling function.
+class ProfiledMutex {
+public:
+    explicit constexpr ProfiledMutex(const char *name) noexcept : name_(name) {}
+    ProfiledMutex(const ProfiledMutex &) = delete;
+    ProfiledMutex &operator=(const ProfiledMutex &) = delete;
+
+    void lock(const char *site = __builtin_FUNCTION());
+    bool try_lock(const char *site = __builtin_FUNCTION());
+    void unlock();
+
+private:
+    void Acquired(const char *site, std::uint64_t waitNs, bool contended);
+
+    std::mutex mutex_;
+    const char *name_;
+    // written by the owner only
+    LockClass *class_{nullptr};
+    void *site_{nullptr};
+    std::uint64_t acquiredNs_{0};
+};
+
+// std::lock_guard recording the function that constructs it as call site.
+class ProfiledLockGuard {
+public:
+    explicit ProfiledLockGuard(ProfiledMutex &m, const char *site = __builtin_FUNCTION()) : m_(m) { m_.lock(site); }
+    ~ProfiledLockGuard() { m_.unlock(); }
+    ProfiledLockGuard(const ProfiledLockGuard &) = delete;
+    ProfiledLockGuard &operator=(const ProfiledLockGuard &) = delete;
+
+private:
+    ProfiledMutex &m_;
+};
+
+#else
+
+class ProfiledMutex : public std::mutex {
+public:
+    explicit constexpr ProfiledMutex(const char *) noexcept {}
+};
+
+using ProfiledLockGuard = std::lock_guard<ProfiledMutex>;
+
+#endif
+
+} // namespace common
+} // namespace diagnostic_manager
+
+#endif // DM_LOCK_PROFILE_H
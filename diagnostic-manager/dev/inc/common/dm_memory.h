@@ -0,0 +1,189 @@
+/*
+ * Diagnostic Manager - Memory resources
+ * The DM's registries and scratch buffers allocate from one std::pmr
+ * resource: fixed-size pools carved from a monotonic arena reserved up
+ * front. Freed blocks go back to their pool, so once startup has
+ * registered everything, steady-state operation takes no memory from the
+ * heap. The heap is only used when the arena is exhausted; after
+ * Initialize() every such allocation is counted and, in strict mode,
+ * aborts the process.
+ *
+ * Strict mode is enabled by setting $DM_NO_HEAP_AFTER_INIT for the binary.
+ *
+ * Every subsystem allocates through a resource of its own that counts the
+ * bytes it holds; storage kept outside the resources (notifier callables,
+ * ingestion queues) is reported with DmMemory::Track. An
+ * allocation hook sees each allocation with the DM API call that made it.
+ */
+#ifndef DM_MEMORY_H
+#define DM_MEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <utility>
+#include "ara/core/result_future.h"
+
+namespace diagnostic_manager {
+namespace common {
+
+constexpr const char *kNoHeapAfterInitEnv = "DM_NO_HEAP_AFTER_INIT";
+
+enum class MemorySubsystem : std::uint8_t {
+    Monitors = 0,      // monitor records, name lookup, debounce state, handles
+    Dtcs,
+    OperationCycles,
+    Notifiers,         // notifier objects of monitors, DTCs and operation cycles
+    Queues,            // executor lanes, timers, ingestion queues, state streams
+    Other
+};
+constexpr std::size_t kMemorySubsystems = 6;
+
+struct SubsystemMemory {
+    std::size_t bytes{0};           // currently held
+    std::size_t objects{0};         // registered entities, notifiers or queues
+    std::uint64_t allocations{0};   // since start
+};
+
+struct MemoryStatistics {
+    SubsystemMemory subsystems[kMemorySubsystems];
+    std::size_t arenaBytes{0};             // reserved up front
+    std::uint64_t heapAllocations{0};      // blocks taken from the heap once the arena was exhausted
+    std::size_t heapBytes{0};
+
+    const SubsystemMemory &operator[](MemorySubsystem s) const noexcept {
+        return subsystems[static_cast<std::size_t>(s)];
+    }
+};
+
+// One allocation seen by the hook. `call` is the outermost DM API call
+// running on the allocating thread, or nullptr outside of one.
+struct AllocationEvent {
+    MemorySubsystem subsystem;
+    std::size_t bytes;
+    const char *call;
+};
+
+using AllocationHook = void (*)(const AllocationEvent &event, void *context);
+
+struct MemoryConfig {
+    std::size_t arenaBytes{1u << 20};         // reserved at the first allocation
+    std::size_t largestPooledBlock{4096};     // larger blocks come from the arena directly and are not reused
+    std::size_t maxBlocksPerChunk{256};
+    bool abortOnHeapAfterInit{false};         // strict mode
+};
+
+class DmMemory {
+public:
+    // Set the arena and pool sizes. device_or_resource_busy once the
+    // resource has allocated.
+    static ara::core::Result<void> Configure(const MemoryConfig &cfg);
+
+    // The resource of all DM containers; usable during static
+    // initialisation (the pools are created at the first allocation).
+    static std::pmr::memory_resource *Resource() noexcept;   // MemorySubsystem::Other
+    static std::pmr::memory_resource *Resource(MemorySubsystem subsystem) noexcept;
+
+    // Account storage a subsystem holds outside its resource; negative
+    // deltas release it.
+    static void Track(MemorySubsystem subsystem, std::ptrdiff_t objects, std::ptrdiff_t bytes = 0) noexcept;
+
+    static MemoryStatistics GetMemoryStatistics() noexcept;
+
+    // Call `hook` for every allocation from the DM resources (nullptr
+    // removes it). For tests and benchmarks; not while DM calls run.
+    static void SetAllocationHook(AllocationHook hook, void *context = nullptr) noexcept;
+
+    // End of startup: heap use from now on is counted (and aborts in
+    // strict mode).
+    static void Initialize();
+    static bool Initialized() noexcept;
+
+    // Heap allocations made by the resource after Initialize().
+    static std::uint64_t HeapAllocationsAfterInit() noexcept;
+};
+
+// Names the DM API call running on this thread for allocation
+// attribution; nested scopes keep the outermost name.
+class ApiCallScope {
+public:
+    explicit ApiCallScope(const char *call) noexcept : outer_(current_) {
+        if (outer_ == nullptr) current_ = call;
+    }
+    ~ApiCallScope() { current_ = outer_; }
+    ApiCallScope(const ApiCallScope &) = delete;
+    ApiCallScope &operator=(const ApiCallScope &) = delete;
+
+    static const char *Current() noexcept { return current_; }
+
+private:
+    static inline thread_local const char *current_{nullptr};
+    const char *outer_;
+};
+
+// Memory held by one registry, estimated from container capacities (pool
+// rounding not included).
+struct MemoryFootprint {
+    std::size_t entities{0};
+    std::size_t hotBytes{0};        // records read on every report
+    std::size_t coldBytes{0};       // side tables: names, notifiers, waiters, coalescing
+    std::size_t indexBytes{0};      // lookup structures: hash tables, handle slots
+    std::size_t debounceBytes{0};   // per-policy debounce parameters and state
+
+    std::size_t Total() const noexcept { return hotBytes + coldBytes + indexBytes + debounceBytes; }
+    double BytesPerEntity() const noexcept {
+        return entities == 0 ? 0.0 : static_cast<double>(Total()) / static_cast<double>(entities);
+    }
+};
+
+// Bucket array plus nodes of a std::unordered_map, assuming the libstdc++
+// node layout (next pointer, value, cached hash).
+template <typename Map>
+std::size_t UnorderedMapBytes(const Map &map) noexcept {
+    constexpr std::size_t node = sizeof(void *) + sizeof(typename Map::value_type) + sizeof(std::size_t);
+    return map.bucket_count() * sizeof(void *) + map.size() * node;
+}
+
+// Insert `name` into a map keyed by std::string_view whose mapped type
+// keeps its own copy of the name in a std::pmr::string `name`; the key
+// views that copy. Lookups by name then need no temporary string.
+template <typename Map>
+std::pair<typename Map::iterator, bool> EmplaceNamed(Map &map, std::string_view name) {
+    auto res = map.try_emplace(name);
+    if (!res.second) return res;
+    auto node = map.extract(res.first);   // node (and mapped value) keep their address
+    node.mapped().name.assign(name.data(), name.size());
+    node.key() = node.mapped().name;
+    return {map.insert(std::move(node)).position, true};
+}
+
+// Owner of one object allocated from a DM resource by AllocateUnique.
+template <typename T>
+struct ResourceDelete {
+    std::pmr::memory_resource *resource{nullptr};
+    void operator()(T *p) const noexcept {
+        p->~T();
+        resource->deallocate(p, sizeof(T), alignof(T));
+    }
+};
+template <typename T>
+using ResourcePtr = std::unique_ptr<T, ResourceDelete<T>>;
+
+template <typename T, typename... Args>
+ResourcePtr<T> AllocateUnique(std::pmr::memory_resource *resource, Args &&...args) {
+    void *p = resource->allocate(sizeof(T), alignof(T));
+    try {
+        return ResourcePtr<T>(::new (p) T(std::forward<Args>(args)...), ResourceDelete<T>{resource});
+    } catch (...) {
+        resource->deallocate(p, sizeof(T), alignof(T));
+        throw;
+    }
+}
+
+} // namespace common
+} // namespace diagnostic_manager
+
+#endif // DM_MEMORY_H
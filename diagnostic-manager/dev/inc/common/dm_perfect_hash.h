@@ -0,0 +1,107 @@
+/*
+ * Diagnostic Manager - Minimal perfect hash over a fixed set of names
+ * CHD-style hash-and-displace: keys are grouped into small buckets, and each
+ * bucket gets one displacement that places all of its keys into distinct
+ * slots of a table with exactly one slot per key. The index is the seed and
+ * the displacements (about one byte per key); it keeps no copy of the keys.
+ * A lookup is one string hash and one displacement read. The caller keeps
+ * its entries by slot and rejects an unknown name with a single compare
+ * against the name of the entry in its slot. Used for its size rather than
+ * its speed: lookups cost about as much as in a std::unordered_map.
+ *
+ * Built once (e.g. over the InstanceSpecifier names registered at startup)
+ * and immutable afterwards, so concurrent Slot calls are safe.
+ */
+#ifndef DM_PERFECT_HASH_H
+#define DM_PERFECT_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+#include "ara/core/result_future.h"
+#include "common/dm_memory.h"
+
+namespace diagnostic_manager {
+namespace common {
+
+class PerfectHash {
+public:
+    // Empty; its table (and that of a built index assigned to it) is
+    // allocated from `resource`.
+    explicit PerfectHash(std::pmr::memory_resource *resource = DmMemory::Resource()) : displacements_(resource) {}
+
+    // Build over distinct keys, which need not outlive the index.
+    // invalid_argument on a duplicate key. Expected O(n).
+    static ara::core::Result<PerfectHash> Build(const std::string_view *keys, std::size_t count,
+                                                std::pmr::memory_resource *resource = DmMemory::Resource());
+    static ara::core::Result<PerfectHash> Build(const std::vector<std::string_view> &keys) {
+        return Build(keys.data(), keys.size());
+    }
+
+    // Slot in [0, Size()) of a build key, distinct for each of them. Any
+    // other key is mapped to one of those slots as well. Size() > 0.
+    std::uint32_t Slot(std::string_view key) const noexcept {
+        const std::uint64_t h = Hash(key, seed_);
+        const std::uint32_t d = displacements_[Range(static_cast<std::uint32_t>(h >> 32), displacements_.size())];
+        return (d & kDirect) != 0 ? d & ~kDirect : Position(h, d, size_);
+    }
+
+    std::size_t Size() const noexcept { return size_; }
+
+    std::size_t MemoryBytes() const noexcept { return displacements_.capacity() * sizeof(std::uint32_t); }
+
+    // MurmurHash64A.
+    static std::uint64_t Hash(std::string_view key, std::uint64_t seed) noexcept {
+        constexpr std::uint64_t m = 0xc6a4a7935bd1e995ull;
+        const char *p = key.data();
+        std::size_t n = key.size();
+        std::uint64_t h = seed ^ (n * m);
+        for (; n >= 8; p += 8, n -= 8) {
+            std::uint64_t k;
+            std::memcpy(&k, p, 8);
+            k *= m;
+            k ^= k >> 47;
+            k *= m;
+            h ^= k;
+            h *= m;
+        }
+        if (n != 0) {
+            std::uint64_t k = 0;
+            std::memcpy(&k, p, n);
+            h ^= k;
+            h *= m;
+        }
+        h ^= h >> 47;
+        h *= m;
+        h ^= h >> 47;
+        return h;
+    }
+
+private:
+    // A bucket of one key stores its slot instead of a displacement.
+    static constexpr std::uint32_t kDirect = 0x80000000u;
+
+    // Slot of a key with displacement d: the key hash mixed with d, mapped
+    // onto [0, n) by multiply-shift, so a lookup needs no division.
+    static std::uint32_t Range(std::uint32_t x, std::size_t n) noexcept {
+        return static_cast<std::uint32_t>((static_cast<std::uint64_t>(x) * n) >> 32);
+    }
+    static std::uint32_t Position(std::uint64_t h, std::uint32_t d, std::size_t n) noexcept {
+        std::uint64_t x = h ^ (static_cast<std::uint64_t>(d) * 0x9e3779b97f4a7c15ull);
+        x ^= x >> 31;
+        x *= 0xd6e8feb86659fd93ull;
+        return Range(static_cast<std::uint32_t>(x >> 32), n);
+    }
+
+    std::uint64_t seed_{0};
+    std::size_t size_{0};
+    std::pmr::vector<std::uint32_t> displacements_;  // per bucket
+};
+
+} // namespace common
+} // namespace diagnostic_manager
+
+#endif // DM_PERFECT_HASH_H
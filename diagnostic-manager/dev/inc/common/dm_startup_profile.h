@@ -0,0 +1,78 @@
+/*
+ * Diagnostic Manager - Startup phase profiler
+ * Timestamps the init phases between main() entry and "ready" (manifest
+ * mapping, registration per entity type, worker spawn, backend offer).
+ * Enabled by setting $DM_STARTUP_PROFILE to an output path ("-" for
+ * stderr); otherwise a phase scope costs one relaxed load.
+ *
+ * Output is JSON Lines, one object per phase in completion order, then a
+ * closing line with the time to ready:
+ *   {"phase":"config.map","start_us":41,"duration_us":212}
+ *   {"ready_us":1873,"phases":7}
+ * Times are microseconds since Begin().
+ */
+#ifndef DM_STARTUP_PROFILE_H
+#define DM_STARTUP_PROFILE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace diagnostic_manager {
+namespace common {
+
+constexpr const char *kStartupProfileEnv = "DM_STARTUP_PROFILE";
+
+struct StartupPhase {
+    const char *name;          // static string, dotted "<module>.<step>"
+    std::uint64_t startUs;
+    std::uint64_t durationUs;
+};
+
+class StartupProfile {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Mark time zero (call first thing in main) and enable recording if
+    // $DM_STARTUP_PROFILE is set.
+    static void Begin();
+
+    static bool Enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    // Record a finished phase; ignored unless enabled.
+    static void Record(const char *name, Clock::time_point start, Clock::time_point end);
+
+    // Mark ready, write the breakdown and stop recording. Write failures
+    // are reported on stderr but do not fail startup.
+    static void Ready();
+
+    // Phases recorded so far.
+    static std::vector<StartupPhase> Phases();
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+// Records the enclosing scope as one phase.
+class StartupPhaseScope {
+public:
+    explicit StartupPhaseScope(const char *name) noexcept
+        : name_(StartupProfile::Enabled() ? name : nullptr) {
+        if (name_ != nullptr) start_ = StartupProfile::Clock::now();
+    }
+    ~StartupPhaseScope() {
+        if (name_ != nullptr) StartupProfile::Record(name_, start_, StartupProfile::Clock::now());
+    }
+    StartupPhaseScope(const StartupPhaseScope &) = delete;
+    StartupPhaseScope &operator=(const StartupPhaseScope &) = delete;
+
+private:
+    const char *name_;
+    StartupProfile::Clock::time_point start_{};
+};
+
+} // namespace common
+} // namespace diagnostic_manager
+
+#endif // DM_STARTUP_PROFILE_H
@@ -0,0 +1,90 @@
+/*
+ * Diagnostic Manager - Hierarchical timer wheel
+ * Shared deadline scheduler for debouncing. Four levels of 64 slots over a
+ * fixed tick (100 us by default); timers are index-linked nodes in one pool,
+ * so Schedule and Cancel are O(1) and no allocation happens once the pool
+ * has grown to the number of concurrently armed timers. Construction does
+ * not allocate, so a wheel can be a static on a DM memory resource.
+ *
+ * Not thread-safe: the owner serialises all calls (DMEvent uses its mutex).
+ */
+#ifndef DM_TIMER_WHEEL_H
+#define DM_TIMER_WHEEL_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+#include "common/dm_memory.h"
+
+namespace diagnostic_manager {
+namespace common {
+
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimerId = std::uint32_t;
+    static constexpr TimerId kNoTimer = 0;
+    static constexpr std::chrono::microseconds kDefaultResolution{100};
+
+    explicit TimerWheel(Clock::duration resolution = kDefaultResolution, Clock::time_point origin = Clock::now(),
+                        std::pmr::memory_resource *resource = DmMemory::Resource());
+
+    // Arm a timer; `payload` is handed back by Advance. Deadlines in the
+    // past fire on the next tick.
+    TimerId Schedule(Clock::time_point deadline, std::uint64_t payload);
+
+    // Disarm `id` (no-op for kNoTimer) and reset it to kNoTimer.
+    void Cancel(TimerId &id);
+
+    // Move the wheel forward to `now` and append the payloads of all expired
+    // timers, in deadline order with tick granularity.
+    void Advance(Clock::time_point now, std::pmr::vector<std::uint64_t> &expired);
+
+    // Earliest time Advance can have work: the next occupied level-0 slot or
+    // the next cascade of an occupied higher level. nullopt when empty.
+    std::optional<Clock::time_point> NextWakeup() const;
+
+    // Map the last processed tick to `now`, e.g. after the time source
+    // changed; armed timers keep the time they had left.
+    void Rebase(Clock::time_point now) noexcept { origin_ = now - resolution_ * static_cast<Clock::rep>(now_); }
+
+    std::size_t Size() const noexcept { return armed_; }
+    Clock::duration Resolution() const noexcept { return resolution_; }
+
+private:
+    static constexpr unsigned kLevels = 4;
+    static constexpr unsigned kSlotBits = 6;
+    static constexpr unsigned kSlots = 1u << kSlotBits;
+    static constexpr std::uint32_t kNil = 0;     // node 0 is a sentinel
+
+    struct Node {
+        std::uint64_t tick{0};
+        std::uint64_t payload{0};
+        std::uint32_t prev{kNil};
+        std::uint32_t next{kNil};
+        std::uint16_t bucket{0};                 // level * kSlots + slot
+        bool armed{false};
+    };
+
+    std::uint64_t ToTick(Clock::time_point t) const;
+    void Insert(std::uint32_t node);
+    void Unlink(std::uint32_t node);
+    void Cascade(unsigned level);
+
+    Clock::duration resolution_;
+    Clock::time_point origin_;
+    std::uint64_t now_{0};                       // last processed tick
+    std::size_t armed_{0};
+    std::pmr::vector<Node> nodes_;
+    std::pmr::vector<std::uint32_t> freeNodes_;
+    std::array<std::uint32_t, kLevels * kSlots> heads_{};
+    std::array<std::uint64_t, kLevels> occupied_{};   // bit per non-empty slot
+};
+
+}  // namespace common
+}  // namespace diagnostic_manager
+
+#endif // DM_TIMER_WHEEL_H
@@ -0,0 +1,51 @@
+/*
+ * Diagnostic Manager - Static configuration
+ * Loads the compiled manifest at startup and registers the monitors, DTCs
+ * and operation cycles it describes. The mapping stays alive for the
+ * process lifetime and answers the event-to-DTC / event-to-cycle queries.
+ */
+#ifndef DM_CONFIG_H
+#define DM_CONFIG_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "ara/core/result_future.h"
+#include "dtc/dm_dtc.h"
+#include "event/dm_event.h"
+#include "operationcycle/dm_operation_cycle.h"
+
+namespace diagnostic_manager {
+namespace config {
+
+// Environment variable naming the manifest the binary loads at startup.
+constexpr const char *kManifestPathEnv = "DM_MANIFEST";
+
+struct ManifestSummary {
+    std::size_t monitors{0};
+    std::size_t dtcs{0};
+    std::size_t cycles{0};
+    std::size_t bytes{0};
+};
+
+class DMConfig {
+public:
+    // Map and validate the manifest at `path`, then register everything in
+    // it. All or nothing: if one registration fails, the ones already made
+    // are undone and the error is returned. Only one manifest can be loaded
+    // (file_exists otherwise).
+    static ara::core::Result<ManifestSummary> LoadManifest(const std::string &path);
+
+    // True if `id` was registered from the manifest. Such monitors are not
+    // unregistered when a client stops offering them.
+    static bool IsConfiguredMonitor(const event::MonitorId &id);
+
+    // Mappings of a configured monitor; empty for unknown monitors.
+    static std::vector<dtc::DtcId> GetDtcsOfMonitor(const event::MonitorId &id);
+    static std::vector<operation_cycle::OpCycleId> GetOperationCyclesOfMonitor(const event::MonitorId &id);
+};
+
+} // namespace config
+} // namespace diagnostic_manager
+
+#endif // DM_CONFIG_H
@@ -0,0 +1,208 @@
+/*
+ * Diagnostic Manager - Compiled configuration manifest
+ * A flat, versioned binary image of the static configuration: string table,
+ * monitors with their debounce parameters, DTCs, operation cycles and the
+ * monitor-to-DTC / monitor-to-cycle mappings. It is produced on the host by
+ * dm_manifest_gen (or ManifestBuilder) and mapped read-only at startup, so
+ * reading it needs no parsing and no per-entry allocation.
+ *
+ * Layout (little-endian, every section 8-byte aligned):
+ *   ManifestHeader
+ *   strings        char[]              names, not NUL-terminated
+ *   monitors       ManifestMonitor[]   sorted by name
+ *   dtcs           ManifestDtc[]       sorted by id
+ *   cycles         ManifestCycle[]     sorted by name
+ *   monitorDtcs    ManifestLink[]      (monitor index, dtc index), sorted
+ *   monitorCycles  ManifestLink[]      (monitor index, cycle index), sorted
+ */
+#ifndef DM_MANIFEST_H
+#define DM_MANIFEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ara/core/result_future.h"
+#include "event/dm_event.h"
+
+namespace diagnostic_manager {
+namespace config {
+
+constexpr std::uint32_t kManifestMagic = 0x464D4D44;   // "DMMF"
+constexpr std::uint16_t kManifestVersion = 1;
+
+enum class ManifestSectionId : std::uint32_t {
+    Strings = 0,
+    Monitors,
+    Dtcs,
+    Cycles,
+    MonitorDtcs,
+    MonitorCycles,
+    Count
+};
+
+constexpr std::size_t kManifestSectionCount = static_cast<std::size_t>(ManifestSectionId::Count);
+
+struct ManifestSection {
+    std::uint32_t offset;           // from the start of the file
+    std::uint32_t count;            // entries (bytes for the string table)
+};
+
+struct ManifestHeader {
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t headerSize;       // sizeof(ManifestHeader)
+    std::uint32_t fileSize;
+    std::uint32_t checksum;         // FNV-1a of bytes [headerSize, fileSize)
+    ManifestSection sections[kManifestSectionCount];
+};
+
+struct ManifestString {
+    std::uint32_t offset;           // into the string table
+    std::uint32_t length;
+};
+
+// ManifestMonitor::flags
+constexpr std::uint8_t kMonitorJumpUp = 0x01;
+constexpr std::uint8_t kMonitorJumpDown = 0x02;
+constexpr std::uint8_t kMonitorHasFdcThreshold = 0x04;
+constexpr std::uint8_t kMonitorHasTimeFdcThreshold = 0x08;
+
+struct ManifestMonitor {
+    ManifestString name;
+    std::uint8_t mode;              // event::DebounceMode
+    std::uint8_t flags;
+    std::uint16_t reserved;
+    std::int32_t failedThreshold;
+    std::int32_t passedThreshold;
+    std::int32_t failedStep;
+    std::int32_t passedStep;
+    std::int32_t failedJumpValue;
+    std::int32_t passedJumpValue;
+    std::int32_t fdcThreshold;
+    std::uint32_t timeFailedThresholdMs;
+    std::uint32_t timePassedThresholdMs;
+    std::uint32_t timeFdcThresholdMs;
+};
+
+// ManifestDtc::flags
+constexpr std::uint32_t kDtcSuppressed = 0x01;
+
+struct ManifestDtc {
+    std::uint32_t id;
+    std::uint32_t flags;
+};
+
+struct ManifestCycle {
+    ManifestString name;
+};
+
+struct ManifestLink {
+    std::uint32_t monitor;          // monitor index
+    std::uint32_t target;           // dtc or cycle index
+};
+
+static_assert(sizeof(ManifestHeader) == 64, "manifest header layout");
+static_assert(sizeof(ManifestMonitor) == 52, "manifest monitor layout");
+static_assert(sizeof(ManifestDtc) == 8 && sizeof(ManifestCycle) == 8 && sizeof(ManifestLink) == 8,
+              "manifest entry layout");
+static_assert(std::is_trivially_copyable<ManifestMonitor>::value, "manifest entries are read in place");
+
+// Read-only view of a validated manifest, either mapped from a file or held
+// in memory. Move-only; the mapping is released with the object.
+class Manifest {
+public:
+    // Map `path` and validate it; errors: the errno of open/mmap, or
+    // bad_message for a corrupt or truncated image and not_supported for an
+    // unknown version.
+    static ara::core::Result<Manifest> Map(const std::string &path);
+
+    // Validate an in-memory image (takes ownership).
+    static ara::core::Result<Manifest> FromBuffer(std::vector<std::uint8_t> image);
+
+    Manifest(Manifest &&other) noexcept;
+    Manifest &operator=(Manifest &&other) noexcept;
+    Manifest(const Manifest &) = delete;
+    Manifest &operator=(const Manifest &) = delete;
+    ~Manifest();
+
+    std::size_t SizeBytes() const noexcept { return size_; }
+
+    std::size_t MonitorCount() const noexcept { return Count(ManifestSectionId::Monitors); }
+    std::size_t DtcCount() const noexcept { return Count(ManifestSectionId::Dtcs); }
+    std::size_t CycleCount() const noexcept { return Count(ManifestSectionId::Cycles); }
+
+    const ManifestMonitor &Monitor(std::size_t index) const noexcept { return Table<ManifestMonitor>(ManifestSectionId::Monitors)[index]; }
+    const ManifestDtc &Dtc(std::size_t index) const noexcept { return Table<ManifestDtc>(ManifestSectionId::Dtcs)[index]; }
+    const ManifestCycle &Cycle(std::size_t index) const noexcept { return Table<ManifestCycle>(ManifestSectionId::Cycles)[index]; }
+
+    std::string_view Name(const ManifestString &s) const noexcept {
+        return std::string_view(reinterpret_cast<const char *>(data_) + Section(ManifestSectionId::Strings).offset + s.offset, s.length);
+    }
+
+    event::DebounceConfig DebounceConfigOf(const ManifestMonitor &m) const noexcept;
+
+    // Binary search over the sorted tables.
+    std::optional<std::uint32_t> FindMonitor(std::string_view name) const noexcept;
+    std::optional<std::uint32_t> FindDtc(std::uint32_t id) const noexcept;
+
+    // Links of one monitor as [first, last).
+    std::pair<const ManifestLink *, const ManifestLink *> DtcsOf(std::uint32_t monitor) const noexcept {
+        return LinksOf(ManifestSectionId::MonitorDtcs, monitor);
+    }
+    std::pair<const ManifestLink *, const ManifestLink *> CyclesOf(std::uint32_t monitor) const noexcept {
+        return LinksOf(ManifestSectionId::MonitorCycles, monitor);
+    }
+
+private:
+    Manifest() = default;
+    static ara::core::Result<Manifest> Validate(Manifest manifest);
+    void Release() noexcept;
+
+    const ManifestSection &Section(ManifestSectionId id) const noexcept {
+        return reinterpret_cast<const ManifestHeader *>(data_)->sections[static_cast<std::size_t>(id)];
+    }
+    std::size_t Count(ManifestSectionId id) const noexcept { return data_ ? Section(id).count : 0; }
+    template <typename T>
+    const T *Table(ManifestSectionId id) const noexcept {
+        return reinterpret_cast<const T *>(data_ + Section(id).offset);
+    }
+    std::pair<const ManifestLink *, const ManifestLink *> LinksOf(ManifestSectionId id, std::uint32_t monitor) const noexcept;
+
+    const std::uint8_t *data_{nullptr};
+    std::size_t size_{0};
+    void *mapping_{nullptr};                // non-null when mmap'ed
+    std::vector<std::uint8_t> owned_;       // image from FromBuffer
+};
+
+// Host-side writer used by the generator tool and by tests. Entities are
+// added in any order and links by name; Build() sorts, interns the strings
+// and resolves the links.
+class ManifestBuilder {
+public:
+    void AddMonitor(std::string name, const event::DebounceConfig &cfg);
+    void AddDtc(std::uint32_t id, bool suppressed = false);
+    void AddCycle(std::string name);
+    void LinkDtc(std::string monitor, std::uint32_t dtc);
+    void LinkCycle(std::string monitor, std::string cycle);
+
+    // Errors: file_exists for a duplicate name or id, no_such_file_or_directory
+    // for a link to an unknown entity, invalid_argument for an empty name.
+    ara::core::Result<std::vector<std::uint8_t>> Build() const;
+
+private:
+    std::vector<std::pair<std::string, event::DebounceConfig>> monitors_;
+    std::vector<std::pair<std::uint32_t, bool>> dtcs_;
+    std::vector<std::string> cycles_;
+    std::vector<std::pair<std::string, std::uint32_t>> dtcLinks_;
+    std::vector<std::pair<std::string, std::string>> cycleLinks_;
+};
+
+} // namespace config
+} // namespace diagnostic_manager
+
+#endif // DM_MANIFEST_H
@@ -1,11 +1,13 @@
 #ifndef DM_DTC_H
 #define DM_DTC_H
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <optional>
 #include <string>
 #include "ara/core/result_future.h"
+#include "common/dm_memory.h"
 
 namespace diagnostic_manager {
 namespace dtc {
@@ -14,9 +16,32 @@ using UdsStatusByte = std::uint8_t;
 using DtcId = std::uint32_t;
 using DtcStatusNotifier = std::function<void(DtcId, UdsStatusByte, UdsStatusByte)>;
 
+// One DTC of a bulk registration.
+struct DtcRegistration {
+    DtcId dtc;
+    DtcStatusNotifier notifier;
+    bool suppressed{false};
+};
+
+// One-shot waiter for a DTC status with any bit of `mask` set, linked into
+// the DTC without allocating. `fire` is called once, without the DTC lock:
+// with the matching status, or with `unregistered` set when the DTC is
+// unregistered first. Suppressed DTCs do not match. The waiter must stay
+// alive until fired.
+struct DtcStatusWaiter {
+    void (*fire)(DtcStatusWaiter &waiter){nullptr};
+    UdsStatusByte mask{0};
+    UdsStatusByte status{0};
+    bool unregistered{false};
+    DtcStatusWaiter *next{nullptr};   // owned by DMDtc while waiting
+};
+
 class DMDtc {
 public:
     static ara::core::Result<void> RegisterDtc(DtcId dtc, DtcStatusNotifier notifier = nullptr);
+    // All or nothing under one lock; file_exists if a DTC is already
+    // registered or appears twice.
+    static ara::core::Result<void> RegisterDtcs(const DtcRegistration *dtcs, std::size_t count);
     static ara::core::Result<void> UnregisterDtc(DtcId dtc);
     static ara::core::Result<void> ReportDtcStatus(DtcId dtc, UdsStatusByte udsStatus);
 
@@ -26,6 +51,14 @@ public:
     static std::optional<bool> GetDtcSuppression(DtcId dtc);
 
     static ara::core::Result<void> SetDtcStatusNotifier(DtcId dtc, DtcStatusNotifier notifier);
+
+    // Arm `waiter`; it fires on this thread before returning if the current
+    // status already matches. no_such_file_or_directory for an unknown DTC,
+    // invalid_argument for an empty mask.
+    static ara::core::Result<void> AddStatusWaiter(DtcId dtc, DtcStatusWaiter &waiter);
+
+    // Memory held for the registered DTCs; `entities` counts them.
+    static common::MemoryFootprint GetMemoryFootprint();
 };
 
 } // namespace dtc
@@ -0,0 +1,273 @@
+/*
+ * Diagnostic Manager - Debounce policies
+ * Each policy is a set of static functions over its own Params and State.
+ * DMEvent keeps monitors grouped by policy, so the per-report loop of a group
+ * calls one policy directly instead of switching on the mode per report.
+ * Params are interned per policy: monitors with equal parameters share one.
+ */
+#ifndef DM_DEBOUNCE_H
+#define DM_DEBOUNCE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include "common/dm_timer_wheel.h"
+#include "event/dm_event.h"
+
+namespace diagnostic_manager {
+namespace event {
+
+using DebounceClock = std::chrono::steady_clock;
+
+// Policy family a monitor is grouped into; chosen once at registration.
+enum class DebouncePolicy : std::uint8_t {
+    Counter = 0,
+    CounterWithJumps,
+    Time,
+    MonitorInternal
+};
+
+// Deadlines armed by TimePolicy.
+enum class DeadlineKind : std::uint8_t {
+    Qualify = 0,
+    FdcThreshold = 1
+};
+
+// A policy's handle on the shared deadline scheduler for one monitor. The
+// payload of each timer is the monitor's group slot and the deadline kind.
+struct DebounceTimers {
+    common::TimerWheel &wheel;
+    std::uint32_t slot;
+
+    common::TimerWheel::TimerId Arm(DebounceClock::time_point deadline, DeadlineKind kind) {
+        return wheel.Schedule(deadline, (static_cast<std::uint64_t>(slot) << 1) | static_cast<std::uint64_t>(kind));
+    }
+    void Cancel(common::TimerWheel::TimerId &id) { wheel.Cancel(id); }
+
+    static std::uint32_t SlotOf(std::uint64_t payload) noexcept { return static_cast<std::uint32_t>(payload >> 1); }
+    static DeadlineKind KindOf(std::uint64_t payload) noexcept { return static_cast<DeadlineKind>(payload & 1); }
+};
+
+// Outcome of one pre-event. `decided` asks DMEvent to move the monitor to
+// `state` (no-op if it is already there).
+struct DebounceStep {
+    bool decided{false};
+    QualifiedState state{QualifiedState::Unqualified};
+    bool fdcReached{false};
+};
+
+inline DebouncePolicy SelectDebouncePolicy(const DebounceConfig &cfg) noexcept {
+    switch (cfg.mode) {
+    case DebounceMode::TimeBased: return DebouncePolicy::Time;
+    case DebounceMode::MonitorInternal: return DebouncePolicy::MonitorInternal;
+    case DebounceMode::CounterBased:
+    default:
+        return (cfg.jumpUp || cfg.jumpDown) ? DebouncePolicy::CounterWithJumps : DebouncePolicy::Counter;
+    }
+}
+
+// AUTOSAR counter model. The counter runs from -passedThreshold to
+// failedThreshold; with Jumps, a pre-failed below failedJumpValue first jumps
+// there (jump up) and a pre-passed above passedJumpValue first jumps there
+// (jump down), then the step is applied.
+template <bool Jumps>
+struct CounterPolicy {
+    static constexpr DebouncePolicy kPolicy = Jumps ? DebouncePolicy::CounterWithJumps : DebouncePolicy::Counter;
+
+    struct Params {
+        std::int32_t failedThreshold;
+        std::int32_t passedThreshold;   // negative counter limit
+        std::int32_t failedStep;
+        std::int32_t passedStep;
+        std::int32_t fdcThreshold;      // max() when not configured
+        std::int32_t failedJumpValue;
+        std::int32_t passedJumpValue;
+        bool jumpUp;
+        bool jumpDown;
+
+        friend bool operator==(const Params &a, const Params &b) noexcept {
+            return a.failedThreshold == b.failedThreshold && a.passedThreshold == b.passedThreshold &&
+                   a.failedStep == b.failedStep && a.passedStep == b.passedStep && a.fdcThreshold == b.fdcThreshold &&
+                   a.failedJumpValue == b.failedJumpValue && a.passedJumpValue == b.passedJumpValue &&
+                   a.jumpUp == b.jumpUp && a.jumpDown == b.jumpDown;
+        }
+    };
+
+    struct State {
+        std::int32_t counter{0};
+    };
+
+    static Params MakeParams(const DebounceConfig &cfg) noexcept {
+        return Params{cfg.failedThreshold, -cfg.passedThreshold, cfg.failedStep, cfg.passedStep,
+                      cfg.fdcThreshold.value_or(std::numeric_limits<std::int32_t>::max()),
+                      cfg.failedJumpValue, cfg.passedJumpValue, cfg.jumpUp, cfg.jumpDown};
+    }
+
+    static DebounceStep OnPreEvent(const Params &p, State &s, bool preFailed, DebounceClock::time_point,
+                                   DebounceTimers &) noexcept {
+        const std::int32_t before = s.counter;
+        std::int32_t c = before;
+        if (preFailed) {
+            if (Jumps && p.jumpUp && c < p.failedJumpValue) c = p.failedJumpValue;
+            c = std::min(c + p.failedStep, p.failedThreshold);
+        } else {
+            if (Jumps && p.jumpDown && c > p.passedJumpValue) c = p.passedJumpValue;
+            c = std::max(c - p.passedStep, p.passedThreshold);
+        }
+        s.counter = c;
+
+        DebounceStep step;
+        step.decided = true;
+        step.state = c >= p.failedThreshold ? QualifiedState::QualifiedFailed
+                   : c <= p.passedThreshold ? QualifiedState::QualifiedPassed
+                                            : QualifiedState::Unqualified;
+        step.fdcReached = before < p.fdcThreshold && c >= p.fdcThreshold;
+        return step;
+    }
+
+    // True if another pre-event of the same kind would change nothing: the
+    // counter is saturated at that end and the result already applied.
+    static bool RepeatIsNoop(const Params &p, const State &s, bool preFailed, QualifiedState qualified) noexcept {
+        return preFailed ? s.counter == p.failedThreshold && qualified == QualifiedState::QualifiedFailed
+                         : s.counter == p.passedThreshold && qualified == QualifiedState::QualifiedPassed;
+    }
+
+    // A qualified result reported directly moves the counter to its limit.
+    static void OnQualified(const Params &p, State &s, QualifiedState state, DebounceTimers &) noexcept {
+        if (state == QualifiedState::QualifiedFailed) s.counter = p.failedThreshold;
+        else if (state == QualifiedState::QualifiedPassed) s.counter = p.passedThreshold;
+    }
+
+    static void Reset(State &s, DebounceTimers &) noexcept { s = State{}; }
+};
+
+using CounterDebounce = CounterPolicy<false>;
+using CounterJumpDebounce = CounterPolicy<true>;
+
+// Qualifies once the same pre-state has held for the failed or passed delay,
+// using a deadline on the shared scheduler rather than polling. While
+// pre-failed holds, an optional earlier deadline reports the FDC threshold.
+// A flip of the pre-state cancels both deadlines, re-arms and de-qualifies.
+struct TimePolicy {
+    static constexpr DebouncePolicy kPolicy = DebouncePolicy::Time;
+    using TimerId = common::TimerWheel::TimerId;
+
+    struct Params {
+        DebounceClock::duration failedDelay;
+        DebounceClock::duration passedDelay;
+        DebounceClock::duration fdcDelay;   // zero: no FDC deadline
+
+        friend bool operator==(const Params &a, const Params &b) noexcept {
+            return a.failedDelay == b.failedDelay && a.passedDelay == b.passedDelay && a.fdcDelay == b.fdcDelay;
+        }
+    };
+
+    struct State {
+        DebounceClock::time_point qualifyAt{};
+        std::int8_t lastPre{-1};            // -1 none, 0 pre-passed, 1 pre-failed
+        TimerId qualifyTimer{common::TimerWheel::kNoTimer};
+        TimerId fdcTimer{common::TimerWheel::kNoTimer};
+    };
+
+    static Params MakeParams(const DebounceConfig &cfg) noexcept {
+        const std::chrono::milliseconds failed(cfg.timeFailedThresholdMs);
+        const std::chrono::milliseconds fdc(cfg.timeFdcThresholdMs.value_or(0));
+        return Params{failed, std::chrono::milliseconds(cfg.timePassedThresholdMs),
+                      fdc < failed ? DebounceClock::duration(fdc) : DebounceClock::duration::zero()};
+    }
+
+    static DebounceStep OnPreEvent(const Params &p, State &s, bool preFailed, DebounceClock::time_point now,
+                                   DebounceTimers &timers) {
+        DebounceStep step;
+        if (s.lastPre != static_cast<std::int8_t>(preFailed)) {
+            Cancel(s, timers);
+            s.lastPre = static_cast<std::int8_t>(preFailed);
+            s.qualifyAt = now + (preFailed ? p.failedDelay : p.passedDelay);
+            s.qualifyTimer = timers.Arm(s.qualifyAt, DeadlineKind::Qualify);
+            if (preFailed && p.fdcDelay != DebounceClock::duration::zero()) {
+                s.fdcTimer = timers.Arm(now + p.fdcDelay, DeadlineKind::FdcThreshold);
+            }
+            step.decided = true;            // de-qualify a previous result
+            return step;
+        }
+        // A report that arrives after the deadline but before the scheduler
+        // ran qualifies right away.
+        if (s.qualifyTimer != common::TimerWheel::kNoTimer && now >= s.qualifyAt) {
+            step.fdcReached = s.fdcTimer != common::TimerWheel::kNoTimer;
+            Cancel(s, timers);
+            return Qualified(s, step);
+        }
+        return step;
+    }
+
+    // Called for an expired deadline; the wheel has already released it.
+    static DebounceStep OnDeadline(const Params &, State &s, DeadlineKind kind) noexcept {
+        DebounceStep step;
+        if (kind == DeadlineKind::FdcThreshold) {
+            if (s.fdcTimer == common::TimerWheel::kNoTimer) return step;   // cancelled in this batch
+            s.fdcTimer = common::TimerWheel::kNoTimer;
+            step.fdcReached = true;
+            return step;
+        }
+        if (s.qualifyTimer == common::TimerWheel::kNoTimer) return step;
+        s.qualifyTimer = common::TimerWheel::kNoTimer;
+        return Qualified(s, step);
+    }
+
+    // A repeated pre-state only re-reads the clock: while a deadline is
+    // armed, the deadline qualifies; otherwise nothing is pending.
+    static bool RepeatIsNoop(const Params &, const State &s, bool preFailed, QualifiedState) noexcept {
+        return s.lastPre == static_cast<std::int8_t>(preFailed);
+    }
+
+    static void OnQualified(const Params &, State &s, QualifiedState, DebounceTimers &timers) {
+        Cancel(s, timers);                  // no repeat until the pre-state flips
+    }
+
+    static void Reset(State &s, DebounceTimers &timers) {
+        Cancel(s, timers);
+        s = State{};
+    }
+
+private:
+    static void Cancel(State &s, DebounceTimers &timers) {
+        timers.Cancel(s.qualifyTimer);
+        timers.Cancel(s.fdcTimer);
+    }
+
+    static DebounceStep Qualified(const State &s, DebounceStep step) noexcept {
+        step.decided = true;
+        step.state = s.lastPre == 1 ? QualifiedState::QualifiedFailed : QualifiedState::QualifiedPassed;
+        return step;
+    }
+};
+
+// The application debounces itself and reports only qualified results and
+// kFdcThresholdReached; pre-events carry no information.
+struct MonitorInternalPolicy {
+    static constexpr DebouncePolicy kPolicy = DebouncePolicy::MonitorInternal;
+
+    struct Params {
+        friend bool operator==(const Params &, const Params &) noexcept { return true; }
+    };
+    struct State {};
+
+    static Params MakeParams(const DebounceConfig &) noexcept { return Params{}; }
+
+    static DebounceStep OnPreEvent(const Params &, State &, bool, DebounceClock::time_point,
+                                   DebounceTimers &) noexcept {
+        return DebounceStep{};
+    }
+
+    static bool RepeatIsNoop(const Params &, const State &, bool, QualifiedState) noexcept { return true; }
+
+    static void OnQualified(const Params &, State &, QualifiedState, DebounceTimers &) noexcept {}
+
+    static void Reset(State &, DebounceTimers &) noexcept {}
+};
+
+}  // namespace event
+}  // namespace diagnostic_manager
+
+#endif // DM_DEBOUNCE_H
@@ -5,19 +5,24 @@
 #ifndef DM_EVENT_H
 #define DM_EVENT_H
 
+#include <chrono>
 #include <functional>
 #include <optional>
 #include <system_error>
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include "ara/core/result_future.h"
+#include "common/dm_memory.h"
 
 namespace diagnostic_manager {
 namespace event {
 
 enum class DebounceMode {
     CounterBased,
-    TimeBased
+    TimeBased,
+    MonitorInternal     // application debounces itself and reports qualified results
 };
 
 enum class QualifiedState : std::uint8_t {
@@ -34,31 +39,219 @@ struct DebounceConfig {
     std::int32_t passedThreshold{3};   // qualify passed after this many prepassed reports
     std::int32_t failedStep{1};        // step per prefailed report
     std::int32_t passedStep{1};        // step per prepassed report
+    // Jump behaviour of the AUTOSAR counter model (counter values, may be negative)
+    bool jumpUp{false};                // prefailed below failedJumpValue jumps there first
+    bool jumpDown{false};              // prepassed above passedJumpValue jumps there first
+    std::int32_t failedJumpValue{0};
+    std::int32_t passedJumpValue{0};
+    std::optional<std::int32_t> fdcThreshold;  // counter value that triggers FdcThresholdReached
 
     // Time-based defaults (milliseconds)
-    std::uint32_t timeThresholdMs{12000}; // qualify if pre state holds continuously for this duration
+    std::uint32_t timeFailedThresholdMs{12000}; // qualify failed if prefailed holds continuously for this duration
+    std::uint32_t timePassedThresholdMs{12000}; // qualify passed if prepassed holds continuously for this duration
+    std::optional<std::uint32_t> timeFdcThresholdMs;  // FdcThresholdReached after prefailed held this long
 };
 
+// Monitor identifier type (use InstanceSpecifier::GetName() on ara-diag side)
 using MonitorId = std::string;
+
+// Notifier type called when a monitor becomes qualified (or changes qualified state).
+// first arg: monitor id, second arg: new qualified state
 using QualifiedNotifier = std::function<void(const MonitorId &, QualifiedState)>;
 
+// Event status byte derived from the qualified state; bit values match
+// ara::diag::EventStatusBit.
+constexpr std::uint8_t kStatusFailedAndTested = 0x01;
+constexpr std::uint8_t kStatusPassedAndTested = 0x02;
+
+// Notifier type called when the event status byte of a monitor changes.
+// first arg: monitor id, second arg: new status byte
+using EventStatusNotifier = std::function<void(const MonitorId &, std::uint8_t)>;
+
+// One entry of a batched qualified-state update.
+struct QualifiedUpdate {
+    const MonitorId *id;
+    QualifiedState state;
+    std::uint64_t reportedNs{0};   // CLOCK_MONOTONIC report time for latency tracing; 0: time of the call
+};
+
+// One entry of a batched pre-event report.
+struct PreEventUpdate {
+    const MonitorId *id;
+    bool preFailed;
+};
+
+// Stable reference to a registered monitor for frequent reporters; resolves
+// without a name lookup and becomes stale when the monitor is unregistered.
+using MonitorHandle = std::uint64_t;
+
+// One entry of a batched pre-event report by handle.
+struct HandlePreEventUpdate {
+    MonitorHandle handle;
+    bool preFailed;
+    std::uint64_t reportedNs{0};   // as QualifiedUpdate::reportedNs
+};
+
+// What happens to a pre-event over the ingestion budget.
+enum class OverloadAction : std::uint8_t {
+    Drop,    // rejected with resource_unavailable_try_again
+    Defer    // the latest pre-state per monitor is applied in the next second
+};
+
+// Overload protection for pre-events reported by MonitorHandle (including
+// DMIngestion and the IPC server); reports by id are not affected. Both
+// checks run before any lock is taken.
+struct OverloadPolicy {
+    bool filterRepeats{false};          // drop pre-events that provably change nothing
+    std::uint32_t budgetPerSecond{0};   // pre-events applied per second (DmClock); 0: unlimited
+    OverloadAction overBudget{OverloadAction::Drop};
+};
+
+struct OverloadStatistics {
+    std::uint64_t filtered{0};          // dropped as repeats
+    std::uint64_t dropped{0};           // over budget
+    std::uint64_t deferred{0};          // over budget, kept for the next window
+    std::uint64_t deferredApplied{0};   // deferred pre-states applied (one per monitor and window)
+};
+
+// One-shot waiter for the next qualified-state change of a monitor, linked
+// into the monitor without allocating. `fire` is called once, without the
+// DMEvent lock: with the new state, or with `unregistered` set when the
+// monitor is unregistered first. The waiter must stay alive until then.
+struct QualifiedStateWaiter {
+    void (*fire)(QualifiedStateWaiter &waiter){nullptr};
+    QualifiedState state{QualifiedState::Unqualified};
+    bool unregistered{false};
+    QualifiedStateWaiter *next{nullptr};   // owned by DMEvent while waiting
+};
+
+// One entry of a subscriber state stream (DMEvent::OpenStateStream).
+struct StateChange {
+    MonitorHandle handle;      // 0 if the handle table is full
+    QualifiedState state;
+    std::uint64_t sequence;    // per stream, from 1; a jump means the ring was full
+};
+
+using StateStreamId = std::uint32_t;
+
+// One monitor of a bulk registration.
+struct MonitorRegistration {
+    std::string_view id;
+    DebounceConfig cfg;
+    QualifiedNotifier notifier;
+};
+
 // Public DMEvent API
 class DMEvent {
 public:
+    // Existing APIs (event memory overflow)
     static std::optional<bool> GetEventMemoryOverflow();
     static ara::core::Result<void> SetEventMemoryOverflowNotifier(std::function<void(bool)> notifier);
 
+    // Register a monitor with debounce configuration and a notifier.
+    // Returns error if monitor id already registered.
     static ara::core::Result<void> RegisterMonitor(const MonitorId &id, DebounceConfig cfg, QualifiedNotifier notifier);
+
+    // Register several monitors under one lock acquisition, with table
+    // capacity reserved up front. All or nothing: file_exists if an id is
+    // already registered or appears twice, invalid_argument for an empty id.
+    // The names of one call are stored together, and a perfect hash over
+    // all registered names is rebuilt; monitors registered one at a time
+    // are found through a hash map until the next call.
+    static ara::core::Result<void> RegisterMonitors(const MonitorRegistration *monitors, std::size_t count);
+
+    // Debounce parameters are interned: monitors registered with equal
+    // configurations share one parameter set. Replace the set `from` with
+    // `to` for all monitors using it, in one step under the lock; counters
+    // are kept, armed time-based deadlines keep their time.
+    // invalid_argument if `to` selects another debounce policy,
+    // no_such_file_or_directory if no registered monitor uses `from` (also
+    // after its monitors were unregistered or merged into another set).
+    static ara::core::Result<void> ReplaceDebounceConfig(const DebounceConfig &from, const DebounceConfig &to);
+
+    // Unregister previously registered monitor.
     static ara::core::Result<void> UnregisterMonitor(const MonitorId &id);
+
+    // Called by ara-diag when it reports an unqualified test result (prepassed / prefailed)
+    // preFailed == true => pre-failed reported; preFailed == false => pre-passed reported
+    // Returns error if monitor id unknown.
     static ara::core::Result<void> ReportPreEvent(const MonitorId &id, bool preFailed);
 
+    // Report several pre-events under one lock acquisition. Updates are run
+    // per debounce policy group; the order per monitor is kept, the order of
+    // notifications across monitors is not. Unknown ids are skipped; returns
+    // the number of updates applied.
+    static std::size_t ReportPreEvents(const PreEventUpdate *updates, std::size_t count);
+
+    // Handle of a registered monitor, valid until it is unregistered.
+    static std::optional<MonitorHandle> GetMonitorHandle(const MonitorId &id);
+
+    // By handle, subject to the overload policy. no_such_file_or_directory
+    // for a stale handle, resource_unavailable_try_again if dropped over
+    // budget; a filtered or deferred report succeeds.
+    static ara::core::Result<void> ReportPreEvent(MonitorHandle handle, bool preFailed);
+
+    // As above, by handle; stale handles are skipped. Returns the number of
+    // updates for live handles, whether applied, filtered, dropped or deferred.
+    static std::size_t ReportPreEvents(const HandlePreEventUpdate *updates, std::size_t count);
+
+    // Only the repeat filter of the overload policy, for reporters that queue
+    // pre-events: true (and counted as filtered) if the report can be dropped.
+    static bool FilterRepeatedPreEvent(MonitorHandle handle, bool preFailed);
+
+    static void SetOverloadPolicy(const OverloadPolicy &policy);
+    static OverloadStatistics GetOverloadStatistics();
+
+    // Arm `waiter` for the next change of the monitor's qualified state.
+    // no_such_file_or_directory if the monitor is unknown.
+    static ara::core::Result<void> AddQualifiedStateWaiter(const MonitorId &id, QualifiedStateWaiter &waiter);
+
+    // Open a stream of every qualified-state change of every monitor, in the
+    // order the changes are applied (so FIFO per monitor), for one reader
+    // that drains it at its own pace. Entries are written under the DMEvent
+    // lock into a ring of `capacity` entries (rounded up to a power of two);
+    // on a full ring they are dropped, which the reader sees as a sequence
+    // gap. invalid_argument for a zero or oversized capacity,
+    // too_many_files_open when 64 streams are open.
+    static ara::core::Result<StateStreamId> OpenStateStream(std::size_t capacity);
+
+    // Close a stream; not concurrently with its reader.
+    // no_such_file_or_directory if it is not open.
+    static ara::core::Result<void> CloseStateStream(StateStreamId stream);
+
+    // Take up to `max` entries without locking; only the stream's reader
+    // may call this. 0 for a stream that is not open.
+    static std::size_t ReadStateStream(StateStreamId stream, StateChange *out, std::size_t max);
+
+    // Query current qualified state (if registered)
     static std::optional<QualifiedState> GetQualifiedState(const MonitorId &id);
 
+    // Additional control operations driven by MonitorAction commands
     static ara::core::Result<void> SetQualifiedState(const MonitorId &id, QualifiedState state);
+
+    // Apply several qualified results (e.g. from monitor-internal debouncing)
+    // under one lock acquisition; notifiers run afterwards in input order.
+    // Unknown ids are skipped; returns the number of updates applied.
+    static std::size_t SetQualifiedStates(const QualifiedUpdate *updates, std::size_t count);
     static ara::core::Result<void> FreezeDebouncing(const MonitorId &id);
     static ara::core::Result<void> ResetDebouncing(const MonitorId &id);
     static ara::core::Result<void> TriggerFdcThresholdReached(const MonitorId &id);
     static ara::core::Result<void> ResetTestFailed(const MonitorId &id);
+
+    // Current event status byte (if registered).
+    static std::optional<std::uint8_t> GetEventStatus(const MonitorId &id);
+
+    // Set (or clear with nullptr) the status notifier of a registered monitor.
+    // It is called only when the status byte actually changes. With a
+    // non-zero minInterval updates are coalesced: at most one per interval,
+    // carrying the latest byte; a change that is reverted within the
+    // interval is not delivered at all. Replacing an installed notifier keeps
+    // a change that is still waiting for its interval.
+    static ara::core::Result<void> SetEventStatusNotifier(const MonitorId &id, EventStatusNotifier notifier,
+                                                          std::chrono::milliseconds minInterval = std::chrono::milliseconds{0});
+
+    // Memory held for the registered monitors; `entities` counts them.
+    static common::MemoryFootprint GetMemoryFootprint();
 };
 
 }  // namespace event
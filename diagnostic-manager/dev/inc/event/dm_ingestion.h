@@ -0,0 +1,67 @@
+/*
+ * Diagnostic Manager - Queued pre-event ingestion
+ * Reporting threads append pre-events to a queue of their own instead of
+ * taking the DMEvent lock and touching monitor state. A small pool of
+ * consumer threads drains the queues in batches into DMEvent, one lock
+ * acquisition per batch. Every queue has a home consumer; a consumer with
+ * nothing of its own to do takes over backlogged queues of the others.
+ *
+ * Pre-events of one reporting thread are applied in order. Reporters
+ * address monitors by MonitorHandle (DMEvent::GetMonitorHandle).
+ */
+#ifndef DM_INGESTION_H
+#define DM_INGESTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ara/core/result_future.h"
+#include "common/dm_executor.h"
+#include "event/dm_event.h"
+
+namespace diagnostic_manager {
+namespace event {
+
+struct IngestionConfig {
+    std::size_t consumers{2};
+    std::size_t queueCapacity{4096};     // records per reporting thread, rounded up to a power of two
+    std::size_t drainBatch{256};         // max records taken from one queue per pass
+    std::size_t stealThreshold{64};      // backlog at which an idle consumer takes over a queue
+    std::uint32_t spinBeforeSleep{64};   // empty passes before a consumer sleeps
+    std::vector<common::WorkerOptions> consumerOptions;   // per consumer; threads are "dm-ingest-<i>"
+};
+
+struct IngestionStatistics {
+    std::uint64_t queues{0};          // reporting threads with a live queue
+    std::uint64_t applied{0};
+    std::uint64_t stale{0};           // records for unregistered monitors
+    std::uint64_t dropped{0};         // rejected on a full queue
+    std::uint64_t batches{0};
+    std::uint64_t stolenBatches{0};   // drained by a consumer other than the home one
+};
+
+class DMIngestion {
+public:
+    // Start the consumers. already_connected if running, invalid_argument
+    // for a zero count or size, or the error of a consumer option that could
+    // not be applied.
+    static ara::core::Result<void> Start(const IngestionConfig &cfg = IngestionConfig{});
+
+    // Stop the consumers and apply everything still queued. Reports made
+    // concurrently with Stop may be lost.
+    static void Stop();
+
+    // Queue a pre-event on the calling thread's queue; the first call of a
+    // thread creates it. Otherwise only that queue is written, plus a wake-up
+    // when all consumers sleep. Repeats dropped by the overload filter
+    // (DMEvent::SetOverloadPolicy) are not queued. not_connected when not
+    // started, resource_unavailable_try_again on a full queue.
+    static ara::core::Result<void> ReportPreEvent(MonitorHandle handle, bool preFailed);
+
+    static IngestionStatistics GetStatistics();
+};
+
+} // namespace event
+} // namespace diagnostic_manager
+
+#endif // DM_INGESTION_H
@@ -0,0 +1,51 @@
+/*
+ * Diagnostic Manager - IPC server
+ * Accepts ara-diag client processes, hands each one a shared-memory segment
+ * of report rings (one per reporting thread) and drains them in batches into
+ * DMEvent. Event status changes
+ * are pushed back to subscribed clients through a second ring.
+ */
+#ifndef DM_IPC_SERVER_H
+#define DM_IPC_SERVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "ara/core/result_future.h"
+
+namespace diagnostic_manager {
+namespace ipc {
+
+struct IpcServerConfig {
+    std::string socketPath;           // empty: $DM_IPC_SOCKET or the protocol default
+    std::size_t drainBatch{256};      // max records taken from one ring per pass
+    std::uint32_t spinBeforeSleep{64};// empty passes before falling back to eventfd wakeups
+};
+
+struct IpcStatistics {
+    std::uint64_t clients{0};          // currently connected clients
+    std::uint64_t reportsDrained{0};
+    std::uint64_t batches{0};
+    std::uint64_t reportsDropped{0};   // dropped by clients on full rings
+    std::uint64_t unknownHandles{0};
+    std::uint64_t maxLatencyNs{0};     // report timestamp -> dispatch into DMEvent
+    std::uint64_t totalLatencyNs{0};
+    std::uint64_t statusPublished{0};  // status changes pushed to subscribers
+    std::uint64_t statusDropped{0};    // lost on a full status ring
+};
+
+class DMIpcServer {
+public:
+    // Bind the handshake socket and start the drain thread.
+    static ara::core::Result<void> Start(const IpcServerConfig &cfg = IpcServerConfig{});
+
+    // Stop the drain thread, unregister all offered monitors and close clients.
+    static void Stop();
+
+    static IpcStatistics GetStatistics();
+};
+
+} // namespace ipc
+} // namespace diagnostic_manager
+
+#endif // DM_IPC_SERVER_H
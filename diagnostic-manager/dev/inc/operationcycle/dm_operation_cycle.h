@@ -1,9 +1,11 @@
 #ifndef DM_OPERATION_CYCLE_H
 #define DM_OPERATION_CYCLE_H
 
+#include <cstddef>
 #include <functional>
 #include <optional>
 #include <string>
+#include <string_view>
 #include "ara/core/result_future.h"
 
 namespace diagnostic_manager {
@@ -15,11 +17,35 @@ using OpCycleId = std::string;
 // Notifier called when op-cycle state changes: (id, active)
 using OpCycleNotifier = std::function<void(const OpCycleId &, bool)>;
 
+// One operation cycle of a bulk registration.
+struct OperationCycleRegistration {
+    std::string_view id;
+    OpCycleNotifier notifier;
+};
+
+// One-shot waiter for the next state change of an operation cycle, linked
+// into the cycle without allocating. `fire` is called once, without the
+// registry lock: with the new state in `active`, or with `unregistered` set
+// when the cycle is unregistered first. The waiter must stay alive until
+// fired.
+struct OpCycleStateWaiter {
+    void (*fire)(OpCycleStateWaiter &waiter){nullptr};
+    bool active{false};
+    bool unregistered{false};
+    OpCycleStateWaiter *next{nullptr};   // owned by DMOperationCycle while waiting
+};
+
 class DMOperationCycle {
 public:
     // Register an operation cycle instance with optional notifier.
     static ara::core::Result<void> RegisterOperationCycle(const OpCycleId &id, OpCycleNotifier notifier = nullptr);
 
+    // Register several operation cycles under one lock acquisition. All or
+    // nothing: file_exists if an id is already registered or appears twice,
+    // invalid_argument for an empty id. Rebuilds the perfect-hash name index
+    // over all registered cycles.
+    static ara::core::Result<void> RegisterOperationCycles(const OperationCycleRegistration *cycles, std::size_t count);
+
     // Unregister previously registered operation cycle instance.
     static ara::core::Result<void> UnregisterOperationCycle(const OpCycleId &id);
 
@@ -31,6 +57,10 @@ public:
 
     // Set or replace notifier for an already registered operation cycle.
     static ara::core::Result<void> SetOpCycleNotifier(const OpCycleId &id, OpCycleNotifier notifier);
+
+    // Arm `waiter` for the next state change of `id`; no_such_file_or_directory
+    // for an unknown cycle.
+    static ara::core::Result<void> AddStateWaiter(const OpCycleId &id, OpCycleStateWaiter &waiter);
 };
 
 } // namespace operation_cycle
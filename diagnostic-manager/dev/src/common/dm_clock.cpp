@@ -0,0 +1,49 @@
+#include "common/dm_clock.h"
+#include "common/dm_executor.h"
+
+#include <mutex>
+#include <system_error>
+#include <utility>
+
+namespace diagnostic_manager {
+namespace common {
+
+std::atomic<bool> DmClock::virtual_{false};
+std::atomic<DmClock::Clock::rep> DmClock::virtualNow_{0};
+std::atomic<std::uint64_t> DmClock::generation_{0};
+
+static std::mutex g_advanceMutex;   // one Advance at a time
+
+void DmClock::UseVirtual(Clock::time_point start) {
+    virtualNow_.store(start.time_since_epoch().count(), std::memory_order_release);
+    virtual_.store(true, std::memory_order_release);
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void DmClock::UseReal() {
+    virtual_.store(false, std::memory_order_release);
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+    if (!Executor::Running()) return;
+    // workers wait without a timeout under a virtual clock; have them pick up their deadlines
+    Executor::Post(TaskLane::Latency, [] {});
+    Executor::Post(TaskLane::Bulk, [] {});
+}
+
+ara::core::Result<void> DmClock::Advance(Clock::duration d) {
+    if (!IsVirtual()) return ara::core::Result<void>{ std::make_error_code(std::errc::operation_not_permitted) };
+    if (d.count() < 0) return ara::core::Result<void>{ std::make_error_code(std::errc::invalid_argument) };
+    std::lock_guard<std::mutex> lk(g_advanceMutex);
+    const Clock::time_point target = Now() + d;
+    Clock::time_point when;
+    Executor::Task task;
+    while (Executor::TakeDueTask(target, when, task)) {
+        // tasks queued before the last step may be overdue; time never goes back
+        if (when > Now()) virtualNow_.store(when.time_since_epoch().count(), std::memory_order_release);
+        task();
+    }
+    virtualNow_.store(target.time_since_epoch().count(), std::memory_order_release);
+    return ara::core::Result<void>{};
+}
+
+} // namespace common
+} // namespace diagnostic_manager
@@ -0,0 +1,113 @@
+#include "common/dm_epoch.h"
+
+#include <mutex>
+#include <vector>
+
+namespace diagnostic_manager {
+namespace common {
+
+namespace {
+
+constexpr std::size_t kStripes = 16;
+
+struct alignas(64) PinStripe {
+    std::atomic<std::uint64_t> pins{0};
+};
+
+struct Retired {
+    void *object;
+    void (*destroy)(void *);
+};
+
+// Readers pinned in epoch e count in pins[e & 1]. The epoch moves from e to
+// e + 1 only when no reader of e - 1 is left, so objects retired in e - 1
+// (unreachable for readers of e and later) can then be deleted. Objects
+// retired in e are kept in limbo[e % 3].
+struct Domain {
+    std::atomic<std::uint64_t> epoch{2};
+    PinStripe pins[2][kStripes];
+    std::mutex mutex;   // epoch advances and limbo
+    std::vector<Retired> limbo[3];
+    std::size_t pending{0};
+};
+
+// Never destroyed: objects owned by other modules' statics are retired
+// during static destruction.
+Domain &domain() {
+    static Domain *d = new Domain;
+    return *d;
+}
+
+std::size_t stripe_index() {
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % kStripes;
+    return index;
+}
+
+// Advance once if possible, moving what became unreachable to `out`;
+// mutex held.
+bool try_advance(Domain &d, std::vector<Retired> &out) {
+    const std::uint64_t e = d.epoch.load();
+    for (const PinStripe &s : d.pins[(e + 1) & 1]) {
+        if (s.pins.load() != 0) return false;
+    }
+    d.epoch.store(e + 1);
+    std::vector<Retired> &freed = d.limbo[(e + 2) % 3];   // retired in e - 1
+    d.pending -= freed.size();
+    out.insert(out.end(), freed.begin(), freed.end());
+    freed.clear();
+    return true;
+}
+
+void destroy_all(const std::vector<Retired> &objects) {
+    for (const Retired &r : objects) r.destroy(r.object);
+}
+
+} // namespace
+
+EpochGuard::EpochGuard() noexcept {
+    Domain &d = domain();
+    const std::size_t stripe = stripe_index();
+    for (;;) {
+        const std::uint64_t e = d.epoch.load();
+        pin_ = &d.pins[e & 1][stripe].pins;
+        pin_->fetch_add(1);
+        if (d.epoch.load() == e) return;   // otherwise the advance may not have seen the pin
+        pin_->fetch_sub(1);
+    }
+}
+
+EpochGuard::~EpochGuard() { pin_->fetch_sub(1, std::memory_order_release); }
+
+void Epoch::Retire(void *object, void (*destroy)(void *)) {
+    Domain &d = domain();
+    std::vector<Retired> freed;
+    {
+        std::lock_guard<std::mutex> lk(d.mutex);
+        d.limbo[d.epoch.load() % 3].push_back(Retired{object, destroy});
+        ++d.pending;
+        for (int i = 0; i < 2 && try_advance(d, freed); ++i) {
+        }
+    }
+    destroy_all(freed);
+}
+
+void Epoch::Reclaim() {
+    Domain &d = domain();
+    std::vector<Retired> freed;
+    {
+        std::lock_guard<std::mutex> lk(d.mutex);
+        for (int i = 0; i < 2 && try_advance(d, freed); ++i) {
+        }
+    }
+    destroy_all(freed);
+}
+
+std::size_t Epoch::Pending() {
+    Domain &d = domain();
+    std::lock_guard<std::mutex> lk(d.mutex);
+    return d.pending;
+}
+
+} // namespace common
+} // namespace diagnostic_manager
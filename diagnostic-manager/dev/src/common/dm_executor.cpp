@@ -0,0 +1,269 @@
+#include "common/dm_executor.h"
+#include "common/dm_clock.h"
+#include "common/dm_memory.h"
+#include "common/dm_startup_profile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace diagnostic_manager {
+namespace common {
+
+namespace {
+
+constexpr std::size_t kLaneCount = 2;
+
+struct TimedTask {
+    Executor::Clock::time_point when;
+    std::uint64_t seq;   // FIFO among equal deadlines
+    Executor::Task task;
+};
+
+// min-heap on (when, seq)
+bool later(const TimedTask &a, const TimedTask &b) {
+    return a.when != b.when ? a.when > b.when : a.seq > b.seq;
+}
+
+struct Lane {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::pmr::deque<Executor::Task> ready{DmMemory::Resource(MemorySubsystem::Queues)};
+    std::pmr::vector<TimedTask> timed{DmMemory::Resource(MemorySubsystem::Queues)};
+    std::uint64_t seq{0};
+    bool stop{false};
+    std::vector<std::thread> workers;
+};
+
+struct ExecutorState {
+    std::mutex controlMutex;   // Configure / Start / Shutdown
+    ExecutorConfig cfg;
+    std::atomic<bool> running{false};
+    std::atomic<std::uint64_t> epoch{0};
+    Lane lanes[kLaneCount];
+};
+
+// Never destroyed: tasks of other modules may still be posted while static
+// objects are torn down at exit.
+ExecutorState &state() {
+    static ExecutorState *s = new ExecutorState;
+    return *s;
+}
+
+void worker_loop(Lane &lane) {
+    std::unique_lock<std::mutex> lk(lane.mutex);
+    while (!lane.stop) {
+        // under a virtual clock timed tasks are left to DmClock::Advance
+        const bool virtualTime = DmClock::IsVirtual();
+        const auto now = DmClock::Now();
+        while (!virtualTime && !lane.timed.empty() && lane.timed.front().when <= now) {
+            std::pop_heap(lane.timed.begin(), lane.timed.end(), later);
+            lane.ready.push_back(std::move(lane.timed.back().task));
+            lane.timed.pop_back();
+        }
+        if (!lane.ready.empty()) {
+            Executor::Task task = std::move(lane.ready.front());
+            lane.ready.pop_front();
+            lk.unlock();
+            task();
+            lk.lock();
+            continue;
+        }
+        if (lane.timed.empty() || virtualTime) {
+            lane.cv.wait(lk);
+        } else {
+            const auto due = lane.timed.front().when;   // by value: the heap may grow while waiting
+            lane.cv.wait_until(lk, due);
+        }
+    }
+}
+
+ara::core::Result<void> validate(const LaneConfig &lane) {
+    if (lane.workers == 0) return ara::core::Result<void>{ std::make_error_code(std::errc::invalid_argument) };
+    for (const WorkerOptions &opt : lane.options) {
+        if (opt.fifoPriority < 0 || opt.fifoPriority > 99 || opt.nice < -20 || opt.nice > 19) {
+            return ara::core::Result<void>{ std::make_error_code(std::errc::invalid_argument) };
+        }
+    }
+    return ara::core::Result<void>{};
+}
+
+void stop_lanes(ExecutorState &s) {
+    for (Lane &lane : s.lanes) {
+        {
+            std::lock_guard<std::mutex> lk(lane.mutex);
+            lane.stop = true;
+        }
+        lane.cv.notify_all();
+    }
+    for (Lane &lane : s.lanes) {
+        for (std::thread &t : lane.workers) t.join();
+        std::lock_guard<std::mutex> lk(lane.mutex);
+        lane.workers.clear();
+        lane.ready.clear();
+        lane.timed.clear();
+        lane.stop = false;
+    }
+}
+
+} // namespace
+
+std::error_code ApplyWorkerOptions(const std::string &name, const WorkerOptions &opt) {
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+    if (opt.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(opt.cpu, &set);
+        if (const int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+            return std::error_code(err, std::generic_category());
+        }
+    }
+    if (opt.fifoPriority > 0) {
+        sched_param param{};
+        param.sched_priority = opt.fifoPriority;
+        if (const int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param)) {
+            return std::error_code(err, std::generic_category());
+        }
+    } else if (opt.nice != 0) {
+        // per-thread on Linux
+        const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+        if (setpriority(PRIO_PROCESS, tid, opt.nice) != 0) return std::error_code(errno, std::generic_category());
+    }
+    return std::error_code{};
+}
+
+ara::core::Result<void> Executor::Configure(const ExecutorConfig &cfg) {
+    ExecutorState &s = state();
+    std::lock_guard<std::mutex> lk(s.controlMutex);
+    if (s.running) return ara::core::Result<void>{ std::make_error_code(std::errc::device_or_resource_busy) };
+    auto res = validate(cfg.latency);
+    if (res.HasError()) return res;
+    res = validate(cfg.bulk);
+    if (res.HasError()) return res;
+    s.cfg = cfg;
+    return ara::core::Result<void>{};
+}
+
+ara::core::Result<void> Executor::Start() {
+    ExecutorState &s = state();
+    if (s.running.load(std::memory_order_acquire)) return ara::core::Result<void>{};
+    std::lock_guard<std::mutex> lk(s.controlMutex);
+    if (s.running) return ara::core::Result<void>{};
+
+    StartupPhaseScope phase("executor.spawn");
+    const LaneConfig *configs[kLaneCount] = {&s.cfg.latency, &s.cfg.bulk};
+    std::vector<std::future<std::error_code>> applied;
+    for (std::size_t l = 0; l < kLaneCount; ++l) {
+        Lane &lane = s.lanes[l];
+        const LaneConfig &cfg = *configs[l];
+        for (std::size_t i = 0; i < cfg.workers; ++i) {
+            const WorkerOptions opt = i < cfg.options.size() ? cfg.options[i] : WorkerOptions{};
+            std::promise<std::error_code> result;
+            applied.push_back(result.get_future());
+            lane.workers.emplace_back([&lane, opt, name = cfg.name + "-" + std::to_string(i),
+                                       result = std::move(result)]() mutable {
+                result.set_value(ApplyWorkerOptions(name, opt));
+                worker_loop(lane);
+            });
+        }
+    }
+    for (auto &f : applied) {
+        const std::error_code ec = f.get();
+        if (ec) {
+            stop_lanes(s);
+            return ara::core::Result<void>{ ec };
+        }
+    }
+    s.running.store(true, std::memory_order_release);
+    return ara::core::Result<void>{};
+}
+
+static ara::core::Result<void> post(TaskLane laneId, Executor::Clock::time_point when, bool timed, Executor::Task task) {
+    if (!task) return ara::core::Result<void>{ std::make_error_code(std::errc::invalid_argument) };
+    auto started = Executor::Start();
+    if (started.HasError()) return started;
+
+    Lane &lane = state().lanes[static_cast<std::size_t>(laneId)];
+    {
+        std::lock_guard<std::mutex> lk(lane.mutex);
+        // under a virtual clock even due timed tasks wait for the next Advance
+        if (!timed || (when <= DmClock::Now() && !DmClock::IsVirtual())) {
+            lane.ready.push_back(std::move(task));
+        } else {
+            lane.timed.push_back(TimedTask{when, lane.seq++, std::move(task)});
+            std::push_heap(lane.timed.begin(), lane.timed.end(), later);
+        }
+    }
+    // a sleeping worker may be waiting for a later deadline
+    lane.cv.notify_one();
+    return ara::core::Result<void>{};
+}
+
+ara::core::Result<void> Executor::Post(TaskLane lane, Task task) {
+    return post(lane, Clock::time_point::min(), false, std::move(task));
+}
+
+ara::core::Result<void> Executor::PostAt(TaskLane lane, Clock::time_point when, Task task) {
+    return post(lane, when, true, std::move(task));
+}
+
+bool Executor::TakeDueTask(Clock::time_point until, Clock::time_point &when, Task &task) {
+    ExecutorState &s = state();
+    for (;;) {
+        // earliest head over the lanes, lower lane first on a tie
+        Lane *best = nullptr;
+        Clock::time_point earliest;
+        for (Lane &lane : s.lanes) {
+            std::lock_guard<std::mutex> lk(lane.mutex);
+            if (lane.timed.empty() || lane.timed.front().when > until) continue;
+            if (best == nullptr || lane.timed.front().when < earliest) {
+                best = &lane;
+                earliest = lane.timed.front().when;
+            }
+        }
+        if (best == nullptr) return false;
+        std::lock_guard<std::mutex> lk(best->mutex);
+        // another thread may have changed the heap in between
+        if (best->timed.empty() || best->timed.front().when != earliest) continue;
+        std::pop_heap(best->timed.begin(), best->timed.end(), later);
+        when = best->timed.back().when;
+        task = std::move(best->timed.back().task);
+        best->timed.pop_back();
+        return true;
+    }
+}
+
+void Executor::Shutdown() {
+    ExecutorState &s = state();
+    std::lock_guard<std::mutex> lk(s.controlMutex);
+    if (!s.running) return;
+    stop_lanes(s);
+    s.epoch.fetch_add(1, std::memory_order_acq_rel);
+    s.running.store(false, std::memory_order_release);
+}
+
+bool Executor::Running() noexcept {
+    return state().running.load(std::memory_order_acquire);
+}
+
+std::uint64_t Executor::Epoch() noexcept {
+    return state().epoch.load(std::memory_order_acquire);
+}
+
+} // namespace common
+} // namespace diagnostic_manager
@@ -0,0 +1,106 @@
+#include "common/dm_latency_trace.h"
+
+#include <ctime>
+
+namespace diagnostic_manager {
+namespace common {
+
+std::atomic<bool> LatencyTrace::enabled_{false};
+
+namespace {
+
+AtomicLatencyHistogram g_stages[kTraceStages];   // written by every reporting and notifier thread
+
+thread_local const TraceContext *t_current = nullptr;
+
+} // namespace
+
+std::size_t LatencyHistogram::BucketOf(std::uint64_t ns) noexcept {
+    if (ns < 8) return static_cast<std::size_t>(ns);
+    const unsigned e = 63u - static_cast<unsigned>(__builtin_clzll(ns));
+    return (e - 2) * 8 + static_cast<std::size_t>((ns >> (e - 3)) & 7);
+}
+
+std::uint64_t LatencyHistogram::BucketUpperNs(std::size_t bucket) noexcept {
+    if (bucket < 8) return bucket;
+    const unsigned e = static_cast<unsigned>(bucket / 8) + 2;
+    const std::uint64_t lower = (8ull + bucket % 8) << (e - 3);
+    return lower + ((1ull << (e - 3)) - 1);
+}
+
+std::uint64_t LatencyHistogram::PercentileNs(double q) const noexcept {
+    if (count == 0) return 0;
+    if (q < 0) q = 0;
+    if (q > 1) q = 1;
+    // rank of the sample, 1-based
+    std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(count));
+    if (rank == 0) rank = 1;
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b < kLatencyBuckets; ++b) {
+        seen += buckets[b];
+        if (seen >= rank) {
+            const std::uint64_t upper = BucketUpperNs(b);
+            return upper < maxNs ? upper : maxNs;
+        }
+    }
+    return maxNs;
+}
+
+std::uint64_t LatencyTrace::NowNs() noexcept {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+void AtomicLatencyHistogram::Add(std::uint64_t ns) noexcept {
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sumNs_.fetch_add(ns, std::memory_order_relaxed);
+    buckets_[LatencyHistogram::BucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t prev = maxNs_.load(std::memory_order_relaxed);
+    while (ns > prev && !maxNs_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+}
+
+LatencyHistogram AtomicLatencyHistogram::Load() const noexcept {
+    LatencyHistogram h;
+    h.count = count_.load(std::memory_order_relaxed);
+    h.sumNs = sumNs_.load(std::memory_order_relaxed);
+    h.maxNs = maxNs_.load(std::memory_order_relaxed);
+    for (std::size_t b = 0; b < kLatencyBuckets; ++b) h.buckets[b] = buckets_[b].load(std::memory_order_relaxed);
+    return h;
+}
+
+void AtomicLatencyHistogram::Clear() noexcept {
+    count_.store(0, std::memory_order_relaxed);
+    sumNs_.store(0, std::memory_order_relaxed);
+    maxNs_.store(0, std::memory_order_relaxed);
+    for (auto &b : buckets_) b.store(0, std::memory_order_relaxed);
+}
+
+void LatencyTrace::Record(TraceStage stage, std::uint64_t fromNs, std::uint64_t toNs) noexcept {
+    g_stages[static_cast<std::size_t>(stage)].Add(toNs > fromNs ? toNs - fromNs : 0);
+}
+
+LatencyTraceStatistics LatencyTrace::GetStatistics() {
+    LatencyTraceStatistics out;
+    for (std::size_t i = 0; i < kTraceStages; ++i) out.stages[i] = g_stages[i].Load();
+    return out;
+}
+
+void LatencyTrace::Reset() {
+    for (AtomicLatencyHistogram &h : g_stages) h.Clear();
+}
+
+const TraceContext *LatencyTrace::Current() noexcept {
+    return t_current;
+}
+
+TraceContextScope::TraceContextScope(const TraceContext *ctx) noexcept : previous_(t_current) {
+    t_current = ctx;
+}
+
+TraceContextScope::~TraceContextScope() {
+    t_current = previous_;
+}
+
+} // namespace common
+} // namespace diagnostic_manager
@@ -0,0 +1,226 @@
+#include "common/dm_lock_profile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+namespace diagnostic_manager {
+namespace common {
+
+#if defined(DM_LOCK_PROFILE)
+
+namespace {
+
+constexpr std::size_t kMaxLockClasses = 32;
+constexpr const char *kOtherSite = "(other)";
+
+// Updated by the lock's owner, but instances sharing a name may be owned
+// by different threads at once.
+struct SiteCounters {
+    std::atomic<const char *> site{nullptr};
+    std::atomic<std::uint64_t> acquisitions{0};
+    std::atomic<std::uint64_t> contended{0};
+    std::atomic<std::uint64_t> waitNs{0};
+    std::atomic<std::uint64_t> holdNs{0};
+};
+
+} // namespace
+
+struct LockClass {
+    const char *name{nullptr};
+    std::atomic<std::uint64_t> acquisitions{0};
+    std::atomic<std::uint64_t> contended{0};
+    AtomicLatencyHistogram wait;
+    AtomicLatencyHistogram hold;
+    SiteCounters sites[kMaxLockSites + 1];   // the last one is kOtherSite
+};
+
+namespace {
+
+LockClass g_classes[kMaxLockClasses];
+std::size_t g_classCount{0};   // g_classMutex
+std::mutex g_classMutex;
+
+// The class of `name`, created on first use; nullptr once the table is full.
+LockClass *class_of(const char *name) {
+    std::lock_guard<std::mutex> lk(g_classMutex);
+    for (std::size_t i = 0; i < g_classCount; ++i) {
+        if (std::strcmp(g_classes[i].name, name) == 0) return &g_classes[i];
+    }
+    if (g_classCount == kMaxLockClasses) return nullptr;
+    LockClass &c = g_classes[g_classCount++];
+    c.name = name;
+    c.sites[kMaxLockSites].site.store(kOtherSite, std::memory_order_relaxed);
+    return &c;
+}
+
+// Site names are string literals, compared by address.
+SiteCounters &site_of(LockClass &c, const char *site) {
+    for (std::size_t i = 0; i < kMaxLockSites; ++i) {
+        const char *cur = c.sites[i].site.load(std::memory_order_acquire);
+        if (cur == site) return c.sites[i];
+        if (cur == nullptr) {
+            if (c.sites[i].site.compare_exchange_strong(cur, site, std::memory_order_acq_rel) || cur == site) {
+                return c.sites[i];
+            }
+        }
+    }
+    return c.sites[kMaxLockSites];
+}
+
+void add(std::atomic<std::uint64_t> &counter, std::uint64_t n) {
+    counter.fetch_add(n, std::memory_order_relaxed);
+}
+
+} // namespace
+
+void ProfiledMutex::lock(const char *site) {
+    if (mutex_.try_lock()) {
+        Acquired(site, 0, false);
+        return;
+    }
+    const std::uint64_t start = LatencyTrace::NowNs();
+    mutex_.lock();
+    Acquired(site, LatencyTrace::NowNs() - start, true);
+}
+
+bool ProfiledMutex::try_lock(const char *site) {
+    if (!mutex_.try_lock()) return false;
+    Acquired(site, 0, false);
+    return true;
+}
+
+void ProfiledMutex::Acquired(const char *site, std::uint64_t waitNs, bool contended) {
+    if (class_ == nullptr) class_ = class_of(name_);
+    if (class_ != nullptr) {
+        add(class_->acquisitions, 1);
+        add(class_->contended, contended ? 1 : 0);
+        class_->wait.Add(waitNs);
+        SiteCounters &s = site_of(*class_, site);
+        add(s.acquisitions, 1);
+        add(s.contended, contended ? 1 : 0);
+        add(s.waitNs, waitNs);
+        site_ = &s;
+    }
+    acquiredNs_ = LatencyTrace::NowNs();
+}
+
+void ProfiledMutex::unlock() {
+    if (class_ != nullptr) {
+        const std::uint64_t held = LatencyTrace::NowNs() - acquiredNs_;
+        class_->hold.Add(held);
+        add(static_cast<SiteCounters *>(site_)->holdNs, held);
+    }
+    mutex_.unlock();
+}
+
+std::vector<LockStatistics> LockProfile::GetStatistics() {
+    std::vector<LockStatistics> out;
+    std::lock_guard<std::mutex> lk(g_classMutex);
+    for (std::size_t i = 0; i < g_classCount; ++i) {
+        const LockClass &c = g_classes[i];
+        LockStatistics s;
+        s.name = c.name;
+        s.acquisitions = c.acquisitions.load(std::memory_order_relaxed);
+        s.contended = c.contended.load(std::memory_order_relaxed);
+        s.wait = c.wait.Load();
+        s.hold = c.hold.Load();
+        for (const SiteCounters &site : c.sites) {
+            const char *name = site.site.load(std::memory_order_acquire);
+            const std::uint64_t acquisitions = site.acquisitions.load(std::memory_order_relaxed);
+            if (name == nullptr || acquisitions == 0) continue;
+            s.sites.push_back(LockSiteStatistics{name, acquisitions, site.contended.load(std::memory_order_relaxed),
+                                                 site.waitNs.load(std::memory_order_relaxed),
+                                                 site.holdNs.load(std::memory_order_relaxed)});
+        }
+        std::sort(s.sites.begin(), s.sites.end(), [](const LockSiteStatistics &a, const LockSiteStatistics &b) {
+            return a.waitNs != b.waitNs ? a.waitNs > b.waitNs : a.holdNs > b.holdNs;
+        });
+        out.push_back(std::move(s));
+    }
+    std::sort(out.begin(), out.end(), [](const LockStatistics &a, const LockStatistics &b) {
+        return a.wait.sumNs > b.wait.sumNs;
+    });
+    return out;
+}
+
+void LockProfile::Reset() {
+    std::lock_guard<std::mutex> lk(g_classMutex);
+    for (std::size_t i = 0; i < g_classCount; ++i) {
+        LockClass &c = g_classes[i];
+        c.acquisitions.store(0, std::memory_order_relaxed);
+        c.contended.store(0, std::memory_order_relaxed);
+        c.wait.Clear();
+        c.hold.Clear();
+        for (SiteCounters &site : c.sites) {   // names are kept
+            site.acquisitions.store(0, std::memory_order_relaxed);
+            site.contended.store(0, std::memory_order_relaxed);
+            site.waitNs.store(0, std::memory_order_relaxed);
+            site.holdNs.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+#else
+
+std::vector<LockStatistics> LockProfile::GetStatistics() {
+    return {};
+}
+
+void LockProfile::Reset() {}
+
+#endif
+
+static double percent(std::uint64_t part, std::uint64_t whole) {
+    return whole == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(whole);
+}
+
+static double us(std::uint64_t ns) {
+    return static_cast<double>(ns) / 1000.0;
+}
+
+static double ms(std::uint64_t ns) {
+    return static_cast<double>(ns) / 1e6;
+}
+
+void LockProfile::Dump(std::FILE *out, std::size_t topSites) {
+    if (!Compiled()) {
+        std::fprintf(out, "lock profile: not compiled in (build with -DDM_LOCK_PROFILE=ON)\n");
+        return;
+    }
+    const std::vector<LockStatistics> locks = GetStatistics();
+    std::fprintf(out, "lock profile: %zu lock(s), by total wait\n", locks.size());
+    for (const LockStatistics &l : locks) {
+        std::fprintf(out,
+                     "%-24s %12llu acq %6.2f%% contended | wait us p50 %.2f p99 %.2f p999 %.2f max %.2f, total %.3f ms"
+                     " | hold us p50 %.2f p99 %.2f max %.2f, total %.3f ms\n",
+                     l.name, static_cast<unsigned long long>(l.acquisitions), percent(l.contended, l.acquisitions),
+                     us(l.wait.PercentileNs(0.5)), us(l.wait.PercentileNs(0.99)), us(l.wait.PercentileNs(0.999)),
+                     us(l.wait.maxNs), ms(l.wait.sumNs), us(l.hold.PercentileNs(0.5)), us(l.hold.PercentileNs(0.99)),
+                     us(l.hold.maxNs), ms(l.hold.sumNs));
+        for (std::size_t i = 0; i < l.sites.size() && i < topSites; ++i) {
+            const LockSiteStatistics &s = l.sites[i];
+            std::fprintf(out, "  %-30s %12llu acq %6.2f%% contended, wait %.3f ms, hold %.3f ms\n", s.site,
+                         static_cast<unsigned long long>(s.acquisitions), percent(s.contended, s.acquisitions),
+                         ms(s.waitNs), ms(s.holdNs));
+        }
+    }
+    std::fflush(out);
+}
+
+ara::core::Result<void> LockProfile::DumpToFile(const std::string &path, std::size_t topSites) {
+    if (path == "-") {
+        Dump(stderr, topSites);
+        return ara::core::Result<void>{};
+    }
+    std::FILE *f = std::fopen(path.c_str(), "a");
+    if (f == nullptr) return ara::core::Result<void>{ std::error_code(errno, std::generic_category()) };
+    Dump(f, topSites);
+    std::fclose(f);
+    return ara::core::Result<void>{};
+}
+
+} // namespace common
+} // namespace diagnostic_manager
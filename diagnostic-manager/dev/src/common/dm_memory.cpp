@@ -0,0 +1,182 @@
+#include "common/dm_memory.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <system_error>
+
+namespace diagnostic_manager {
+namespace common {
+
+namespace {
+
+std::atomic<bool> g_initialized{false};
+std::atomic<bool> g_abortOnHeap{false};
+std::atomic<std::uint64_t> g_heapAfterInit{0};
+std::atomic<std::uint64_t> g_heapAllocations{0};
+std::atomic<std::size_t> g_heapBytes{0};
+std::atomic<AllocationHook> g_hook{nullptr};
+std::atomic<void *> g_hookContext{nullptr};
+
+// Upstream of the arena: the heap, counted after Initialize().
+class HeapResource final : public std::pmr::memory_resource {
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+        g_heapBytes.fetch_add(bytes, std::memory_order_relaxed);
+        if (g_initialized.load(std::memory_order_acquire)) {
+            g_heapAfterInit.fetch_add(1, std::memory_order_relaxed);
+            if (g_abortOnHeap.load(std::memory_order_relaxed)) std::abort();
+        }
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+};
+
+// The monotonic arena, shared by all pools.
+class ArenaResource final : public std::pmr::memory_resource {
+public:
+    ArenaResource(std::size_t bytes, std::pmr::memory_resource *upstream)
+        : buffer_(bytes > 0 ? new std::max_align_t[(bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)]
+                            : nullptr),
+          arena_(buffer_ ? static_cast<void *>(buffer_.get()) : nullptr, buffer_ ? bytes : 1, upstream) {}
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        std::lock_guard<std::mutex> lk(mutex_);
+        return arena_.allocate(bytes, alignment);
+    }
+    void do_deallocate(void *, std::size_t, std::size_t) override {}   // monotonic
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+    std::unique_ptr<std::max_align_t[]> buffer_;
+    std::mutex mutex_;
+    std::pmr::monotonic_buffer_resource arena_;
+};
+
+struct Pools {
+    explicit Pools(const MemoryConfig &cfg)
+        : arena(cfg.arenaBytes, &heap),
+          pools(std::pmr::pool_options{cfg.maxBlocksPerChunk, cfg.largestPooledBlock}, &arena) {}
+
+    HeapResource heap;
+    ArenaResource arena;
+    std::pmr::synchronized_pool_resource pools;
+};
+
+std::mutex g_configMutex;
+MemoryConfig g_config;
+std::atomic<Pools *> g_pools{nullptr};   // never destroyed: statics of other modules free into it at exit
+
+Pools &pools() {
+    Pools *p = g_pools.load(std::memory_order_acquire);
+    if (p != nullptr) return *p;
+    std::lock_guard<std::mutex> lk(g_configMutex);
+    p = g_pools.load(std::memory_order_relaxed);
+    if (p == nullptr) {
+        p = new Pools(g_config);
+        g_pools.store(p, std::memory_order_release);
+    }
+    return *p;
+}
+
+// What DmMemory::Resource(subsystem) hands out: the shared pools, created
+// on first use, with the subsystem's counters.
+class SubsystemResource final : public std::pmr::memory_resource {
+public:
+    MemorySubsystem subsystem{MemorySubsystem::Other};
+    std::atomic<std::int64_t> bytes{0};       // allocated through this resource
+    std::atomic<std::int64_t> tracked{0};     // DmMemory::Track
+    std::atomic<std::int64_t> objects{0};
+    std::atomic<std::uint64_t> allocations{0};
+
+private:
+    void *do_allocate(std::size_t n, std::size_t alignment) override {
+        void *p = pools().pools.allocate(n, alignment);
+        bytes.fetch_add(static_cast<std::int64_t>(n), std::memory_order_relaxed);
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        if (const AllocationHook hook = g_hook.load(std::memory_order_acquire)) {
+            hook(AllocationEvent{subsystem, n, ApiCallScope::Current()}, g_hookContext.load(std::memory_order_relaxed));
+        }
+        return p;
+    }
+    void do_deallocate(void *p, std::size_t n, std::size_t alignment) override {
+        pools().pools.deallocate(p, n, alignment);
+        bytes.fetch_sub(static_cast<std::int64_t>(n), std::memory_order_relaxed);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+};
+
+// Never destroyed: they outlive the containers of every module.
+SubsystemResource *subsystem_resources() noexcept {
+    static SubsystemResource *resources = [] {
+        auto *r = new SubsystemResource[kMemorySubsystems];
+        for (std::size_t i = 0; i < kMemorySubsystems; ++i) r[i].subsystem = static_cast<MemorySubsystem>(i);
+        return r;
+    }();
+    return resources;
+}
+
+std::size_t clamp_size(std::int64_t n) noexcept {
+    return n > 0 ? static_cast<std::size_t>(n) : 0;
+}
+
+} // namespace
+
+ara::core::Result<void> DmMemory::Configure(const MemoryConfig &cfg) {
+    std::lock_guard<std::mutex> lk(g_configMutex);
+    if (g_pools.load(std::memory_order_relaxed) != nullptr) {
+        return ara::core::Result<void>{ std::make_error_code(std::errc::device_or_resource_busy) };
+    }
+    g_config = cfg;
+    g_abortOnHeap.store(cfg.abortOnHeapAfterInit, std::memory_order_relaxed);
+    return ara::core::Result<void>{};
+}
+
+std::pmr::memory_resource *DmMemory::Resource() noexcept {
+    return Resource(MemorySubsystem::Other);
+}
+
+std::pmr::memory_resource *DmMemory::Resource(MemorySubsystem subsystem) noexcept {
+    return &subsystem_resources()[static_cast<std::size_t>(subsystem)];
+}
+
+void DmMemory::Track(MemorySubsystem subsystem, std::ptrdiff_t objects, std::ptrdiff_t bytes) noexcept {
+    SubsystemResource &r = subsystem_resources()[static_cast<std::size_t>(subsystem)];
+    r.objects.fetch_add(objects, std::memory_order_relaxed);
+    r.tracked.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+MemoryStatistics DmMemory::GetMemoryStatistics() noexcept {
+    MemoryStatistics stats;
+    for (std::size_t i = 0; i < kMemorySubsystems; ++i) {
+        const SubsystemResource &r = subsystem_resources()[i];
+        stats.subsystems[i].bytes = clamp_size(r.bytes.load(std::memory_order_relaxed) + r.tracked.load(std::memory_order_relaxed));
+        stats.subsystems[i].objects = clamp_size(r.objects.load(std::memory_order_relaxed));
+        stats.subsystems[i].allocations = r.allocations.load(std::memory_order_relaxed);
+    }
+    if (g_pools.load(std::memory_order_acquire) != nullptr) {
+        std::lock_guard<std::mutex> lk(g_configMutex);
+        stats.arenaBytes = g_config.arenaBytes;
+    }
+    stats.heapAllocations = g_heapAllocations.load(std::memory_order_relaxed);
+    stats.heapBytes = g_heapBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void DmMemory::SetAllocationHook(AllocationHook hook, void *context) noexcept {
+    g_hookContext.store(context, std::memory_order_relaxed);
+    g_hook.store(hook, std::memory_order_release);
+}
+
+void DmMemory::Initialize() { g_initialized.store(true, std::memory_order_release); }
+
+bool DmMemory::Initialized() noexcept { return g_initialized.load(std::memory_order_acquire); }
+
+std::uint64_t DmMemory::HeapAllocationsAfterInit() noexcept { return g_heapAfterInit.load(std::memory_order_relaxed); }
+
+} // namespace common
+} // namespace diagnostic_manager
@@ -0,0 +1,105 @@
+#include "common/dm_perfect_hash.h"
+
+#include <algorithm>
+#include <system_error>
+#include <utility>
+
+namespace diagnostic_manager {
+namespace common {
+
+namespace {
+
+constexpr std::size_t kKeysPerBucket = 3;   // average bucket size
+constexpr unsigned kSeedAttempts = 32;
+constexpr std::uint32_t kMaxDisplacement = 1u << 20;
+} // namespace
+
+ara::core::Result<PerfectHash> PerfectHash::Build(const std::string_view *keys, std::size_t count,
+                                                  std::pmr::memory_resource *resource) {
+    const std::size_t n = count;
+    PerfectHash ph(resource);
+    if (n == 0) return ara::core::Result<PerfectHash>{ std::move(ph) };
+    if (n >= kDirect) return ara::core::Result<PerfectHash>{ std::make_error_code(std::errc::invalid_argument) };
+    ph.size_ = n;
+
+    const std::size_t bucketCount = (n + kKeysPerBucket - 1) / kKeysPerBucket;
+    std::pmr::vector<std::uint64_t> hashes(n, resource);
+    std::pmr::vector<std::uint32_t> bucketStart(bucketCount + 1, resource);
+    std::pmr::vector<std::uint32_t> bucketKeys(n, resource);
+    std::pmr::vector<std::uint32_t> order(bucketCount, resource);
+    std::pmr::vector<std::uint32_t> fill(bucketCount, resource);
+    std::pmr::vector<std::uint32_t> pos(resource);
+    std::pmr::vector<bool> taken(resource);
+
+    for (unsigned attempt = 0; attempt < kSeedAttempts; ++attempt) {
+        ph.seed_ = Hash(std::string_view(reinterpret_cast<const char *>(&attempt), sizeof(attempt)), 0x9e3779b97f4a7c15ull);
+        ph.displacements_.assign(bucketCount, 0);
+        taken.assign(n, false);
+
+        // group keys by bucket (counting sort); bigger buckets are placed first
+        std::fill(bucketStart.begin(), bucketStart.end(), 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            hashes[i] = Hash(keys[i], ph.seed_);
+            ++bucketStart[Range(static_cast<std::uint32_t>(hashes[i] >> 32), bucketCount) + 1];
+        }
+        for (std::size_t b = 0; b < bucketCount; ++b) bucketStart[b + 1] += bucketStart[b];
+        std::copy(bucketStart.begin(), bucketStart.end() - 1, fill.begin());
+        for (std::size_t i = 0; i < n; ++i) {
+            bucketKeys[fill[Range(static_cast<std::uint32_t>(hashes[i] >> 32), bucketCount)]++] = static_cast<std::uint32_t>(i);
+        }
+        for (std::size_t b = 0; b < bucketCount; ++b) order[b] = static_cast<std::uint32_t>(b);
+        std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return bucketStart[a + 1] - bucketStart[a] > bucketStart[b + 1] - bucketStart[b];
+        });
+
+        bool placedAll = true;
+        std::uint32_t nextFree = 0;   // for single-key buckets, which come last
+        for (std::uint32_t b : order) {
+            const std::uint32_t first = bucketStart[b], size = bucketStart[b + 1] - first;
+            if (size == 0) break;   // sorted by size: the rest are empty
+            const std::uint32_t *members = &bucketKeys[first];
+            if (size == 1) {
+                while (taken[nextFree]) ++nextFree;
+                taken[nextFree] = true;
+                ph.displacements_[b] = kDirect | nextFree;
+                continue;
+            }
+
+            // equal keys always hash alike and share a bucket
+            for (std::uint32_t i = 0; i < size; ++i) {
+                for (std::uint32_t j = i + 1; j < size; ++j) {
+                    if (hashes[members[i]] == hashes[members[j]] && keys[members[i]] == keys[members[j]]) {
+                        return ara::core::Result<PerfectHash>{ std::make_error_code(std::errc::invalid_argument) };
+                    }
+                }
+            }
+
+            // try d = 0, 1, ... until all members land in free, distinct slots
+            pos.resize(size);
+            bool placed = false;
+            for (std::uint32_t d = 0; d < kMaxDisplacement; ++d) {
+                bool free = true;
+                for (std::uint32_t i = 0; i < size && free; ++i) {
+                    pos[i] = Position(hashes[members[i]], d, n);
+                    free = !taken[pos[i]];
+                    for (std::uint32_t j = 0; j < i && free; ++j) free = pos[j] != pos[i];
+                }
+                if (free) {
+                    for (std::uint32_t i = 0; i < size; ++i) taken[pos[i]] = true;
+                    ph.displacements_[b] = d;
+                    placed = true;
+                    break;
+                }
+            }
+            if (!placed) {
+                placedAll = false;   // new seed
+                break;
+            }
+        }
+        if (placedAll) return ara::core::Result<PerfectHash>{ std::move(ph) };
+    }
+    return ara::core::Result<PerfectHash>{ std::make_error_code(std::errc::resource_unavailable_try_again) };
+}
+
+} // namespace common
+} // namespace diagnostic_manager
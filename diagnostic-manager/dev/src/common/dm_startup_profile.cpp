@@ -0,0 +1,67 @@
+#include "common/dm_startup_profile.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+namespace diagnostic_manager {
+namespace common {
+
+std::atomic<bool> StartupProfile::enabled_{false};
+
+static std::mutex g_profileMutex;
+static StartupProfile::Clock::time_point g_origin;
+static std::vector<StartupPhase> g_phases;
+static std::string g_outputPath;
+
+static std::uint64_t us_since_origin(StartupProfile::Clock::time_point t) {
+    if (t <= g_origin) return 0;
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(t - g_origin).count());
+}
+
+void StartupProfile::Begin() {
+    std::lock_guard<std::mutex> lk(g_profileMutex);
+    g_origin = Clock::now();
+    g_phases.clear();
+    const char *path = std::getenv(kStartupProfileEnv);
+    g_outputPath = path != nullptr ? path : "";
+    enabled_.store(!g_outputPath.empty(), std::memory_order_relaxed);
+}
+
+void StartupProfile::Record(const char *name, Clock::time_point start, Clock::time_point end) {
+    if (!Enabled()) return;
+    std::lock_guard<std::mutex> lk(g_profileMutex);
+    const std::uint64_t startUs = us_since_origin(start);
+    const std::uint64_t endUs = us_since_origin(end);
+    g_phases.push_back(StartupPhase{name, startUs, endUs > startUs ? endUs - startUs : 0});
+}
+
+void StartupProfile::Ready() {
+    const auto now = Clock::now();
+    if (!enabled_.exchange(false, std::memory_order_relaxed)) return;
+    std::lock_guard<std::mutex> lk(g_profileMutex);
+
+    FILE *out = g_outputPath == "-" ? stderr : std::fopen(g_outputPath.c_str(), "w");
+    if (out == nullptr) {
+        std::fprintf(stderr, "%s: cannot write startup profile: %s\n", g_outputPath.c_str(), std::strerror(errno));
+        return;
+    }
+    for (const StartupPhase &p : g_phases) {
+        std::fprintf(out, "{\"phase\":\"%s\",\"start_us\":%llu,\"duration_us\":%llu}\n", p.name,
+                     static_cast<unsigned long long>(p.startUs), static_cast<unsigned long long>(p.durationUs));
+    }
+    std::fprintf(out, "{\"ready_us\":%llu,\"phases\":%zu}\n", static_cast<unsigned long long>(us_since_origin(now)),
+                 g_phases.size());
+    if (out != stderr) std::fclose(out);
+}
+
+std::vector<StartupPhase> StartupProfile::Phases() {
+    std::lock_guard<std::mutex> lk(g_profileMutex);
+    return g_phases;
+}
+
+} // namespace common
+} // namespace diagnostic_manager
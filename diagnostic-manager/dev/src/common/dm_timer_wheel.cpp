@@ -0,0 +1,143 @@
+#include "common/dm_timer_wheel.h"
+
+#include <algorithm>
+
+namespace diagnostic_manager {
+namespace common {
+
+TimerWheel::TimerWheel(Clock::duration resolution, Clock::time_point origin, std::pmr::memory_resource *resource)
+    : resolution_(resolution.count() > 0 ? resolution : Clock::duration(1)),
+      origin_(origin),
+      nodes_(resource),
+      freeNodes_(resource) {}
+
+std::uint64_t TimerWheel::ToTick(Clock::time_point t) const {
+    if (t <= origin_) return 0;
+    return static_cast<std::uint64_t>((t - origin_) / resolution_);
+}
+
+TimerWheel::TimerId TimerWheel::Schedule(Clock::time_point deadline, std::uint64_t payload) {
+    std::uint32_t id;
+    if (!freeNodes_.empty()) {
+        id = freeNodes_.back();
+        freeNodes_.pop_back();
+    } else {
+        if (nodes_.empty()) nodes_.emplace_back();   // the sentinel, allocated lazily: the ctor runs in static init
+        id = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    Node &n = nodes_[id];
+    // Round up so a timer never fires before its deadline.
+    const std::uint64_t tick = ToTick(deadline) + ((deadline - origin_) % resolution_ != Clock::duration::zero());
+    n.tick = std::max(tick, now_ + 1);
+    n.payload = payload;
+    n.armed = true;
+    Insert(id);
+    ++armed_;
+    return id;
+}
+
+void TimerWheel::Cancel(TimerId &id) {
+    if (id == kNoTimer) return;
+    if (id < nodes_.size() && nodes_[id].armed) {
+        Unlink(id);
+        nodes_[id].armed = false;
+        freeNodes_.push_back(id);
+        --armed_;
+    }
+    id = kNoTimer;
+}
+
+void TimerWheel::Insert(std::uint32_t id) {
+    Node &n = nodes_[id];
+    const std::uint64_t delta = n.tick > now_ ? n.tick - now_ : 0;
+    unsigned level = 0;
+    while (level + 1 < kLevels && delta >= (std::uint64_t{1} << (kSlotBits * (level + 1)))) ++level;
+    // Beyond the top level: park in the last reachable slot, re-sorted on cascade.
+    const std::uint64_t span = std::uint64_t{1} << (kSlotBits * kLevels);
+    const std::uint64_t tick = delta >= span ? now_ + span - 1 : n.tick;
+    const unsigned slot = static_cast<unsigned>((tick >> (kSlotBits * level)) & (kSlots - 1));
+
+    n.bucket = static_cast<std::uint16_t>(level * kSlots + slot);
+    n.prev = kNil;
+    n.next = heads_[n.bucket];
+    if (n.next != kNil) nodes_[n.next].prev = id;
+    heads_[n.bucket] = id;
+    occupied_[level] |= std::uint64_t{1} << slot;
+}
+
+void TimerWheel::Unlink(std::uint32_t id) {
+    Node &n = nodes_[id];
+    if (n.prev != kNil) nodes_[n.prev].next = n.next;
+    else heads_[n.bucket] = n.next;
+    if (n.next != kNil) nodes_[n.next].prev = n.prev;
+    if (heads_[n.bucket] == kNil) occupied_[n.bucket / kSlots] &= ~(std::uint64_t{1} << (n.bucket % kSlots));
+}
+
+// Re-insert the slot of `level` that now_ has reached; its timers move down.
+void TimerWheel::Cascade(unsigned level) {
+    const unsigned slot = static_cast<unsigned>((now_ >> (kSlotBits * level)) & (kSlots - 1));
+    const std::size_t bucket = level * kSlots + slot;
+    std::uint32_t id = heads_[bucket];
+    heads_[bucket] = kNil;
+    occupied_[level] &= ~(std::uint64_t{1} << slot);
+    while (id != kNil) {
+        const std::uint32_t next = nodes_[id].next;
+        Insert(id);
+        id = next;
+    }
+}
+
+void TimerWheel::Advance(Clock::time_point now, std::pmr::vector<std::uint64_t> &expired) {
+    const std::uint64_t target = ToTick(now);
+    while (now_ < target && armed_ != 0) {
+        ++now_;
+        for (unsigned level = 1; level < kLevels; ++level) {
+            if ((now_ & ((std::uint64_t{1} << (kSlotBits * level)) - 1)) != 0) break;
+            Cascade(level);
+        }
+
+        const unsigned slot = static_cast<unsigned>(now_ & (kSlots - 1));
+        std::uint32_t id = heads_[slot];
+        heads_[slot] = kNil;
+        occupied_[0] &= ~(std::uint64_t{1} << slot);
+        while (id != kNil) {
+            Node &n = nodes_[id];
+            const std::uint32_t next = n.next;
+            n.armed = false;
+            freeNodes_.push_back(id);
+            --armed_;
+            expired.push_back(n.payload);
+            id = next;
+        }
+
+        // Nothing armed below the next occupied slot: skip the idle ticks.
+        if (occupied_[0] == 0 && armed_ != 0) {
+            const std::uint64_t nextBlock = (now_ | (kSlots - 1));
+            now_ = std::min(nextBlock, target);
+        }
+    }
+    if (armed_ == 0) now_ = std::max(now_, target);
+}
+
+std::optional<TimerWheel::Clock::time_point> TimerWheel::NextWakeup() const {
+    if (armed_ == 0) return std::nullopt;
+    std::uint64_t best = UINT64_MAX;
+    for (unsigned level = 0; level < kLevels; ++level) {
+        if (occupied_[level] == 0) continue;
+        const unsigned shift = kSlotBits * level;
+        const std::uint64_t unit = now_ >> shift;
+        const unsigned current = static_cast<unsigned>(unit & (kSlots - 1));
+        // rotate so bit 0 is the slot after the current one
+        const unsigned rot = (current + 1) & (kSlots - 1);
+        const std::uint64_t mask = (occupied_[level] >> rot) | (rot ? occupied_[level] << (kSlots - rot) : 0);
+        const unsigned distance = static_cast<unsigned>(__builtin_ctzll(mask)) + 1;
+        // level 0 fires at that tick; higher levels cascade at the start of that unit
+        const std::uint64_t tick = (unit + distance) << shift;
+        best = std::min(best, tick);
+    }
+    return origin_ + resolution_ * static_cast<Clock::rep>(best);
+}
+
+}  // namespace common
+}  // namespace diagnostic_manager
@@ -0,0 +1,133 @@
+#include "config/dm_config.h"
+#include "config/dm_manifest.h"
+#include "common/dm_perfect_hash.h"
+#include "common/dm_startup_profile.h"
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace diagnostic_manager {
+namespace config {
+
+using dtc::DMDtc;
+using event::DMEvent;
+using operation_cycle::DMOperationCycle;
+
+static std::optional<Manifest> g_manifest;
+static common::PerfectHash g_monitorIndex;            // manifest monitor names
+static std::vector<std::uint32_t> g_monitorBySlot;     // manifest index of the name in each slot
+static std::mutex g_manifestMutex;
+
+static std::optional<std::uint32_t> find_configured(const event::MonitorId &id) {
+    if (!g_manifest.has_value()) return std::nullopt;
+    if (g_monitorIndex.Size() == 0 || g_monitorIndex.Size() != g_manifest->MonitorCount()) {
+        return g_manifest->FindMonitor(id);   // index could not be built
+    }
+    const std::uint32_t i = g_monitorBySlot[g_monitorIndex.Slot(id)];
+    if (g_manifest->Name(g_manifest->Monitor(i).name) != id) return std::nullopt;
+    return i;
+}
+
+// Register cycles, DTCs and monitors, one bulk call (one lock, one table
+// reservation) each; names are passed as views into the mapping. If a later
+// call fails, the earlier ones are undone.
+static ara::core::Result<void> register_all(const Manifest &m) {
+    std::vector<operation_cycle::OperationCycleRegistration> cycles(m.CycleCount());
+    for (std::size_t i = 0; i < cycles.size(); ++i) cycles[i].id = m.Name(m.Cycle(i).name);
+    std::vector<dtc::DtcRegistration> dtcs(m.DtcCount());
+    for (std::size_t i = 0; i < dtcs.size(); ++i) {
+        dtcs[i].dtc = m.Dtc(i).id;
+        dtcs[i].suppressed = (m.Dtc(i).flags & kDtcSuppressed) != 0;
+    }
+    std::vector<event::MonitorRegistration> monitors(m.MonitorCount());
+    for (std::size_t i = 0; i < monitors.size(); ++i) {
+        monitors[i].id = m.Name(m.Monitor(i).name);
+        monitors[i].cfg = m.DebounceConfigOf(m.Monitor(i));
+    }
+
+    auto res = [&] {
+        common::StartupPhaseScope phase("register.operation_cycles");
+        return DMOperationCycle::RegisterOperationCycles(cycles.data(), cycles.size());
+    }();
+    if (res.HasError()) return res;
+    res = [&] {
+        common::StartupPhaseScope phase("register.dtcs");
+        return DMDtc::RegisterDtcs(dtcs.data(), dtcs.size());
+    }();
+    if (res.HasError()) {
+        for (const auto &c : cycles) DMOperationCycle::UnregisterOperationCycle(std::string(c.id));
+        return res;
+    }
+    res = [&] {
+        common::StartupPhaseScope phase("register.monitors");
+        return DMEvent::RegisterMonitors(monitors.data(), monitors.size());
+    }();
+    if (res.HasError()) {
+        for (const auto &d : dtcs) DMDtc::UnregisterDtc(d.dtc);
+        for (const auto &c : cycles) DMOperationCycle::UnregisterOperationCycle(std::string(c.id));
+    }
+    return res;
+}
+
+ara::core::Result<ManifestSummary> DMConfig::LoadManifest(const std::string &path) {
+    std::lock_guard<std::mutex> lk(g_manifestMutex);
+    if (g_manifest.has_value()) return ara::core::Result<ManifestSummary>{ std::make_error_code(std::errc::file_exists) };
+
+    auto mapped = [&] {
+        common::StartupPhaseScope phase("config.map");
+        return Manifest::Map(path);
+    }();
+    if (mapped.HasError()) return ara::core::Result<ManifestSummary>{ mapped.Error() };
+    const Manifest &m = mapped.Value();
+
+    auto registered = register_all(m);
+    if (registered.HasError()) return ara::core::Result<ManifestSummary>{ registered.Error() };
+
+    {
+        common::StartupPhaseScope phase("config.index");
+        std::vector<std::string_view> names(m.MonitorCount());
+        for (std::size_t i = 0; i < names.size(); ++i) names[i] = m.Name(m.Monitor(i).name);
+        auto index = common::PerfectHash::Build(names);
+        if (index.HasValue()) {
+            g_monitorIndex = std::move(index).Value();
+            g_monitorBySlot.assign(names.size(), 0);
+            for (std::size_t i = 0; i < names.size(); ++i) g_monitorBySlot[g_monitorIndex.Slot(names[i])] = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    ManifestSummary summary{m.MonitorCount(), m.DtcCount(), m.CycleCount(), m.SizeBytes()};
+    g_manifest.emplace(std::move(mapped).Value());
+    return ara::core::Result<ManifestSummary>{ summary };
+}
+
+bool DMConfig::IsConfiguredMonitor(const event::MonitorId &id) {
+    std::lock_guard<std::mutex> lk(g_manifestMutex);
+    return find_configured(id).has_value();
+}
+
+std::vector<dtc::DtcId> DMConfig::GetDtcsOfMonitor(const event::MonitorId &id) {
+    std::vector<dtc::DtcId> out;
+    std::lock_guard<std::mutex> lk(g_manifestMutex);
+    const auto monitor = find_configured(id);
+    if (!monitor.has_value()) return out;
+    const auto links = g_manifest->DtcsOf(monitor.value());
+    for (auto it = links.first; it != links.second; ++it) out.push_back(g_manifest->Dtc(it->target).id);
+    return out;
+}
+
+std::vector<operation_cycle::OpCycleId> DMConfig::GetOperationCyclesOfMonitor(const event::MonitorId &id) {
+    std::vector<operation_cycle::OpCycleId> out;
+    std::lock_guard<std::mutex> lk(g_manifestMutex);
+    const auto monitor = find_configured(id);
+    if (!monitor.has_value()) return out;
+    const auto links = g_manifest->CyclesOf(monitor.value());
+    for (auto it = links.first; it != links.second; ++it) out.emplace_back(g_manifest->Name(g_manifest->Cycle(it->target).name));
+    return out;
+}
+
+} // namespace config
+} // namespace diagnostic_manager
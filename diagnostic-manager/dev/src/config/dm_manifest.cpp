@@ -0,0 +1,339 @@
+#include "config/dm_manifest.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <set>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "the manifest is read in place as little-endian");
+
+namespace diagnostic_manager {
+namespace config {
+
+using event::DebounceConfig;
+using event::DebounceMode;
+
+static std::uint32_t fnv1a(const std::uint8_t *data, std::size_t size) {
+    std::uint32_t h = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        h ^= data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static ara::core::Result<Manifest> manifest_error(std::errc e) {
+    return ara::core::Result<Manifest>{ std::make_error_code(e) };
+}
+
+// --- Manifest ---
+
+Manifest::Manifest(Manifest &&other) noexcept
+    : data_(other.data_), size_(other.size_), mapping_(other.mapping_), owned_(std::move(other.owned_)) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.mapping_ = nullptr;
+}
+
+Manifest &Manifest::operator=(Manifest &&other) noexcept {
+    if (this != &other) {
+        Release();
+        data_ = other.data_;
+        size_ = other.size_;
+        mapping_ = other.mapping_;
+        owned_ = std::move(other.owned_);
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.mapping_ = nullptr;
+    }
+    return *this;
+}
+
+Manifest::~Manifest() { Release(); }
+
+void Manifest::Release() noexcept {
+    if (mapping_ != nullptr) munmap(mapping_, size_);
+    mapping_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+    owned_.clear();
+}
+
+ara::core::Result<Manifest> Manifest::Map(const std::string &path) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return ara::core::Result<Manifest>{ std::error_code(errno, std::generic_category()) };
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        const int err = errno;
+        close(fd);
+        return ara::core::Result<Manifest>{ std::error_code(err, std::generic_category()) };
+    }
+    if (static_cast<std::size_t>(st.st_size) < sizeof(ManifestHeader)) {
+        close(fd);
+        return manifest_error(std::errc::bad_message);
+    }
+    void *mem = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    const int err = errno;
+    close(fd);   // the mapping stays valid
+    if (mem == MAP_FAILED) return ara::core::Result<Manifest>{ std::error_code(err, std::generic_category()) };
+
+    Manifest m;
+    m.mapping_ = mem;
+    m.data_ = static_cast<const std::uint8_t *>(mem);
+    m.size_ = static_cast<std::size_t>(st.st_size);
+    return Validate(std::move(m));
+}
+
+ara::core::Result<Manifest> Manifest::FromBuffer(std::vector<std::uint8_t> image) {
+    if (image.size() < sizeof(ManifestHeader)) return manifest_error(std::errc::bad_message);
+    Manifest m;
+    m.owned_ = std::move(image);
+    m.data_ = m.owned_.data();
+    m.size_ = m.owned_.size();
+    return Validate(std::move(m));
+}
+
+// Everything the accessors rely on is checked once here, so they can index
+// the tables without bounds checks.
+ara::core::Result<Manifest> Manifest::Validate(Manifest m) {
+    ManifestHeader h;
+    std::memcpy(&h, m.data_, sizeof(h));
+    if (h.magic != kManifestMagic || h.headerSize != sizeof(ManifestHeader) || h.fileSize != m.size_) {
+        return manifest_error(std::errc::bad_message);
+    }
+    if (h.version != kManifestVersion) return manifest_error(std::errc::not_supported);
+    if (fnv1a(m.data_ + h.headerSize, m.size_ - h.headerSize) != h.checksum) return manifest_error(std::errc::bad_message);
+
+    static constexpr std::size_t kEntrySize[kManifestSectionCount] = {
+        1, sizeof(ManifestMonitor), sizeof(ManifestDtc), sizeof(ManifestCycle), sizeof(ManifestLink), sizeof(ManifestLink)};
+    for (std::size_t i = 0; i < kManifestSectionCount; ++i) {
+        const ManifestSection &s = h.sections[i];
+        if (s.offset % 8 != 0 || s.offset < sizeof(ManifestHeader) || s.offset > m.size_ ||
+            static_cast<std::uint64_t>(s.count) * kEntrySize[i] > m.size_ - s.offset) {
+            return manifest_error(std::errc::bad_message);
+        }
+    }
+
+    const std::uint32_t stringBytes = h.sections[static_cast<std::size_t>(ManifestSectionId::Strings)].count;
+    auto stringOk = [&](const ManifestString &s) {
+        return s.length != 0 && s.offset <= stringBytes && s.length <= stringBytes - s.offset;
+    };
+
+    for (std::size_t i = 0; i < m.MonitorCount(); ++i) {
+        const ManifestMonitor &mon = m.Monitor(i);
+        if (!stringOk(mon.name) || mon.mode > static_cast<std::uint8_t>(DebounceMode::MonitorInternal)) {
+            return manifest_error(std::errc::bad_message);
+        }
+        if (i > 0 && !(m.Name(m.Monitor(i - 1).name) < m.Name(mon.name))) return manifest_error(std::errc::bad_message);
+    }
+    for (std::size_t i = 1; i < m.DtcCount(); ++i) {
+        if (m.Dtc(i - 1).id >= m.Dtc(i).id) return manifest_error(std::errc::bad_message);
+    }
+    for (std::size_t i = 0; i < m.CycleCount(); ++i) {
+        if (!stringOk(m.Cycle(i).name)) return manifest_error(std::errc::bad_message);
+        if (i > 0 && !(m.Name(m.Cycle(i - 1).name) < m.Name(m.Cycle(i).name))) return manifest_error(std::errc::bad_message);
+    }
+
+    auto linksOk = [&](ManifestSectionId id, std::size_t targets) {
+        const ManifestLink *links = m.Table<ManifestLink>(id);
+        const std::size_t n = m.Section(id).count;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (links[i].monitor >= m.MonitorCount() || links[i].target >= targets) return false;
+            if (i > 0 && !(links[i - 1].monitor < links[i].monitor ||
+                           (links[i - 1].monitor == links[i].monitor && links[i - 1].target < links[i].target))) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (!linksOk(ManifestSectionId::MonitorDtcs, m.DtcCount()) || !linksOk(ManifestSectionId::MonitorCycles, m.CycleCount())) {
+        return manifest_error(std::errc::bad_message);
+    }
+    return ara::core::Result<Manifest>{ std::move(m) };
+}
+
+DebounceConfig Manifest::DebounceConfigOf(const ManifestMonitor &m) const noexcept {
+    DebounceConfig cfg;
+    cfg.mode = static_cast<DebounceMode>(m.mode);
+    cfg.failedThreshold = m.failedThreshold;
+    cfg.passedThreshold = m.passedThreshold;
+    cfg.failedStep = m.failedStep;
+    cfg.passedStep = m.passedStep;
+    cfg.jumpUp = (m.flags & kMonitorJumpUp) != 0;
+    cfg.jumpDown = (m.flags & kMonitorJumpDown) != 0;
+    cfg.failedJumpValue = m.failedJumpValue;
+    cfg.passedJumpValue = m.passedJumpValue;
+    if (m.flags & kMonitorHasFdcThreshold) cfg.fdcThreshold = m.fdcThreshold;
+    cfg.timeFailedThresholdMs = m.timeFailedThresholdMs;
+    cfg.timePassedThresholdMs = m.timePassedThresholdMs;
+    if (m.flags & kMonitorHasTimeFdcThreshold) cfg.timeFdcThresholdMs = m.timeFdcThresholdMs;
+    return cfg;
+}
+
+std::optional<std::uint32_t> Manifest::FindMonitor(std::string_view name) const noexcept {
+    const ManifestMonitor *first = Table<ManifestMonitor>(ManifestSectionId::Monitors);
+    const ManifestMonitor *last = first + MonitorCount();
+    const ManifestMonitor *it = std::lower_bound(first, last, name,
+        [this](const ManifestMonitor &m, std::string_view n) { return Name(m.name) < n; });
+    if (it == last || Name(it->name) != name) return std::nullopt;
+    return static_cast<std::uint32_t>(it - first);
+}
+
+std::optional<std::uint32_t> Manifest::FindDtc(std::uint32_t id) const noexcept {
+    const ManifestDtc *first = Table<ManifestDtc>(ManifestSectionId::Dtcs);
+    const ManifestDtc *last = first + DtcCount();
+    const ManifestDtc *it = std::lower_bound(first, last, id, [](const ManifestDtc &d, std::uint32_t v) { return d.id < v; });
+    if (it == last || it->id != id) return std::nullopt;
+    return static_cast<std::uint32_t>(it - first);
+}
+
+std::pair<const ManifestLink *, const ManifestLink *> Manifest::LinksOf(ManifestSectionId id, std::uint32_t monitor) const noexcept {
+    if (data_ == nullptr) return {nullptr, nullptr};
+    const ManifestLink *first = Table<ManifestLink>(id);
+    const ManifestLink *last = first + Section(id).count;
+    auto lo = std::lower_bound(first, last, monitor, [](const ManifestLink &l, std::uint32_t v) { return l.monitor < v; });
+    auto hi = std::upper_bound(lo, last, monitor, [](std::uint32_t v, const ManifestLink &l) { return v < l.monitor; });
+    return {lo, hi};
+}
+
+// --- ManifestBuilder ---
+
+void ManifestBuilder::AddMonitor(std::string name, const DebounceConfig &cfg) { monitors_.emplace_back(std::move(name), cfg); }
+void ManifestBuilder::AddDtc(std::uint32_t id, bool suppressed) { dtcs_.emplace_back(id, suppressed); }
+void ManifestBuilder::AddCycle(std::string name) { cycles_.push_back(std::move(name)); }
+void ManifestBuilder::LinkDtc(std::string monitor, std::uint32_t dtc) { dtcLinks_.emplace_back(std::move(monitor), dtc); }
+void ManifestBuilder::LinkCycle(std::string monitor, std::string cycle) { cycleLinks_.emplace_back(std::move(monitor), std::move(cycle)); }
+
+namespace {
+
+// Appends sections to the image, each 8-byte aligned.
+struct ImageWriter {
+    std::vector<std::uint8_t> bytes = std::vector<std::uint8_t>(sizeof(ManifestHeader));
+    ManifestHeader header{};
+
+    template <typename T>
+    void Section(ManifestSectionId id, const T *data, std::size_t count) {
+        bytes.resize((bytes.size() + 7) & ~std::size_t{7});
+        ManifestSection &s = header.sections[static_cast<std::size_t>(id)];
+        s.offset = static_cast<std::uint32_t>(bytes.size());
+        s.count = static_cast<std::uint32_t>(count);
+        const auto *p = reinterpret_cast<const std::uint8_t *>(data);
+        bytes.insert(bytes.end(), p, p + count * sizeof(T));
+    }
+};
+
+} // namespace
+
+ara::core::Result<std::vector<std::uint8_t>> ManifestBuilder::Build() const {
+    using BuildResult = ara::core::Result<std::vector<std::uint8_t>>;
+
+    // sort entities; indices below refer to the sorted order
+    std::vector<const std::pair<std::string, DebounceConfig> *> monitors;
+    for (const auto &m : monitors_) monitors.push_back(&m);
+    std::sort(monitors.begin(), monitors.end(), [](auto *a, auto *b) { return a->first < b->first; });
+    std::vector<std::pair<std::uint32_t, bool>> dtcs = dtcs_;
+    std::sort(dtcs.begin(), dtcs.end());
+    std::vector<std::string> cycles = cycles_;
+    std::sort(cycles.begin(), cycles.end());
+
+    for (std::size_t i = 0; i < monitors.size(); ++i) {
+        if (monitors[i]->first.empty()) return BuildResult{ std::make_error_code(std::errc::invalid_argument) };
+        if (i > 0 && monitors[i - 1]->first == monitors[i]->first) return BuildResult{ std::make_error_code(std::errc::file_exists) };
+    }
+    for (std::size_t i = 1; i < dtcs.size(); ++i) {
+        if (dtcs[i - 1].first == dtcs[i].first) return BuildResult{ std::make_error_code(std::errc::file_exists) };
+    }
+    for (std::size_t i = 0; i < cycles.size(); ++i) {
+        if (cycles[i].empty()) return BuildResult{ std::make_error_code(std::errc::invalid_argument) };
+        if (i > 0 && cycles[i - 1] == cycles[i]) return BuildResult{ std::make_error_code(std::errc::file_exists) };
+    }
+
+    // string table, identical names stored once
+    std::string strings;
+    std::map<std::string, ManifestString> interned;
+    auto intern = [&](const std::string &s) {
+        auto it = interned.find(s);
+        if (it != interned.end()) return it->second;
+        const ManifestString ref{static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(s.size())};
+        strings += s;
+        interned.emplace(s, ref);
+        return ref;
+    };
+
+    std::vector<ManifestMonitor> monitorTable;
+    std::map<std::string, std::uint32_t> monitorIndex;
+    for (const auto *m : monitors) {
+        const DebounceConfig &cfg = m->second;
+        ManifestMonitor e{};
+        e.name = intern(m->first);
+        e.mode = static_cast<std::uint8_t>(cfg.mode);
+        e.flags = static_cast<std::uint8_t>((cfg.jumpUp ? kMonitorJumpUp : 0) | (cfg.jumpDown ? kMonitorJumpDown : 0) |
+                                            (cfg.fdcThreshold ? kMonitorHasFdcThreshold : 0) |
+                                            (cfg.timeFdcThresholdMs ? kMonitorHasTimeFdcThreshold : 0));
+        e.failedThreshold = cfg.failedThreshold;
+        e.passedThreshold = cfg.passedThreshold;
+        e.failedStep = cfg.failedStep;
+        e.passedStep = cfg.passedStep;
+        e.failedJumpValue = cfg.failedJumpValue;
+        e.passedJumpValue = cfg.passedJumpValue;
+        e.fdcThreshold = cfg.fdcThreshold.value_or(0);
+        e.timeFailedThresholdMs = cfg.timeFailedThresholdMs;
+        e.timePassedThresholdMs = cfg.timePassedThresholdMs;
+        e.timeFdcThresholdMs = cfg.timeFdcThresholdMs.value_or(0);
+        monitorIndex.emplace(m->first, static_cast<std::uint32_t>(monitorTable.size()));
+        monitorTable.push_back(e);
+    }
+
+    std::vector<ManifestDtc> dtcTable;
+    for (const auto &d : dtcs) dtcTable.push_back(ManifestDtc{d.first, d.second ? kDtcSuppressed : 0u});
+
+    std::vector<ManifestCycle> cycleTable;
+    for (const std::string &c : cycles) cycleTable.push_back(ManifestCycle{intern(c)});
+
+    std::set<std::pair<std::uint32_t, std::uint32_t>> dtcLinks, cycleLinks;
+    for (const auto &l : dtcLinks_) {
+        auto mon = monitorIndex.find(l.first);
+        auto dtc = std::lower_bound(dtcs.begin(), dtcs.end(), std::make_pair(l.second, false));
+        if (mon == monitorIndex.end() || dtc == dtcs.end() || dtc->first != l.second) {
+            return BuildResult{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        }
+        dtcLinks.emplace(mon->second, static_cast<std::uint32_t>(dtc - dtcs.begin()));
+    }
+    for (const auto &l : cycleLinks_) {
+        auto mon = monitorIndex.find(l.first);
+        auto cyc = std::lower_bound(cycles.begin(), cycles.end(), l.second);
+        if (mon == monitorIndex.end() || cyc == cycles.end() || *cyc != l.second) {
+            return BuildResult{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        }
+        cycleLinks.emplace(mon->second, static_cast<std::uint32_t>(cyc - cycles.begin()));
+    }
+    std::vector<ManifestLink> dtcLinkTable, cycleLinkTable;
+    for (const auto &l : dtcLinks) dtcLinkTable.push_back(ManifestLink{l.first, l.second});
+    for (const auto &l : cycleLinks) cycleLinkTable.push_back(ManifestLink{l.first, l.second});
+
+    ImageWriter w;
+    w.Section(ManifestSectionId::Strings, strings.data(), strings.size());
+    w.Section(ManifestSectionId::Monitors, monitorTable.data(), monitorTable.size());
+    w.Section(ManifestSectionId::Dtcs, dtcTable.data(), dtcTable.size());
+    w.Section(ManifestSectionId::Cycles, cycleTable.data(), cycleTable.size());
+    w.Section(ManifestSectionId::MonitorDtcs, dtcLinkTable.data(), dtcLinkTable.size());
+    w.Section(ManifestSectionId::MonitorCycles, cycleLinkTable.data(), cycleLinkTable.size());
+    w.bytes.resize((w.bytes.size() + 7) & ~std::size_t{7});
+
+    w.header.magic = kManifestMagic;
+    w.header.version = kManifestVersion;
+    w.header.headerSize = sizeof(ManifestHeader);
+    w.header.fileSize = static_cast<std::uint32_t>(w.bytes.size());
+    w.header.checksum = fnv1a(w.bytes.data() + sizeof(ManifestHeader), w.bytes.size() - sizeof(ManifestHeader));
+    std::memcpy(w.bytes.data(), &w.header, sizeof(ManifestHeader));
+    return BuildResult{ std::move(w.bytes) };
+}
+
+} // namespace config
+} // namespace diagnostic_manager
@@ -1,6 +1,13 @@
 #include "dtc/dm_dtc.h"
 
+#include "common/dm_epoch.h"
+#include "common/dm_latency_trace.h"
+#include "common/dm_lock_profile.h"
+#include "common/dm_memory.h"
+
 #include "ara/core/result_future.h"
+#include <memory>
+#include <memory_resource>
 #include <unordered_map>
 #include <mutex>
 #include <system_error>
@@ -9,43 +16,166 @@
 namespace diagnostic_manager {
 namespace dtc {
 
+// What a status report reads; notifier and waiters are in g_dtcCold, which
+// only has entries for DTCs that use them.
 struct DtcInstance {
+    DtcInstance() : hasStatus(0), suppression(0), hasCold(0) {}
+
     UdsStatusByte status{0};
-    bool hasStatus{false};
-    bool suppression{false};
-    DtcStatusNotifier notifier;
+    std::uint8_t hasStatus : 1;
+    std::uint8_t suppression : 1;
+    std::uint8_t hasCold : 1;   // has an entry in g_dtcCold
+};
+static_assert(sizeof(DtcInstance) <= 2, "hot DTC record must stay within 2 bytes");
+
+struct DtcCold {
+    common::EpochSlot<DtcStatusNotifier> notifier;   // called after unlocking, under an epoch pin
+    DtcStatusWaiter *waiters{nullptr};
 };
 
-static std::unordered_map<DtcId, DtcInstance> g_dtcs;
-static std::mutex g_dtcsMutex;
+static std::pmr::unordered_map<DtcId, DtcInstance> g_dtcs{common::DmMemory::Resource(common::MemorySubsystem::Dtcs)};
+static std::pmr::unordered_map<DtcId, DtcCold> g_dtcCold{common::DmMemory::Resource(common::MemorySubsystem::Dtcs)};
+static common::ProfiledMutex g_dtcsMutex{"dtc.registry"};
+
+// g_dtcsMutex held.
+static DtcCold *find_cold(DtcId dtc, const DtcInstance &inst) {
+    return inst.hasCold ? &g_dtcCold.find(dtc)->second : nullptr;
+}
+
+static DtcCold &cold_for(DtcId dtc, DtcInstance &inst) {
+    inst.hasCold = 1;
+    return g_dtcCold[dtc];
+}
+
+// Drop the side entry once it holds nothing; g_dtcsMutex held.
+static void prune_cold(DtcId dtc, DtcInstance &inst, const DtcCold &cold) {
+    if (cold.notifier.Get() != nullptr || cold.waiters != nullptr) return;
+    inst.hasCold = 0;
+    g_dtcCold.erase(dtc);
+}
+
+// Install `next` (may be null); the old notifier is retired.
+static void replace_notifier(DtcCold &cold, std::unique_ptr<DtcStatusNotifier> next) {
+    const std::ptrdiff_t delta = (next ? 1 : 0) - (cold.notifier.Get() != nullptr ? 1 : 0);
+    common::DmMemory::Track(common::MemorySubsystem::Notifiers, delta, delta * static_cast<std::ptrdiff_t>(sizeof(DtcStatusNotifier)));
+    cold.notifier.Reset(std::move(next));
+}
+
+// Remove a DTC with its side entry; returns its waiters. g_dtcsMutex held.
+static DtcStatusWaiter *erase_dtc(std::pmr::unordered_map<DtcId, DtcInstance>::iterator it) {
+    DtcStatusWaiter *waiters = nullptr;
+    if (DtcCold *cold = find_cold(it->first, it->second)) {
+        waiters = cold->waiters;
+        replace_notifier(*cold, nullptr);
+        g_dtcCold.erase(it->first);
+    }
+    g_dtcs.erase(it);
+    common::DmMemory::Track(common::MemorySubsystem::Dtcs, -1);
+    return waiters;
+}
+
+// Replace the notifier of a DTC; the old one is retired. g_dtcsMutex held.
+static void set_notifier(DtcId dtc, DtcInstance &inst, DtcStatusNotifier notifier) {
+    if (!notifier) {
+        if (DtcCold *cold = find_cold(dtc, inst)) {
+            replace_notifier(*cold, nullptr);
+            prune_cold(dtc, inst, *cold);
+        }
+        return;
+    }
+    replace_notifier(cold_for(dtc, inst), std::make_unique<DtcStatusNotifier>(std::move(notifier)));
+}
+
+// Move the waiters matching `inst`'s status to `out`; g_dtcsMutex held.
+static void take_matching_waiters(DtcId dtc, DtcInstance &inst, DtcStatusWaiter *&out) {
+    if (!inst.hasStatus || inst.suppression) return;
+    DtcCold *cold = find_cold(dtc, inst);
+    if (cold == nullptr) return;
+    DtcStatusWaiter **link = &cold->waiters;
+    while (*link != nullptr) {
+        DtcStatusWaiter *w = *link;
+        if ((w->mask & inst.status) == 0) {
+            link = &w->next;
+            continue;
+        }
+        *link = w->next;
+        w->status = inst.status;
+        w->next = out;
+        out = w;
+    }
+    prune_cold(dtc, inst, *cold);
+}
+
+// Fire a detached waiter list; a waiter may be gone once fired.
+static void fire_waiters(DtcStatusWaiter *w, bool unregistered) {
+    while (w != nullptr) {
+        DtcStatusWaiter *next = w->next;
+        w->next = nullptr;
+        w->unregistered = unregistered;
+        w->fire(*w);
+        w = next;
+    }
+}
 
 ara::core::Result<void> DMDtc::RegisterDtc(DtcId dtc, DtcStatusNotifier notifier) {
-    std::lock_guard<std::mutex> lk(g_dtcsMutex);
+    const common::ApiCallScope scope("DMDtc::RegisterDtc");
+    common::ProfiledLockGuard lk(g_dtcsMutex);
     if (g_dtcs.find(dtc) != g_dtcs.end()) {
         return ara::core::Result<void>{ std::make_error_code(std::errc::file_exists) };
     }
-    DtcInstance inst;
-    inst.notifier = std::move(notifier);
-    g_dtcs.emplace(dtc, std::move(inst));
+    set_notifier(dtc, g_dtcs[dtc], std::move(notifier));
+    common::DmMemory::Track(common::MemorySubsystem::Dtcs, 1);
+    return ara::core::Result<void>{};
+}
+
+ara::core::Result<void> DMDtc::RegisterDtcs(const DtcRegistration *dtcs, std::size_t count) {
+    const common::ApiCallScope scope("DMDtc::RegisterDtcs");
+    common::ProfiledLockGuard lk(g_dtcsMutex);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (g_dtcs.count(dtcs[i].dtc) != 0) return ara::core::Result<void>{ std::make_error_code(std::errc::file_exists) };
+    }
+    g_dtcs.reserve(g_dtcs.size() + count);   // at most one rehash
+    for (std::size_t i = 0; i < count; ++i) {
+        auto res = g_dtcs.try_emplace(dtcs[i].dtc);
+        if (!res.second) {
+            // duplicate within the batch: drop what this call added
+            for (std::size_t j = 0; j < i; ++j) erase_dtc(g_dtcs.find(dtcs[j].dtc));
+            return ara::core::Result<void>{ std::make_error_code(std::errc::file_exists) };
+        }
+        common::DmMemory::Track(common::MemorySubsystem::Dtcs, 1);
+        set_notifier(dtcs[i].dtc, res.first->second, dtcs[i].notifier);
+        res.first->second.suppression = dtcs[i].suppressed;
+    }
     return ara::core::Result<void>{};
 }
 
 ara::core::Result<void> DMDtc::UnregisterDtc(DtcId dtc) {
-    std::lock_guard<std::mutex> lk(g_dtcsMutex);
-    auto it = g_dtcs.find(dtc);
-    if (it == g_dtcs.end()) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
-    g_dtcs.erase(it);
+    const common::ApiCallScope scope("DMDtc::UnregisterDtc");
+    DtcStatusWaiter *waiters = nullptr;
+    {
+        common::ProfiledLockGuard lk(g_dtcsMutex);
+        auto it = g_dtcs.find(dtc);
+        if (it == g_dtcs.end()) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        waiters = erase_dtc(it);
+    }
+    fire_waiters(waiters, true);
     return ara::core::Result<void>{};
 }
 
 ara::core::Result<void> DMDtc::ReportDtcStatus(DtcId dtc, UdsStatusByte udsStatus) {
-    DtcStatusNotifier notifierCopy;
+    const common::ApiCallScope scope("DMDtc::ReportDtcStatus");
+    const common::EpochGuard pin;   // keeps `notifier` alive if it is replaced meanwhile
+    // set when called from a qualified notifier of a traced report
+    const common::TraceContext *trace = common::LatencyTrace::Enabled() ? common::LatencyTrace::Current() : nullptr;
+    std::uint64_t appliedNs = 0;
+    const DtcStatusNotifier *notifier = nullptr;
+    DtcStatusWaiter *waiters = nullptr;
     UdsStatusByte oldStatus = 0;
     bool shouldNotify = false;
     bool suppressed = false;
 
     {
-        std::lock_guard<std::mutex> lk(g_dtcsMutex);
+        common::ProfiledLockGuard lk(g_dtcsMutex);
         auto it = g_dtcs.find(dtc);
         if (it == g_dtcs.end()) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
 
@@ -57,24 +187,33 @@ ara::core::Result<void> DMDtc::ReportDtcStatus(DtcId dtc, UdsStatusByte udsStatu
             inst.status = udsStatus;
             inst.hasStatus = true;
             suppressed = inst.suppression;
-            notifierCopy = inst.notifier;
-            shouldNotify = !suppressed && static_cast<bool>(notifierCopy);
+            if (const DtcCold *cold = find_cold(dtc, inst)) notifier = cold->notifier.Get();
+            shouldNotify = !suppressed && notifier != nullptr;
+            take_matching_waiters(dtc, inst, waiters);
+            if (trace != nullptr) appliedNs = common::LatencyTrace::NowNs();
         } else {
             // no change -> nothing to do
             return ara::core::Result<void>{};
         }
     }
 
+    if (trace != nullptr) common::LatencyTrace::Record(common::TraceStage::DtcUpdate, trace->notifiedNs, appliedNs);
     // Notify outside lock if not suppressed
-    if (shouldNotify && notifierCopy) {
-        notifierCopy(dtc, oldStatus, udsStatus);
+    if (shouldNotify) {
+        if (trace != nullptr) {
+            const std::uint64_t now = common::LatencyTrace::NowNs();
+            common::LatencyTrace::Record(common::TraceStage::DtcNotify, appliedNs, now);
+            common::LatencyTrace::Record(common::TraceStage::EndToEnd, trace->reportedNs, now);
+        }
+        (*notifier)(dtc, oldStatus, udsStatus);
     }
+    fire_waiters(waiters, false);
 
     return ara::core::Result<void>{};
 }
 
 std::optional<UdsStatusByte> DMDtc::GetCurrentStatus(DtcId dtc) {
-    std::lock_guard<std::mutex> lk(g_dtcsMutex);
+    common::ProfiledLockGuard lk(g_dtcsMutex);
     auto it = g_dtcs.find(dtc);
     if (it == g_dtcs.end()) return std::nullopt;
     if (!it->second.hasStatus) return std::nullopt;
@@ -82,27 +221,64 @@ std::optional<UdsStatusByte> DMDtc::GetCurrentStatus(DtcId dtc) {
 }
 
 ara::core::Result<void> DMDtc::SetDtcSuppression(DtcId dtc, bool suppressed) {
-    std::lock_guard<std::mutex> lk(g_dtcsMutex);
-    auto it = g_dtcs.find(dtc);
-    if (it == g_dtcs.end()) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
-    it->second.suppression = suppressed;
+    const common::ApiCallScope scope("DMDtc::SetDtcSuppression");
+    DtcStatusWaiter *matched = nullptr;
+    {
+        common::ProfiledLockGuard lk(g_dtcsMutex);
+        auto it = g_dtcs.find(dtc);
+        if (it == g_dtcs.end()) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        it->second.suppression = suppressed;
+        take_matching_waiters(dtc, it->second, matched);   // the status became visible to waiters
+    }
+    fire_waiters(matched, false);
     return ara::core::Result<void>{};
 }
 
 std::optional<bool> DMDtc::GetDtcSuppression(DtcId dtc) {
-    std::lock_guard<std::mutex> lk(g_dtcsMutex);
+    common::ProfiledLockGuard lk(g_dtcsMutex);
     auto it = g_dtcs.find(dtc);
     if (it == g_dtcs.end()) return std::nullopt;
-    return it->second.suppression;
+    return it->second.suppression != 0;
 }
 
 ara::core::Result<void> DMDtc::SetDtcStatusNotifier(DtcId dtc, DtcStatusNotifier notifier) {
-    std::lock_guard<std::mutex> lk(g_dtcsMutex);
+    const common::ApiCallScope scope("DMDtc::SetDtcStatusNotifier");
+    common::ProfiledLockGuard lk(g_dtcsMutex);
     auto it = g_dtcs.find(dtc);
     if (it == g_dtcs.end()) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
-    it->second.notifier = std::move(notifier);
+    set_notifier(dtc, it->second, std::move(notifier));
+    return ara::core::Result<void>{};
+}
+
+ara::core::Result<void> DMDtc::AddStatusWaiter(DtcId dtc, DtcStatusWaiter &waiter) {
+    const common::ApiCallScope scope("DMDtc::AddStatusWaiter");
+    if (waiter.mask == 0) return ara::core::Result<void>{ std::make_error_code(std::errc::invalid_argument) };
+    DtcStatusWaiter *matched = nullptr;
+    {
+        common::ProfiledLockGuard lk(g_dtcsMutex);
+        auto it = g_dtcs.find(dtc);
+        if (it == g_dtcs.end()) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        DtcCold &cold = cold_for(dtc, it->second);
+        waiter.next = cold.waiters;
+        cold.waiters = &waiter;
+        take_matching_waiters(dtc, it->second, matched);   // just `waiter`, others were checked on their update
+    }
+    fire_waiters(matched, false);
     return ara::core::Result<void>{};
 }
 
+common::MemoryFootprint DMDtc::GetMemoryFootprint() {
+    common::ProfiledLockGuard lk(g_dtcsMutex);
+    common::MemoryFootprint f;
+    f.entities = g_dtcs.size();
+    f.hotBytes = g_dtcs.size() * sizeof(DtcInstance);
+    f.indexBytes = common::UnorderedMapBytes(g_dtcs) - f.hotBytes;
+    f.coldBytes = common::UnorderedMapBytes(g_dtcCold);
+    for (const auto &p : g_dtcCold) {
+        if (p.second.notifier.Get() != nullptr) f.coldBytes += sizeof(DtcStatusNotifier);
+    }
+    return f;
+}
+
 } // namespace dtc
 } // namespace diagnostic_manager
\ No newline at end of file
@@ -1,155 +1,837 @@
-#ifndef DM_EVENT_H
-#define DM_EVENT_H
-
-#include <functional>
-#include <optional>
-#include <system_error>
-#include <cstdint>
-#include <string>
 #include "event/dm_event.h"
+#include "event/dm_debounce.h"
+#include "common/dm_clock.h"
+#include "common/dm_epoch.h"
+#include "common/dm_executor.h"
+#include "common/dm_latency_trace.h"
+#include "common/dm_lock_profile.h"
+#include "common/dm_memory.h"
+#include "common/dm_perfect_hash.h"
+#include "common/dm_timer_wheel.h"
+
 #include "ara/core/result_future.h"
-#include <map>
-#include <mutex>
-#include <thread>
-#include <condition_variable>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <system_error>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace diagnostic_manager {
 namespace event {
 
-enum class DebounceMode {
-    CounterBased,
-    TimeBased
+using namespace std::chrono;
+
+constexpr std::uint32_t kNoHandle = UINT32_MAX;
+constexpr std::uint32_t kNoOwner = UINT32_MAX;
+
+static std::pmr::memory_resource *monitor_memory() noexcept {
+    return common::DmMemory::Resource(common::MemorySubsystem::Monitors);
+}
+
+static std::pmr::memory_resource *queue_memory() noexcept {
+    return common::DmMemory::Resource(common::MemorySubsystem::Queues);
+}
+
+static std::pmr::memory_resource *notifier_memory() noexcept {
+    return common::DmMemory::Resource(common::MemorySubsystem::Notifiers);
+}
+
+// Notifiers of a monitor with its id, replaced as a whole. Notifications
+// point to it instead of copying; the epoch keeps it alive until delivered.
+// Allocated from notifier_memory(), also when the epoch deletes it.
+struct MonitorNotifiers {
+    MonitorId id;
+    QualifiedNotifier qualified;
+    EventStatusNotifier status;
+
+    static void *operator new(std::size_t size) { return notifier_memory()->allocate(size, alignof(MonitorNotifiers)); }
+    static void operator delete(void *p, std::size_t size) noexcept {
+        notifier_memory()->deallocate(p, size, alignof(MonitorNotifiers));
+    }
+};
+
+static_assert(kStatusFailedAndTested < 4 && kStatusPassedAndTested < 4, "deliveredStatus is two bits wide");
+
+// The part of a monitor every pre-event touches, packed into 16 bytes; the
+// debounce counter and deadline are in its policy group. Everything else is
+// in the MonitorCold at the same index.
+struct MonitorInstance {
+    MonitorInstance() : deliveredStatus(0), frozen(0), statusPending(0), paced(0) {}
+
+    std::uint32_t slot{0};                  // index into the policy group
+    std::uint32_t handleIndex{kNoHandle};   // handle table slot, once a handle was taken
+    std::uint32_t index{0};                 // position in hot_records() and cold_records()
+    DebouncePolicy policy{DebouncePolicy::Counter};
+    QualifiedState qualified{QualifiedState::Unqualified};
+    std::uint8_t statusByte{0};             // event status derived from `qualified`
+    std::uint8_t deliveredStatus : 2;       // last byte handed to the status notifier
+    std::uint8_t frozen : 1;
+    std::uint8_t statusPending : 1;         // coalesced change waiting for delivery
+    std::uint8_t paced : 1;                 // has an entry in g_statusPacing
 };
+static_assert(sizeof(MonitorInstance) <= 16, "hot monitor record must stay within 16 bytes");
 
-enum class QualifiedState : std::uint8_t {
-    Unqualified = 0,
-    QualifiedPassed,
-    QualifiedFailed
+// The name of a registered monitor, owned by its record: the record index
+// and the characters in one block. The key in g_monitors views the characters;
+// g_indexed points to the block, so an indexed lookup reads the block and
+// then the record.
+struct MonitorName {
+    std::uint32_t record;
+    std::uint32_t size;
+    std::uint32_t batchOffset;   // from the start of its NameBatch; 0: a block of its own
+
+    std::string_view View() const noexcept { return std::string_view(reinterpret_cast<const char *>(this + 1), size); }
 };
 
-struct DebounceConfig {
-    DebounceMode mode{DebounceMode::CounterBased};
+// The names of one bulk registration, back to back in one block after this
+// header, so that index lookups stay within it rather than touching a pool
+// chunk per name. Freed with the last of its names.
+struct NameBatch {
+    std::size_t bytes;
+    std::size_t used;
+    std::size_t live;   // names still in use, plus one while being filled
+};
 
-    // Counter-based defaults
-    std::int32_t failedThreshold{3};   // qualify failed after this many prefailed reports
-    std::int32_t passedThreshold{3};   // qualify passed after this many prepassed reports
-    std::int32_t failedStep{1};        // step per prefailed report
-    std::int32_t passedStep{1};        // step per prepassed report
+// Read on registration, state changes and status delivery only.
+struct MonitorCold {
+    MonitorName *name{nullptr};
+    common::EpochSlot<MonitorNotifiers> notifiers;
+    QualifiedStateWaiter *waiters{nullptr};  // fired on the next qualified-state change
+};
+static_assert(sizeof(MonitorCold) <= 24, "cold monitor record must stay within 24 bytes");
 
-    // Time-based defaults (milliseconds)
-    std::uint32_t timeThresholdMs{12000}; // qualify if pre state holds continuously for this duration
+// Status coalescing of a monitor whose status notifier has a minimum
+// interval; monitors that deliver every change have no entry.
+struct StatusPacing {
+    steady_clock::time_point lastDelivery{steady_clock::time_point::min()};   // min(): none yet
+    std::uint32_t intervalMs{0};
 };
 
-// Monitor identifier type (use InstanceSpecifier::GetName() on ara-diag side)
-using MonitorId = std::string;
+// Names not in g_nameIndex; keys view the characters of MonitorCold::name.
+using MonitorMap = std::pmr::unordered_map<std::string_view, MonitorInstance *>;
 
-// Notifier type called when a monitor becomes qualified (or changes qualified state).
-// first arg: monitor id, second arg: new qualified state
-using QualifiedNotifier = std::function<void(const MonitorId &, QualifiedState)>;
+// Debounce state of all monitors sharing one policy, kept in parallel
+// arrays indexed by MonitorInstance::slot. Parameters are interned: each
+// slot refers to one of a few shared sets; a set no slot uses any more is
+// not found by ReplaceDebounceConfig and is reused by the next new set.
+template <typename Policy>
+struct PolicyGroup {
+    using PolicyType = Policy;
+    using Params = typename Policy::Params;
 
-// Public DMEvent API
-class DMEvent {
-public:
-    // Existing APIs (event memory overflow)
-    static std::optional<bool> GetEventMemoryOverflow();
-    static std::error_code SetEventMemoryOverflowNotifier(std::function<void(bool)> notifier);
-
-    // Register a monitor with debounce configuration and a notifier.
-    // Returns error if monitor id already registered.
-    static std::error_code RegisterMonitor(const MonitorId &id, DebounceConfig cfg, QualifiedNotifier notifier);
-
-    // Unregister previously registered monitor.
-    static std::error_code UnregisterMonitor(const MonitorId &id);
-
-    // Called by ara-diag when it reports an unqualified test result (prepassed / prefailed)
-    // preFailed == true => pre-failed reported; preFailed == false => pre-passed reported
-    // Returns error if monitor id unknown.
-    static std::error_code ReportPreEvent(const MonitorId &id, bool preFailed);
-
-    // Query current qualified state (if registered)
-    static std::optional<QualifiedState> GetQualifiedState(const MonitorId &id);
-
-    // Additional control operations driven by MonitorAction commands
-    static std::error_code SetQualifiedState(const MonitorId &id, QualifiedState state);
-    static std::error_code FreezeDebouncing(const MonitorId &id);
-    static std::error_code ResetDebouncing(const MonitorId &id);
-    static std::error_code TriggerFdcThresholdReached(const MonitorId &id);
-    static std::error_code ResetTestFailed(const MonitorId &id);
+    std::pmr::vector<Params> paramSets{monitor_memory()};
+    std::pmr::vector<std::uint32_t> setUsers{monitor_memory()};   // registered slots per set
+    std::pmr::vector<std::uint32_t> paramIds{monitor_memory()};   // index into paramSets
+    std::pmr::vector<typename Policy::State> states{monitor_memory()};
+    std::pmr::vector<std::uint32_t> owners{monitor_memory()};      // record index; kNoOwner for free slots
+    std::pmr::vector<std::uint32_t> freeSlots{monitor_memory()};
+
+    const Params &ParamsOf(std::uint32_t slot) const noexcept { return paramSets[paramIds[slot]]; }
+
+    // Linear: a configuration has a few dozen distinct sets at most.
+    std::optional<std::uint32_t> FindSet(const Params &p) const noexcept {
+        const auto it = std::find(paramSets.begin(), paramSets.end(), p);
+        if (it == paramSets.end()) return std::nullopt;
+        return static_cast<std::uint32_t>(it - paramSets.begin());
+    }
+
+    // A set at least one registered monitor uses.
+    std::optional<std::uint32_t> FindUsedSet(const Params &p) const noexcept {
+        const auto set = FindSet(p);
+        if (!set.has_value() || setUsers[set.value()] == 0) return std::nullopt;
+        return set;
+    }
+
+    std::uint32_t Intern(const Params &p) {
+        if (const auto set = FindSet(p)) return set.value();
+        const auto unused = std::find(setUsers.begin(), setUsers.end(), 0u);
+        if (unused != setUsers.end()) {
+            const auto set = static_cast<std::uint32_t>(unused - setUsers.begin());
+            paramSets[set] = p;
+            return set;
+        }
+        paramSets.push_back(p);
+        setUsers.push_back(0);
+        return static_cast<std::uint32_t>(paramSets.size() - 1);
+    }
+
+    // Point every slot using `set` at `p`; merges into an equal set if there
+    // is one, leaving `set` unused. Returns the set now used.
+    std::uint32_t ReplaceSet(std::uint32_t set, const Params &p) {
+        const auto existing = FindSet(p);
+        if (!existing.has_value()) {
+            paramSets[set] = p;
+            return set;
+        }
+        for (std::size_t slot = 0; slot < paramIds.size(); ++slot) {
+            if (owners[slot] != kNoOwner && paramIds[slot] == set) paramIds[slot] = existing.value();
+        }
+        setUsers[existing.value()] += setUsers[set];
+        setUsers[set] = 0;
+        return existing.value();
+    }
+
+    std::uint32_t Add(const DebounceConfig &cfg, std::uint32_t owner) {
+        const std::uint32_t set = Intern(Policy::MakeParams(cfg));
+        ++setUsers[set];
+        if (!freeSlots.empty()) {
+            const std::uint32_t slot = freeSlots.back();
+            freeSlots.pop_back();
+            paramIds[slot] = set;
+            states[slot] = typename Policy::State{};
+            owners[slot] = owner;
+            return slot;
+        }
+        paramIds.push_back(set);
+        states.emplace_back();
+        owners.push_back(owner);
+        return static_cast<std::uint32_t>(owners.size() - 1);
+    }
+
+    void Reserve(std::size_t additional) {
+        const std::size_t n = owners.size() + additional;
+        paramIds.reserve(n);
+        states.reserve(n);
+        owners.reserve(n);
+    }
+
+    void Remove(std::uint32_t slot) {
+        --setUsers[paramIds[slot]];
+        owners[slot] = kNoOwner;
+        freeSlots.push_back(slot);
+    }
 };
 
-using namespace std::chrono;
+// A pre-event resolved to its monitor, bucketed by policy in ReportPreEvents.
+struct PreEventRef {
+    MonitorInstance *mi;
+    bool preFailed;
+    std::uint64_t reportedNs{0};   // 0: not traced
+};
 
-struct MonitorInstance {
-    DebounceConfig cfg;
-    QualifiedNotifier notifier;
-    int counter{0};
-    QualifiedState qualified{QualifiedState::Unqualified};
-    std::optional<steady_clock::time_point> preStartTime;
-    std::optional<bool> lastPreFailed;
-    bool armedForTimeQualification{false};
-    bool frozen{false};
+// Target of a MonitorHandle: the handle is (generation << 32 | index), and
+// the generation is bumped when the slot is freed. Slots never move, so the
+// overload checks read the atomics without g_mutex.
+struct HandleSlot {
+    MonitorInstance *mi{nullptr};                  // g_mutex
+    std::atomic<std::uint32_t> generation{0};
+    std::atomic<std::uint8_t> repeatNoop{0};       // kRepeat* bits
+    std::atomic<std::uint8_t> deferred{0};         // kDeferred* pre-state waiting for the budget
 };
 
-static std::map<MonitorId, MonitorInstance> g_monitors;
-static std::mutex g_mutex;
-static std::thread g_worker;
-static std::condition_variable g_cv;
-static bool g_stopWorker{false};
-static bool g_workerStarted{false};
-
-static void worker_loop() {
-    std::unique_lock<std::mutex> lk(g_mutex);
-    while (!g_stopWorker) {
-        // wake periodically (200 ms) or when signalled
-        g_cv.wait_for(lk, std::chrono::milliseconds(200));
-        if (g_stopWorker) break;
-
-        const auto now = steady_clock::now();
-        for (auto &p : g_monitors) {
-            MonitorInstance &mi = p.second;
-            if (mi.cfg.mode != DebounceMode::TimeBased) continue;
-            if (mi.frozen) continue;
-            if (!mi.preStartTime.has_value() || !mi.lastPreFailed.has_value()) continue;
-            if (mi.qualified != QualifiedState::Unqualified) continue; // already qualified
-
-            auto elapsed = duration_cast<milliseconds>(now - mi.preStartTime.value()).count();
-            if (elapsed >= static_cast<int64_t>(mi.cfg.timeThresholdMs)) {
-                // qualify according to lastPreFailed
-                if (mi.lastPreFailed.value()) mi.qualified = QualifiedState::QualifiedFailed;
-                else mi.qualified = QualifiedState::QualifiedPassed;
-
-                // call notifier outside lock: copy notifier and id
-                QualifiedNotifier notifier = mi.notifier;
-                MonitorId id = p.first;
-                lk.unlock();
-                if (notifier) notifier(id, mi.qualified);
-                lk.lock();
-                // prevent repeated notifications until a reset occurs (e.g. opposite pre event)
-                mi.preStartTime.reset();
-                mi.armedForTimeQualification = false;
+constexpr std::uint8_t kRepeatPrePassed = 0x01;    // another pre-passed would change nothing
+constexpr std::uint8_t kRepeatPreFailed = 0x02;
+constexpr std::uint8_t kDeferredPrePassed = 1;
+constexpr std::uint8_t kDeferredPreFailed = 2;
+
+constexpr unsigned kHandleChunkBits = 12;
+constexpr std::uint32_t kHandleChunkSize = 1u << kHandleChunkBits;
+constexpr std::uint32_t kHandleChunks = 1024;     // up to 4M handles
+
+// Notifications collected under g_mutex and delivered after unlocking.
+struct Notification {
+    const MonitorNotifiers *notifiers;
+    QualifiedState state;
+    std::uint8_t status;
+    bool qualifiedDue;
+    bool statusDue;
+    QualifiedStateWaiter *waiters{nullptr};
+    std::uint64_t reportedNs{0};    // latency trace of the report that qualified; 0: not traced
+    std::uint64_t qualifiedNs{0};
+};
+
+using NotificationList = std::pmr::vector<Notification>;
+
+// Inline storage of PendingNotifications; a base, so it outlives the list.
+struct NotificationArena {
+    static constexpr std::size_t kInline = 8;
+    alignas(Notification) unsigned char buffer[kInline * sizeof(Notification)];
+    std::pmr::monotonic_buffer_resource arena{buffer, sizeof buffer, monitor_memory()};
+};
+
+// The notifications of one call, on the stack unless there are many. The
+// epoch is pinned before any notifier is looked up, so replaced or
+// unregistered notifiers outlive delivery.
+struct PendingNotifications : private NotificationArena, NotificationList {
+    PendingNotifications() : NotificationList(&arena) { reserve(kInline); }
+    common::EpochGuard pin;
+};
+
+constexpr std::size_t kPolicyCount = 4;
+
+// Records are recycled through g_freeRecords; a deque never moves them, so
+// MonitorInstance pointers stay valid while registered. Built on first use:
+// a deque allocates its map up front, and the DM memory resource must not
+// be touched during static initialisation (DmMemory::Configure).
+static std::pmr::deque<MonitorInstance> &hot_records() {
+    static std::pmr::deque<MonitorInstance> records{monitor_memory()};
+    return records;
+}
+static std::pmr::deque<MonitorCold> &cold_records() {
+    static std::pmr::deque<MonitorCold> records{monitor_memory()};
+    return records;
+}
+static std::pmr::vector<std::uint32_t> g_freeRecords{monitor_memory()};
+static std::pmr::unordered_map<std::uint32_t, StatusPacing> g_statusPacing{monitor_memory()};   // by record index
+static MonitorMap g_monitors{monitor_memory()};
+// Perfect hash over the names known after the last bulk registration, with
+// the name of each by slot (nullptr once unregistered). Names registered
+// later are in g_monitors until the next bulk registration indexes them.
+static common::PerfectHash g_nameIndex{monitor_memory()};
+static std::pmr::vector<const MonitorName *> g_indexed{monitor_memory()};
+static std::atomic<HandleSlot *> g_handleChunks[kHandleChunks];          // published under g_mutex
+static std::uint32_t g_handleCount{0};
+static std::pmr::vector<std::uint32_t> g_freeHandles{monitor_memory()};
+static PolicyGroup<CounterDebounce> g_counterGroup;
+static PolicyGroup<CounterJumpDebounce> g_counterJumpGroup;
+static PolicyGroup<TimePolicy> g_timeGroup;
+static PolicyGroup<MonitorInternalPolicy> g_internalGroup;
+static std::pmr::vector<PreEventRef> g_preBuckets[kPolicyCount] = {   // ReportPreEvents scratch
+    std::pmr::vector<PreEventRef>{monitor_memory()}, std::pmr::vector<PreEventRef>{monitor_memory()},
+    std::pmr::vector<PreEventRef>{monitor_memory()}, std::pmr::vector<PreEventRef>{monitor_memory()}};
+static common::TimerWheel g_timers{common::TimerWheel::kDefaultResolution, steady_clock::now(),
+                                   queue_memory()};          // time-based debounce deadlines
+static std::uint64_t g_timersClock = 0;                       // DmClock generation g_timers is based on
+static std::pmr::vector<std::uint64_t> g_expired{queue_memory()};   // run_deadlines scratch
+static common::ProfiledMutex g_mutex{"event.registry"};
+
+// Earliest run of one kind of deferred work queued on the executor.
+struct QueuedRun {
+    steady_clock::time_point at{steady_clock::time_point::max()};   // max(): none queued
+    std::uint64_t epoch{0};                                         // executor epoch it was queued in
+};
+static QueuedRun g_deadlineRun;
+static QueuedRun g_statusRun;
+
+static void run_deadlines();
+static void run_status_notifications();
+
+// Have the executor run `task` at `when` unless an earlier run is already
+// queued; g_mutex held.
+static void schedule(common::TaskLane lane, QueuedRun &run, void (*task)(), steady_clock::time_point when) {
+    const std::uint64_t epoch = common::Executor::Epoch();
+    if (when >= run.at && run.epoch == epoch) return;
+    if (common::Executor::PostAt(lane, when, task).HasValue()) run = QueuedRun{when, epoch};
+}
+
+// Call f with the group of `policy`; the only per-monitor switch on the mode.
+template <typename F>
+static decltype(auto) with_group(DebouncePolicy policy, F &&f) {
+    switch (policy) {
+    case DebouncePolicy::CounterWithJumps: return f(g_counterJumpGroup);
+    case DebouncePolicy::Time: return f(g_timeGroup);
+    case DebouncePolicy::MonitorInternal: return f(g_internalGroup);
+    case DebouncePolicy::Counter:
+    default: return f(g_counterGroup);
+    }
+}
+
+// The indexed monitor named `id`, checked against the name in its slot.
+static MonitorInstance *find_indexed(std::string_view id) {
+    if (g_indexed.empty()) return nullptr;
+    const MonitorName *name = g_indexed[g_nameIndex.Slot(id)];
+    return name != nullptr && name->View() == id ? &hot_records()[name->record] : nullptr;
+}
+
+// Name resolution for all id-based calls; g_mutex held.
+static MonitorInstance *find_monitor(const MonitorId &id) {
+    if (MonitorInstance *mi = find_indexed(id)) return mi;
+    auto it = g_monitors.find(id);
+    return it == g_monitors.end() ? nullptr : it->second;
+}
+
+static MonitorCold &cold(const MonitorInstance &mi) {
+    return cold_records()[mi.index];
+}
+
+// The id copy on the heap, if it does not fit the string's own buffer.
+static std::ptrdiff_t notifier_bytes(const MonitorNotifiers *n) noexcept {
+    if (n == nullptr) return 0;
+    const std::size_t outOfLine = n->id.capacity() > std::string().capacity() ? n->id.capacity() + 1 : 0;
+    return static_cast<std::ptrdiff_t>(outOfLine);
+}
+
+// Install `next` (may be null); the old notifiers are retired. g_mutex held.
+static void replace_notifiers(MonitorCold &c, std::unique_ptr<MonitorNotifiers> next) {
+    const MonitorNotifiers *old = c.notifiers.Get();
+    common::DmMemory::Track(common::MemorySubsystem::Notifiers, (next ? 1 : 0) - (old ? 1 : 0),
+                            notifier_bytes(next.get()) - notifier_bytes(old));
+    c.notifiers.Reset(std::move(next));
+}
+
+static std::size_t name_bytes(std::size_t size) noexcept {
+    constexpr std::size_t align = alignof(MonitorName);
+    return (sizeof(MonitorName) + size + align - 1) / align * align;
+}
+
+// Room for the names of `count` registrations; nullptr (names get blocks of
+// their own) if there are none or offsets would not fit MonitorName.
+static NameBatch *new_batch(const MonitorRegistration *monitors, std::size_t count) {
+    std::size_t bytes = sizeof(NameBatch);
+    for (std::size_t i = 0; i < count; ++i) bytes += name_bytes(monitors[i].id.size());
+    if (count == 0 || bytes > UINT32_MAX) return nullptr;
+    void *block = monitor_memory()->allocate(bytes, alignof(NameBatch));
+    return ::new (block) NameBatch{bytes, sizeof(NameBatch), 1};
+}
+
+static void unref_batch(NameBatch *batch) {
+    if (batch != nullptr && --batch->live == 0) monitor_memory()->deallocate(batch, batch->bytes, alignof(NameBatch));
+}
+
+// Copy `id` into `batch` if given, else into a block of its own.
+static MonitorName *copy_name(std::string_view id, std::uint32_t record, NameBatch *batch) {
+    const std::size_t bytes = name_bytes(id.size());
+    void *block = nullptr;
+    std::uint32_t offset = 0;
+    if (batch != nullptr) {
+        block = reinterpret_cast<char *>(batch) + batch->used;
+        offset = static_cast<std::uint32_t>(batch->used);
+        batch->used += bytes;
+        ++batch->live;
+    } else {
+        block = monitor_memory()->allocate(bytes, alignof(MonitorName));
+    }
+    auto *name = ::new (block) MonitorName{record, static_cast<std::uint32_t>(id.size()), offset};
+    std::copy(id.begin(), id.end(), reinterpret_cast<char *>(name + 1));
+    return name;
+}
+
+static void release_name(MonitorName *name) {
+    if (name == nullptr) return;
+    if (name->batchOffset == 0) {
+        monitor_memory()->deallocate(name, name_bytes(name->size), alignof(MonitorName));
+        return;
+    }
+    unref_batch(reinterpret_cast<NameBatch *>(reinterpret_cast<char *>(name) - name->batchOffset));
+}
+
+static MonitorInstance &take_record() {
+    common::DmMemory::Track(common::MemorySubsystem::Monitors, 1);
+    if (!g_freeRecords.empty()) {
+        const std::uint32_t index = g_freeRecords.back();
+        g_freeRecords.pop_back();
+        return hot_records()[index];
+    }
+    MonitorInstance &mi = hot_records().emplace_back();
+    mi.index = static_cast<std::uint32_t>(hot_records().size() - 1);
+    cold_records().emplace_back();
+    return mi;
+}
+
+// Take a record for `id` and make the name resolve to it; nullptr if the
+// name is registered. The name is copied into `batch` if given. g_mutex held.
+static MonitorInstance *add_monitor(std::string_view id, NameBatch *batch = nullptr) {
+    if (find_indexed(id) != nullptr) return nullptr;
+    auto res = g_monitors.try_emplace(id, nullptr);   // also an indexed name after an unregister
+    if (!res.second) return nullptr;
+    MonitorInstance &mi = take_record();
+    MonitorCold &c = cold(mi);
+    c.name = copy_name(id, mi.index, batch);
+    auto node = g_monitors.extract(res.first);   // re-keyed to view the record's own copy
+    node.key() = c.name->View();
+    node.mapped() = &mi;
+    g_monitors.insert(std::move(node));
+    return &mi;
+}
+
+// Remove the name of `mi` and recycle its records; g_mutex held.
+static void free_monitor(MonitorInstance &mi) {
+    MonitorCold &c = cold(mi);
+    const MonitorName **indexed = g_indexed.empty() ? nullptr : &g_indexed[g_nameIndex.Slot(c.name->View())];
+    if (indexed != nullptr && *indexed == c.name) {
+        *indexed = nullptr;
+    } else {
+        g_monitors.erase(c.name->View());
+    }
+    release_name(c.name);
+    c.name = nullptr;
+    replace_notifiers(c, nullptr);
+    c.waiters = nullptr;
+    if (mi.paced) g_statusPacing.erase(mi.index);
+    const std::uint32_t index = mi.index;
+    mi = MonitorInstance{};
+    mi.index = index;
+    g_freeRecords.push_back(index);
+    common::DmMemory::Track(common::MemorySubsystem::Monitors, -1);
+}
+
+static HandleSlot *handle_slot(std::uint32_t index) {
+    if ((index >> kHandleChunkBits) >= kHandleChunks) return nullptr;
+    HandleSlot *chunk = g_handleChunks[index >> kHandleChunkBits].load(std::memory_order_acquire);
+    return chunk == nullptr ? nullptr : &chunk[index & (kHandleChunkSize - 1)];
+}
+
+// The slot of a live handle; callable without g_mutex.
+static HandleSlot *live_slot(MonitorHandle handle) {
+    HandleSlot *slot = handle_slot(static_cast<std::uint32_t>(handle));
+    if (slot == nullptr) return nullptr;
+    return slot->generation.load(std::memory_order_acquire) == static_cast<std::uint32_t>(handle >> 32) ? slot : nullptr;
+}
+
+// g_mutex held.
+static MonitorInstance *resolve_handle(MonitorHandle handle) {
+    HandleSlot *slot = live_slot(handle);
+    return slot == nullptr ? nullptr : slot->mi;
+}
+
+// Recompute which repeated pre-events the overload filter may drop;
+// g_mutex held. Only monitors with a handle are filtered.
+static void refresh_repeat_filter(const MonitorInstance &mi) {
+    if (mi.handleIndex == kNoHandle) return;
+    std::uint8_t bits = kRepeatPrePassed | kRepeatPreFailed;   // frozen: pre-events are ignored
+    if (!mi.frozen) {
+        bits = with_group(mi.policy, [&](auto &group) {
+            using Policy = typename std::decay_t<decltype(group)>::PolicyType;
+            const auto &params = group.ParamsOf(mi.slot);
+            const auto &state = group.states[mi.slot];
+            return static_cast<std::uint8_t>(
+                (Policy::RepeatIsNoop(params, state, false, mi.qualified) ? kRepeatPrePassed : 0) |
+                (Policy::RepeatIsNoop(params, state, true, mi.qualified) ? kRepeatPreFailed : 0));
+        });
+    }
+    handle_slot(mi.handleIndex)->repeatNoop.store(bits, std::memory_order_release);
+}
+
+// The monitor's handle, allocating a slot on first use; g_mutex held.
+// nullopt once the handle table is full.
+static std::optional<MonitorHandle> take_handle(MonitorInstance &mi) {
+    if (mi.handleIndex == kNoHandle) {
+        std::uint32_t index;
+        if (!g_freeHandles.empty()) {
+            index = g_freeHandles.back();
+            g_freeHandles.pop_back();
+        } else {
+            index = g_handleCount;
+            const std::uint32_t chunk = index >> kHandleChunkBits;
+            if (chunk >= kHandleChunks) return std::nullopt;
+            if (g_handleChunks[chunk].load(std::memory_order_relaxed) == nullptr) {
+                // never freed: readers without g_mutex may still hold a slot
+                auto *slots = static_cast<HandleSlot *>(
+                    monitor_memory()->allocate(kHandleChunkSize * sizeof(HandleSlot), alignof(HandleSlot)));
+                for (std::uint32_t i = 0; i < kHandleChunkSize; ++i) {
+                    ::new (&slots[i]) HandleSlot{};
+                    slots[i].generation.store(1);
+                }
+                g_handleChunks[chunk].store(slots, std::memory_order_release);
             }
+            ++g_handleCount;
         }
+        handle_slot(index)->mi = &mi;
+        mi.handleIndex = index;
+        refresh_repeat_filter(mi);
     }
+    const HandleSlot &slot = *handle_slot(mi.handleIndex);
+    return (static_cast<MonitorHandle>(slot.generation.load(std::memory_order_relaxed)) << 32) | mi.handleIndex;
 }
 
-// helper to ensure worker is running
-static void start_worker_if_needed() {
-    if (g_workerStarted) return;
-    g_stopWorker = false;
-    g_worker = std::thread(worker_loop);
-    g_workerStarted = true;
+// Subscriber state streams. Changes are written under g_mutex, so g_mutex
+// is the single producer of every ring and the sequence follows the order
+// in which changes are applied. Each ring has exactly one reader.
+struct StateStream {
+    explicit StateStream(std::size_t capacity) : mask(capacity - 1), ring(capacity, queue_memory()) {
+        common::DmMemory::Track(common::MemorySubsystem::Queues, 1);
+    }
+    ~StateStream() { common::DmMemory::Track(common::MemorySubsystem::Queues, -1); }
+
+    const std::size_t mask;
+    std::pmr::vector<StateChange> ring;
+    std::uint64_t nextSequence{1};                    // g_mutex
+    alignas(64) std::atomic<std::size_t> tail{0};     // written by the producer
+    alignas(64) std::atomic<std::size_t> head{0};     // written by the reader
+};
+
+constexpr std::uint32_t kMaxStateStreams = 64;
+
+static std::atomic<StateStream *> g_streamSlots[kMaxStateStreams];    // read by the stream's reader
+static common::ResourcePtr<StateStream> g_streamStorage[kMaxStateStreams];   // g_mutex
+static std::pmr::vector<StateStream *> g_streams{queue_memory()};   // open streams; g_mutex
+
+// Append a change to every open stream; g_mutex held. On a full ring the
+// change is dropped but its sequence number is still taken.
+static void publish_state_change(MonitorInstance &mi, QualifiedState state) {
+    if (g_streams.empty()) return;
+    const std::optional<MonitorHandle> handle = take_handle(mi);
+    for (StateStream *stream : g_streams) {
+        const std::uint64_t sequence = stream->nextSequence++;
+        const std::size_t tail = stream->tail.load(std::memory_order_relaxed);
+        if (tail - stream->head.load(std::memory_order_acquire) > stream->mask) continue;
+        stream->ring[tail & stream->mask] = StateChange{handle.value_or(0), state, sequence};
+        stream->tail.store(tail + 1, std::memory_order_release);
+    }
+}
+
+// Rebuild g_nameIndex over all registered names and move them out of
+// g_monitors. The index keeps no names: each slot points to the name its
+// record owns. On failure the previous index and g_monitors stay as they are.
+static void rebuild_name_index() {
+    std::pmr::vector<std::string_view> keys{monitor_memory()};
+    std::pmr::vector<const MonitorName *> names{monitor_memory()};
+    keys.reserve(g_indexed.size() + g_monitors.size());
+    names.reserve(g_indexed.size() + g_monitors.size());
+    for (const MonitorName *name : g_indexed) {
+        if (name == nullptr) continue;
+        keys.push_back(name->View());
+        names.push_back(name);
+    }
+    for (auto &p : g_monitors) {
+        keys.push_back(p.first);
+        names.push_back(cold(*p.second).name);
+    }
+    auto built = common::PerfectHash::Build(keys.data(), keys.size(), monitor_memory());
+    if (built.HasError()) return;
+    g_nameIndex = std::move(built).Value();
+    g_indexed.assign(names.size(), nullptr);
+    for (const MonitorName *name : names) {
+        g_indexed[g_nameIndex.Slot(name->View())] = name;
+    }
+    MonitorMap{monitor_memory()}.swap(g_monitors);   // also frees the buckets
+}
+
+// Report being applied on this thread, read by set_qualified.
+struct AppliedReport {
+    std::uint64_t reportedNs{0};   // 0: not traced
+    std::uint64_t dispatchedNs{0};
+};
+static thread_local AppliedReport t_applying;
+
+// Start of a DMEvent call for latency tracing; 0 while tracing is off.
+static std::uint64_t trace_dispatch() noexcept {
+    return common::LatencyTrace::Enabled() ? common::LatencyTrace::NowNs() : 0;
 }
 
-// helper to stop worker (not strictly necessary in process lifetime)
-static void stop_worker() {
+// Reported time of one update of a traced call, recording its transport;
+// reports without a timestamp count from the call.
+static std::uint64_t trace_reported(std::uint64_t dispatchedNs, std::uint64_t reportedNs) noexcept {
+    if (dispatchedNs == 0) return 0;
+    if (reportedNs == 0) return dispatchedNs;
+    common::LatencyTrace::Record(common::TraceStage::Transport, reportedNs, dispatchedNs);
+    return reportedNs;
+}
+
+static std::uint8_t to_status_byte(QualifiedState state) {
+    switch (state) {
+    case QualifiedState::QualifiedFailed: return kStatusFailedAndTested;
+    case QualifiedState::QualifiedPassed: return kStatusPassedAndTested;
+    case QualifiedState::Unqualified:
+    default: return 0;
+    }
+}
+
+// Returns true (and the byte in `out`) if a status notification is due now.
+// Inside a coalescing interval the change is marked pending and delivered
+// from the bulk lane once the interval has elapsed.
+static bool take_due_status(MonitorInstance &mi, steady_clock::time_point now, std::uint8_t &out) {
+    if (mi.statusByte == mi.deliveredStatus) {
+        mi.statusPending = false;   // reverted before it was delivered
+        return false;
+    }
+    if (mi.paced) {
+        StatusPacing &p = g_statusPacing.find(mi.index)->second;
+        const milliseconds interval(p.intervalMs);
+        if (p.lastDelivery != steady_clock::time_point::min() && now - p.lastDelivery < interval) {
+            if (!mi.statusPending) {
+                mi.statusPending = true;
+                schedule(common::TaskLane::Bulk, g_statusRun, run_status_notifications, p.lastDelivery + interval);
+            }
+            return false;
+        }
+        p.lastDelivery = now;
+    }
+    mi.statusPending = false;
+    mi.deliveredStatus = mi.statusByte;
+    out = mi.statusByte;
+    return true;
+}
+
+// Re-derive the status byte after `qualified` was changed.
+static bool update_status(MonitorInstance &mi, steady_clock::time_point now, std::uint8_t &out) {
+    const std::uint8_t status = to_status_byte(mi.qualified);
+    if (status == mi.statusByte) return false;
+    mi.statusByte = status;
+    const MonitorNotifiers *notifiers = cold(mi).notifiers.Get();
+    if (notifiers == nullptr || !notifiers->status) return false;
+    return take_due_status(mi, now, out);
+}
+
+// Apply a qualified state with g_mutex held and queue the notifications it
+// causes. The qualified notifier runs for every update, as before.
+static void set_qualified(MonitorInstance &mi, QualifiedState state, steady_clock::time_point now,
+                          NotificationList &out) {
+    const bool changed = mi.qualified != state;
+    mi.qualified = state;
+    refresh_repeat_filter(mi);
+    MonitorCold &c = cold(mi);
+    const MonitorNotifiers *notifiers = c.notifiers.Get();
+    Notification n{notifiers, state, 0, notifiers != nullptr && notifiers->qualified, false};
+    n.statusDue = update_status(mi, now, n.status);
+    if (t_applying.reportedNs != 0) {
+        n.reportedNs = t_applying.reportedNs;
+        n.qualifiedNs = common::LatencyTrace::NowNs();
+        common::LatencyTrace::Record(common::TraceStage::Debounce, t_applying.dispatchedNs, n.qualifiedNs);
+    }
+    if (changed) {
+        std::swap(n.waiters, c.waiters);
+        publish_state_change(mi, state);
+    }
+    if (!n.qualifiedDue && !n.statusDue && !n.waiters) return;
+    out.push_back(n);
+}
+
+// FDC threshold: the consumer is called with the current qualified state.
+static void queue_fdc_reached(const MonitorInstance &mi, NotificationList &out) {
+    const MonitorNotifiers *notifiers = cold(mi).notifiers.Get();
+    if (notifiers == nullptr || !notifiers->qualified) return;
+    out.push_back(Notification{notifiers, mi.qualified, 0, true, false});
+}
+
+// Fire a detached waiter list; a waiter may be gone once fired.
+static void fire_waiters(QualifiedStateWaiter *w, QualifiedState state, bool unregistered) {
+    while (w != nullptr) {
+        QualifiedStateWaiter *next = w->next;
+        w->next = nullptr;
+        w->state = state;
+        w->unregistered = unregistered;
+        w->fire(*w);
+        w = next;
+    }
+}
+
+// Run without g_mutex.
+static void deliver(const NotificationList &pending) {
+    for (const Notification &n : pending) {
+        if (n.qualifiedDue && n.reportedNs != 0) {
+            // ReportDtcStatus called by the notifier continues the trace
+            const common::TraceContext ctx{n.reportedNs, common::LatencyTrace::NowNs()};
+            common::LatencyTrace::Record(common::TraceStage::Notify, n.qualifiedNs, ctx.notifiedNs);
+            const common::TraceContextScope scope(&ctx);
+            n.notifiers->qualified(n.notifiers->id, n.state);
+        } else if (n.qualifiedDue) {
+            n.notifiers->qualified(n.notifiers->id, n.state);
+        }
+        if (n.statusDue) n.notifiers->status(n.notifiers->id, n.status);
+        fire_waiters(n.waiters, n.state, false);
+    }
+}
+
+// The debounce wheel, re-origined when DmClock switched source since its
+// last use (virtual time may be far ahead of the real clock); g_mutex held.
+static common::TimerWheel &timer_wheel() {
+    const std::uint64_t generation = common::DmClock::Generation();
+    if (generation != g_timersClock) {
+        g_timers.Rebase(common::DmClock::Now());
+        g_timersClock = generation;
+    }
+    return g_timers;
+}
+
+static void apply_step(MonitorInstance &mi, const DebounceStep &step, steady_clock::time_point now,
+                       NotificationList &out) {
+    if (step.decided && step.state != mi.qualified) set_qualified(mi, step.state, now, out);
+    if (step.fdcReached) queue_fdc_reached(mi, out);
+}
+
+template <typename Policy>
+static void apply_pre_event(PolicyGroup<Policy> &group, MonitorInstance &mi, bool preFailed,
+                            steady_clock::time_point now, NotificationList &out) {
+    DebounceTimers timers{timer_wheel(), mi.slot};
+    apply_step(mi, Policy::OnPreEvent(group.ParamsOf(mi.slot), group.states[mi.slot], preFailed, now, timers), now, out);
+    refresh_repeat_filter(mi);
+}
+
+// Inner loop of one policy group: no mode checks, the policy is inlined.
+template <typename Policy>
+static void run_pre_events(PolicyGroup<Policy> &group, const std::pmr::vector<PreEventRef> &refs,
+                           steady_clock::time_point now, NotificationList &out) {
+    for (const PreEventRef &ref : refs) {
+        t_applying.reportedNs = ref.reportedNs;
+        apply_pre_event(group, *ref.mi, ref.preFailed, now, out);
+    }
+}
+
+// Queue a latency-lane run for the earliest armed debounce deadline.
+static void schedule_deadlines() {
+    const auto next = timer_wheel().NextWakeup();
+    if (next.has_value()) schedule(common::TaskLane::Latency, g_deadlineRun, run_deadlines, next.value());
+}
+
+// Run the pre-events collected in g_preBuckets, one policy group at a time;
+// g_mutex held. `dispatchedNs` is the trace_dispatch() of the call.
+static void run_pre_event_buckets(NotificationList &pending, std::uint64_t dispatchedNs = 0) {
+    const auto now = common::DmClock::Now();
+    t_applying.dispatchedNs = dispatchedNs;
+    for (std::size_t p = 0; p < kPolicyCount; ++p) {
+        std::pmr::vector<PreEventRef> &bucket = g_preBuckets[p];
+        if (bucket.empty()) continue;
+        with_group(static_cast<DebouncePolicy>(p), [&](auto &group) { run_pre_events(group, bucket, now, pending); });
+        bucket.clear();
+    }
+    t_applying = AppliedReport{};
+    schedule_deadlines();
+}
+
+// Collect coalesced status changes whose interval has elapsed; returns the
+// earliest deadline still pending (or `limit`).
+static steady_clock::time_point collect_pending_status(steady_clock::time_point now,
+                                                       steady_clock::time_point limit,
+                                                       NotificationList &out) {
+    steady_clock::time_point next = limit;
+    for (MonitorInstance &mi : hot_records()) {   // free records are never pending
+        if (!mi.statusPending) continue;
+        std::uint8_t status = 0;
+        if (take_due_status(mi, now, status)) {
+            out.push_back(Notification{cold(mi).notifiers.Get(), mi.qualified, status, false, true});
+        } else if (mi.statusPending) {   // only paced monitors stay pending
+            const StatusPacing &p = g_statusPacing.find(mi.index)->second;
+            next = std::min(next, p.lastDelivery + milliseconds(p.intervalMs));
+        }
+    }
+    return next;
+}
+
+// Latency lane: apply expired time-based debounce deadlines.
+static void run_deadlines() {
+    PendingNotifications pending;
+    {
+        common::ProfiledLockGuard lk(g_mutex);
+        const auto now = common::DmClock::Now();
+        if (g_deadlineRun.at <= now) g_deadlineRun.at = steady_clock::time_point::max();   // the queued run
+        timer_wheel().Advance(now, g_expired);
+        for (std::uint64_t payload : g_expired) {
+            const std::uint32_t slot = DebounceTimers::SlotOf(payload);
+            const std::uint32_t owner = g_timeGroup.owners[slot];
+            if (owner == kNoOwner) continue;
+            MonitorInstance *mi = &hot_records()[owner];
+            const DebounceStep step =
+                TimePolicy::OnDeadline(g_timeGroup.ParamsOf(slot), g_timeGroup.states[slot], DebounceTimers::KindOf(payload));
+            if (!mi->frozen) apply_step(*mi, step, now, pending);
+        }
+        g_expired.clear();
+        schedule_deadlines();
+    }
+    deliver(pending);
+}
+
+// Bulk lane: deliver coalesced status changes whose interval has elapsed.
+static void run_status_notifications() {
+    PendingNotifications pending;
     {
-        std::lock_guard<std::mutex> lk(g_mutex);
-        g_stopWorker = true;
-        g_cv.notify_all();
+        common::ProfiledLockGuard lk(g_mutex);
+        const auto now = common::DmClock::Now();
+        if (g_statusRun.at <= now) g_statusRun.at = steady_clock::time_point::max();   // the queued run
+        const auto next = collect_pending_status(now, steady_clock::time_point::max(), pending);
+        if (next != steady_clock::time_point::max()) {
+            schedule(common::TaskLane::Bulk, g_statusRun, run_status_notifications, next);
+        }
     }
-    if (g_worker.joinable()) g_worker.join();
-    g_workerStarted = false;
+    deliver(pending);
 }
 
 // --- Public API implementations ---
@@ -159,210 +841,664 @@ std::optional<bool> DMEvent::GetEventMemoryOverflow() {
     return std::nullopt;
 }
 
-std::error_code DMEvent::SetEventMemoryOverflowNotifier(std::function<void(bool)> /*notifier*/) {
+ara::core::Result<void> DMEvent::SetEventMemoryOverflowNotifier(std::function<void(bool)> /*notifier*/) {
     // Not implemented in this simple manager
-    return make_error_code(std::errc::operation_not_supported);
+    return ara::core::Result<void>{ std::make_error_code(std::errc::operation_not_supported) };
 }
 
-std::error_code DMEvent::RegisterMonitor(const MonitorId &id, DebounceConfig cfg, QualifiedNotifier notifier) {
-    std::lock_guard<std::mutex> lk(g_mutex);
-    if (g_monitors.find(id) != g_monitors.end()) {
-        return make_error_code(std::errc::file_exists); // already registered
+// Replace the notifiers of a monitor; the old ones are retired. g_mutex held.
+static void set_notifiers(MonitorInstance &mi, QualifiedNotifier qualified, EventStatusNotifier status) {
+    MonitorCold &c = cold(mi);
+    if (!qualified && !status) {
+        replace_notifiers(c, nullptr);
+        return;
     }
-    MonitorInstance mi;
-    mi.cfg = cfg;
-    mi.notifier = notifier;
-    mi.counter = 0;
-    mi.qualified = QualifiedState::Unqualified;
-    mi.preStartTime.reset();
-    mi.lastPreFailed.reset();
-    mi.armedForTimeQualification = false;
-    mi.frozen = false;
-    g_monitors.emplace(id, std::move(mi));
+    replace_notifiers(c, std::unique_ptr<MonitorNotifiers>(
+        new MonitorNotifiers{MonitorId(c.name->View()), std::move(qualified), std::move(status)}));
+}
+
+// Set up a record taken by add_monitor; g_mutex held.
+static void init_monitor(MonitorInstance &mi, const DebounceConfig &cfg, QualifiedNotifier notifier) {
+    set_notifiers(mi, std::move(notifier), nullptr);
+    mi.policy = SelectDebouncePolicy(cfg);
+    mi.slot = with_group(mi.policy, [&](auto &group) { return group.Add(cfg, mi.index); });
+}
 
-    if (cfg.mode == DebounceMode::TimeBased) {
-        start_worker_if_needed();
-        g_cv.notify_all();
+ara::core::Result<void> DMEvent::RegisterMonitor(const MonitorId &id, DebounceConfig cfg, QualifiedNotifier notifier) {
+    const common::ApiCallScope scope("DMEvent::RegisterMonitor");
+    // workers up before the first deadline is armed
+    if (SelectDebouncePolicy(cfg) == DebouncePolicy::Time) {
+        auto started = common::Executor::Start();
+        if (started.HasError()) return started;
+    }
+    common::ProfiledLockGuard lk(g_mutex);
+    MonitorInstance *mi = add_monitor(id);
+    if (mi == nullptr) {
+        return ara::core::Result<void>{ std::make_error_code(std::errc::file_exists) }; // already registered
     }
-    return std::error_code{}; // success
+    init_monitor(*mi, cfg, std::move(notifier));
+    return ara::core::Result<void>{};
 }
 
-std::error_code DMEvent::UnregisterMonitor(const MonitorId &id) {
-    std::lock_guard<std::mutex> lk(g_mutex);
-    auto it = g_monitors.find(id);
-    if (it == g_monitors.end()) return make_error_code(std::errc::no_such_file_or_directory);
-    g_monitors.erase(it);
-    return std::error_code{};
+ara::core::Result<void> DMEvent::RegisterMonitors(const MonitorRegistration *monitors, std::size_t count) {
+    const common::ApiCallScope scope("DMEvent::RegisterMonitors");
+    std::size_t perPolicy[kPolicyCount] = {};
+    for (std::size_t i = 0; i < count; ++i) {
+        if (monitors[i].id.empty()) return ara::core::Result<void>{ std::make_error_code(std::errc::invalid_argument) };
+        ++perPolicy[static_cast<std::size_t>(SelectDebouncePolicy(monitors[i].cfg))];
+    }
+    if (perPolicy[static_cast<std::size_t>(DebouncePolicy::Time)] > 0) {
+        auto started = common::Executor::Start();
+        if (started.HasError()) return started;
+    }
+
+    common::ProfiledLockGuard lk(g_mutex);
+    g_monitors.reserve(g_monitors.size() + count);   // at most one rehash
+    std::pmr::vector<MonitorInstance *> entries{monitor_memory()};
+    entries.reserve(count);
+    NameBatch *batch = new_batch(monitors, count);
+    for (std::size_t i = 0; i < count; ++i) {
+        MonitorInstance *mi = add_monitor(monitors[i].id, batch);
+        if (mi == nullptr) {
+            // registered before or earlier in this batch: drop the (still empty) new records
+            for (MonitorInstance *added : entries) free_monitor(*added);
+            unref_batch(batch);
+            return ara::core::Result<void>{ std::make_error_code(std::errc::file_exists) };
+        }
+        entries.push_back(mi);
+    }
+    unref_batch(batch);
+
+    for (std::size_t p = 0; p < kPolicyCount; ++p) {
+        with_group(static_cast<DebouncePolicy>(p), [&](auto &group) { group.Reserve(perPolicy[p]); });
+    }
+    for (std::size_t i = 0; i < count; ++i) init_monitor(*entries[i], monitors[i].cfg, monitors[i].notifier);
+    rebuild_name_index();
+    return ara::core::Result<void>{};
 }
 
-std::error_code DMEvent::ReportPreEvent(const MonitorId &id, bool preFailed) {
-    std::unique_lock<std::mutex> lk(g_mutex);
-    auto it = g_monitors.find(id);
-    if (it == g_monitors.end()) return make_error_code(std::errc::no_such_file_or_directory);
+ara::core::Result<void> DMEvent::ReplaceDebounceConfig(const DebounceConfig &from, const DebounceConfig &to) {
+    const common::ApiCallScope scope("DMEvent::ReplaceDebounceConfig");
+    const DebouncePolicy policy = SelectDebouncePolicy(from);
+    if (SelectDebouncePolicy(to) != policy) return ara::core::Result<void>{ std::make_error_code(std::errc::invalid_argument) };
+    common::ProfiledLockGuard lk(g_mutex);
+    return with_group(policy, [&](auto &group) {
+        using Policy = typename std::decay_t<decltype(group)>::PolicyType;
+        const auto set = group.FindUsedSet(Policy::MakeParams(from));
+        if (!set.has_value()) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        const std::uint32_t now = group.ReplaceSet(set.value(), Policy::MakeParams(to));
+        for (std::size_t slot = 0; slot < group.owners.size(); ++slot) {
+            if (group.owners[slot] != kNoOwner && group.paramIds[slot] == now) refresh_repeat_filter(hot_records()[group.owners[slot]]);
+        }
+        return ara::core::Result<void>{};
+    });
+}
 
-    MonitorInstance &mi = it->second;
+ara::core::Result<void> DMEvent::UnregisterMonitor(const MonitorId &id) {
+    const common::ApiCallScope scope("DMEvent::UnregisterMonitor");
+    QualifiedStateWaiter *waiters = nullptr;
+    QualifiedState last = QualifiedState::Unqualified;
+    {
+        common::ProfiledLockGuard lk(g_mutex);
+        MonitorInstance *entry = find_monitor(id);
+        if (entry == nullptr) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        MonitorInstance &mi = *entry;
+        waiters = cold(mi).waiters;
+        last = mi.qualified;
+        if (mi.handleIndex != kNoHandle) {
+            HandleSlot &slot = *handle_slot(mi.handleIndex);
+            slot.mi = nullptr;
+            slot.generation.fetch_add(1, std::memory_order_release);
+            slot.repeatNoop.store(0, std::memory_order_relaxed);
+            slot.deferred.store(0, std::memory_order_relaxed);
+            g_freeHandles.push_back(mi.handleIndex);
+        }
+        with_group(mi.policy, [&](auto &group) {
+            using Policy = typename std::decay_t<decltype(group)>::PolicyType;
+            DebounceTimers timers{timer_wheel(), mi.slot};
+            Policy::Reset(group.states[mi.slot], timers);   // cancels pending deadlines
+            group.Remove(mi.slot);
+        });
+        free_monitor(mi);
+    }
+    fire_waiters(waiters, last, true);
+    return ara::core::Result<void>{};
+}
 
-    if (mi.frozen) {
+ara::core::Result<void> DMEvent::ReportPreEvent(const MonitorId &id, bool preFailed) {
+    const common::ApiCallScope scope("DMEvent::ReportPreEvent");
+    const std::uint64_t dispatched = trace_dispatch();
+    PendingNotifications pending;
+    {
+        common::ProfiledLockGuard lk(g_mutex);
+        MonitorInstance *entry = find_monitor(id);
+        if (entry == nullptr) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+
+        MonitorInstance &mi = *entry;
         // Ignore pre-events while frozen
-        return std::error_code{};
+        if (mi.frozen) return ara::core::Result<void>{};
+
+        const auto now = common::DmClock::Now();
+        t_applying = AppliedReport{dispatched, dispatched};
+        with_group(mi.policy, [&](auto &group) { apply_pre_event(group, mi, preFailed, now, pending); });
+        t_applying = AppliedReport{};
+        if (mi.policy == DebouncePolicy::Time) schedule_deadlines();
     }
+    deliver(pending);
+    return ara::core::Result<void>{};
+}
 
-    // Counter-based debouncing
-    if (mi.cfg.mode == DebounceMode::CounterBased) {
-        // counter: increment towards failed on preFailed, decrement towards passed on prePassed.
-        if (preFailed) {
-            mi.counter += mi.cfg.failedStep;
-            if (mi.counter > mi.cfg.failedThreshold) mi.counter = mi.cfg.failedThreshold;
-        } else {
-            mi.counter -= mi.cfg.passedStep;
-            if (mi.counter < -static_cast<int>(mi.cfg.passedThreshold)) mi.counter = -static_cast<int>(mi.cfg.passedThreshold);
+std::size_t DMEvent::ReportPreEvents(const PreEventUpdate *updates, std::size_t count) {
+    const common::ApiCallScope scope("DMEvent::ReportPreEvents");
+    const std::uint64_t dispatched = trace_dispatch();
+    PendingNotifications pending;
+    std::size_t applied = 0;
+    {
+        common::ProfiledLockGuard lk(g_mutex);
+        for (std::size_t i = 0; i < count; ++i) {
+            MonitorInstance *entry = find_monitor(*updates[i].id);
+            if (entry == nullptr) continue;
+            ++applied;
+            MonitorInstance &mi = *entry;
+            if (mi.frozen) continue;
+            g_preBuckets[static_cast<std::size_t>(mi.policy)].push_back(PreEventRef{&mi, updates[i].preFailed, dispatched});
         }
 
-        // evaluate qualification
-        QualifiedState newState = QualifiedState::Unqualified;
-        if (mi.counter >= mi.cfg.failedThreshold) newState = QualifiedState::QualifiedFailed;
-        else if (mi.counter <= -static_cast<int>(mi.cfg.passedThreshold)) newState = QualifiedState::QualifiedPassed;
-
-        if (newState != mi.qualified && newState != QualifiedState::Unqualified) {
-            mi.qualified = newState;
-            QualifiedNotifier notifier = mi.notifier;
-            MonitorId mid = it->first;
-            lk.unlock();
-            if (notifier) notifier(mid, mi.qualified);
-            lk.lock();
-            // counter remains at threshold to prevent re-notify until reset by opposite events
-        } else {
-            // if the opposite pre event reduces counter below threshold, reset qualified state
-            if (mi.qualified != QualifiedState::Unqualified && newState == QualifiedState::Unqualified) {
-                mi.qualified = QualifiedState::Unqualified;
-                QualifiedNotifier notifier = mi.notifier;
-                MonitorId mid = it->first;
-                lk.unlock();
-                if (notifier) notifier(mid, mi.qualified);
-                lk.lock();
-            }
+        run_pre_event_buckets(pending, dispatched);
+    }
+    deliver(pending);
+    return applied;
+}
+
+std::optional<MonitorHandle> DMEvent::GetMonitorHandle(const MonitorId &id) {
+    const common::ApiCallScope scope("DMEvent::GetMonitorHandle");
+    common::ProfiledLockGuard lk(g_mutex);
+    MonitorInstance *entry = find_monitor(id);
+    if (entry == nullptr) return std::nullopt;
+    return take_handle(*entry);
+}
+
+// Apply pre-events by handle under one lock acquisition; returns the number
+// of live handles.
+static std::size_t apply_handle_updates(const HandlePreEventUpdate *updates, std::size_t count) {
+    const std::uint64_t dispatched = trace_dispatch();
+    PendingNotifications pending;
+    std::size_t applied = 0;
+    {
+        common::ProfiledLockGuard lk(g_mutex);
+        for (std::size_t i = 0; i < count; ++i) {
+            MonitorInstance *entry = resolve_handle(updates[i].handle);
+            if (entry == nullptr) continue;
+            ++applied;
+            if (entry->frozen) continue;
+            g_preBuckets[static_cast<std::size_t>(entry->policy)].push_back(
+                PreEventRef{entry, updates[i].preFailed, trace_reported(dispatched, updates[i].reportedNs)});
         }
-    } else { // TimeBased
-        auto now = steady_clock::now();
-        // same pre state continues -> start or continue timer
-        if (!mi.lastPreFailed.has_value() || mi.lastPreFailed.value() != preFailed) {
-            // state changed: reset timer
-            mi.lastPreFailed = preFailed;
-            mi.preStartTime = now;
-            mi.armedForTimeQualification = true;
-            // If previously qualified and opposite preSeen, reset qualification
-            if (mi.qualified != QualifiedState::Unqualified) {
-                mi.qualified = QualifiedState::Unqualified;
-                QualifiedNotifier notifier = mi.notifier;
-                MonitorId mid = it->first;
-                lk.unlock();
-                if (notifier) notifier(mid, mi.qualified);
-                lk.lock();
-            }
-        } else {
-            // continuing; worker thread will promote to qualified when threshold elapsed
-            // but we can do an immediate check here too for responsiveness
-            if (mi.preStartTime.has_value()) {
-                auto elapsed = duration_cast<milliseconds>(now - mi.preStartTime.value()).count();
-                if (elapsed >= static_cast<int64_t>(mi.cfg.timeThresholdMs) && mi.qualified == QualifiedState::Unqualified) {
-                    mi.qualified = (preFailed ? QualifiedState::QualifiedFailed : QualifiedState::QualifiedPassed);
-                    QualifiedNotifier notifier = mi.notifier;
-                    MonitorId mid = it->first;
-                    lk.unlock();
-                    if (notifier) notifier(mid, mi.qualified);
-                    lk.lock();
-                    // disarm timer until next pre event change
-                    mi.preStartTime.reset();
-                    mi.armedForTimeQualification = false;
-                }
+        run_pre_event_buckets(pending, dispatched);
+    }
+    deliver(pending);
+    return applied;
+}
+
+// --- Overload protection (reports by handle) ---
+
+// Counter bumped on every report of a storm, striped by thread so that
+// reporters do not share a cache line.
+class StripedCounter {
+public:
+    void Add(std::uint64_t n) noexcept { stripes_[StripeIndex()].value.fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t Sum() const noexcept {
+        std::uint64_t sum = 0;
+        for (const Stripe &s : stripes_) sum += s.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+
+private:
+    static constexpr std::size_t kStripes = 16;
+    struct alignas(64) Stripe {
+        std::atomic<std::uint64_t> value{0};
+    };
+    static std::size_t StripeIndex() noexcept {
+        static std::atomic<std::size_t> next{0};
+        thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % kStripes;
+        return index;
+    }
+    Stripe stripes_[kStripes];
+};
+
+enum class Admission : std::uint8_t { Apply, Filtered, Dropped, Deferred, Stale };
+
+static std::atomic<bool> g_overloadActive{false};
+static std::atomic<bool> g_filterRepeats{false};
+static std::atomic<std::uint32_t> g_budget{0};
+static std::atomic<OverloadAction> g_overBudget{OverloadAction::Drop};
+// DmClock second the budget counts in (high half) and the reports counted
+// in it (low half): one word, so a window reset cannot lose a count.
+constexpr std::uint64_t kNoBudgetWindow = std::uint64_t{UINT32_MAX} << 32;
+static std::atomic<std::uint64_t> g_budgetWindow{kNoBudgetWindow};
+static StripedCounter g_statFiltered;
+static StripedCounter g_statDropped;
+static StripedCounter g_statDeferred;
+static StripedCounter g_statDeferredApplied;
+
+// Handles with a deferred pre-state, applied by run_deferred.
+static std::mutex g_deferMutex;
+static std::pmr::vector<MonitorHandle> g_deferredHandles{queue_memory()};
+static bool g_deferRunQueued{false};
+
+static void run_deferred();
+
+static steady_clock::time_point next_budget_window() {
+    return time_point_cast<seconds>(common::DmClock::Now()) + seconds(1);
+}
+
+// Count one pre-event against the budget of the current second.
+static bool within_budget(std::uint32_t budget) {
+    const auto window = static_cast<std::uint32_t>(duration_cast<seconds>(common::DmClock::Now().time_since_epoch()).count());
+    std::uint64_t state = g_budgetWindow.load(std::memory_order_relaxed);
+    for (;;) {
+        // any other second starts a new count (the clock may have been switched back)
+        const std::uint32_t used = static_cast<std::uint32_t>(state >> 32) == window ? static_cast<std::uint32_t>(state) : 0;
+        if (used >= budget) return false;
+        if (g_budgetWindow.compare_exchange_weak(state, (std::uint64_t{window} << 32) | (used + 1),
+                                                 std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+// g_deferMutex held.
+static void queue_deferred_run() {
+    if (g_deferRunQueued) return;
+    g_deferRunQueued = common::Executor::PostAt(common::TaskLane::Bulk, next_budget_window(), run_deferred).HasValue();
+}
+
+// Keep the latest pre-state of an over-budget monitor for the next window.
+static void defer(HandleSlot &slot, MonitorHandle handle, bool preFailed) {
+    g_statDeferred.Add(1);
+    const std::uint8_t pre = preFailed ? kDeferredPreFailed : kDeferredPrePassed;
+    if (slot.deferred.exchange(pre, std::memory_order_acq_rel) != 0) return;   // queued already: replaced
+    std::lock_guard<std::mutex> lk(g_deferMutex);
+    g_deferredHandles.push_back(handle);
+    queue_deferred_run();
+}
+
+// The overload checks of one report, before any lock is taken.
+static Admission admit(MonitorHandle handle, bool preFailed) {
+    HandleSlot *slot = live_slot(handle);
+    if (slot == nullptr) return Admission::Stale;
+    // With a deferred pre-state pending, this report must not overtake it
+    // and the repeat bits describe the state before it: replace it instead.
+    if (slot->deferred.load(std::memory_order_acquire) != 0) {
+        defer(*slot, handle, preFailed);
+        return Admission::Deferred;
+    }
+    if (g_filterRepeats.load(std::memory_order_relaxed) &&
+        (slot->repeatNoop.load(std::memory_order_acquire) & (preFailed ? kRepeatPreFailed : kRepeatPrePassed)) != 0) {
+        g_statFiltered.Add(1);
+        return Admission::Filtered;
+    }
+    const std::uint32_t budget = g_budget.load(std::memory_order_relaxed);
+    if (budget == 0 || within_budget(budget)) return Admission::Apply;
+    if (g_overBudget.load(std::memory_order_relaxed) == OverloadAction::Drop) {
+        g_statDropped.Add(1);
+        return Admission::Dropped;
+    }
+    defer(*slot, handle, preFailed);
+    return Admission::Deferred;
+}
+
+// Bulk lane: apply deferred pre-states within the new window's budget. The
+// pre-state is taken under g_mutex, so a report admitted after it is
+// applied after it.
+static void run_deferred() {
+    std::pmr::vector<MonitorHandle> handles{queue_memory()};
+    {
+        std::lock_guard<std::mutex> lk(g_deferMutex);
+        handles.swap(g_deferredHandles);
+        g_deferRunQueued = false;
+    }
+    PendingNotifications pending;
+    std::size_t done = 0;
+    std::uint64_t applied = 0;
+    {
+        common::ProfiledLockGuard lk(g_mutex);
+        for (; done < handles.size(); ++done) {
+            HandleSlot *slot = live_slot(handles[done]);
+            if (slot == nullptr || slot->deferred.load(std::memory_order_acquire) == 0) continue;
+            if (slot->mi->frozen) {   // discarded like a direct report, without using the budget
+                slot->deferred.store(0, std::memory_order_release);
+                continue;
             }
+            const std::uint32_t budget = g_budget.load(std::memory_order_relaxed);
+            if (budget != 0 && !within_budget(budget)) break;
+            const std::uint8_t pre = slot->deferred.exchange(0, std::memory_order_acq_rel);
+            g_preBuckets[static_cast<std::size_t>(slot->mi->policy)].push_back(
+                PreEventRef{slot->mi, pre == kDeferredPreFailed});
+            ++applied;
+        }
+        run_pre_event_buckets(pending);
+    }
+    if (done < handles.size()) {   // over budget again: the rest waits another window
+        std::lock_guard<std::mutex> lk(g_deferMutex);
+        g_deferredHandles.insert(g_deferredHandles.end(), handles.begin() + static_cast<std::ptrdiff_t>(done), handles.end());
+        queue_deferred_run();
+    }
+    g_statDeferredApplied.Add(applied);
+    deliver(pending);
+}
+
+ara::core::Result<void> DMEvent::ReportPreEvent(MonitorHandle handle, bool preFailed) {
+    const common::ApiCallScope scope("DMEvent::ReportPreEvent");
+    if (g_overloadActive.load(std::memory_order_relaxed)) {
+        switch (admit(handle, preFailed)) {
+        case Admission::Stale:
+            return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        case Admission::Dropped:
+            return ara::core::Result<void>{ std::make_error_code(std::errc::resource_unavailable_try_again) };
+        case Admission::Filtered:
+        case Admission::Deferred:
+            return ara::core::Result<void>{};
+        case Admission::Apply:
+            break;
+        }
+    }
+    const HandlePreEventUpdate update{handle, preFailed};
+    if (apply_handle_updates(&update, 1) == 0) {
+        return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    }
+    return ara::core::Result<void>{};
+}
+
+std::size_t DMEvent::ReportPreEvents(const HandlePreEventUpdate *updates, std::size_t count) {
+    const common::ApiCallScope scope("DMEvent::ReportPreEvents");
+    if (!g_overloadActive.load(std::memory_order_relaxed)) return apply_handle_updates(updates, count);
+    // Admitted updates are applied in chunks from the stack; a thread_local
+    // vector would allocate its exit handler on each thread's first call.
+    constexpr std::size_t kChunk = 64;
+    HandlePreEventUpdate admitted[kChunk];
+    std::size_t pending = 0;
+    std::size_t live = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Admission a = admit(updates[i].handle, updates[i].preFailed);
+        if (a != Admission::Stale) ++live;
+        if (a != Admission::Apply) continue;
+        admitted[pending++] = updates[i];
+        if (pending == kChunk) {
+            apply_handle_updates(admitted, pending);
+            pending = 0;
         }
     }
+    if (pending != 0) apply_handle_updates(admitted, pending);
+    return live;
+}
+
+bool DMEvent::FilterRepeatedPreEvent(MonitorHandle handle, bool preFailed) {
+    if (!g_filterRepeats.load(std::memory_order_relaxed)) return false;
+    HandleSlot *slot = live_slot(handle);
+    if (slot == nullptr || slot->deferred.load(std::memory_order_acquire) != 0) return false;
+    if ((slot->repeatNoop.load(std::memory_order_acquire) & (preFailed ? kRepeatPreFailed : kRepeatPrePassed)) == 0) {
+        return false;
+    }
+    g_statFiltered.Add(1);
+    return true;
+}
+
+void DMEvent::SetOverloadPolicy(const OverloadPolicy &policy) {
+    g_filterRepeats.store(policy.filterRepeats, std::memory_order_relaxed);
+    g_budget.store(policy.budgetPerSecond, std::memory_order_relaxed);
+    g_budgetWindow.store(kNoBudgetWindow, std::memory_order_relaxed);   // a new policy counts afresh
+    g_overBudget.store(policy.overBudget, std::memory_order_relaxed);
+    g_overloadActive.store(policy.filterRepeats || policy.budgetPerSecond != 0, std::memory_order_relaxed);
+}
+
+OverloadStatistics DMEvent::GetOverloadStatistics() {
+    OverloadStatistics s;
+    s.filtered = g_statFiltered.Sum();
+    s.dropped = g_statDropped.Sum();
+    s.deferred = g_statDeferred.Sum();
+    s.deferredApplied = g_statDeferredApplied.Sum();
+    return s;
+}
 
-    return std::error_code{};
+ara::core::Result<void> DMEvent::AddQualifiedStateWaiter(const MonitorId &id, QualifiedStateWaiter &waiter) {
+    const common::ApiCallScope scope("DMEvent::AddQualifiedStateWaiter");
+    common::ProfiledLockGuard lk(g_mutex);
+    MonitorInstance *entry = find_monitor(id);
+    if (entry == nullptr) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    MonitorCold &c = cold(*entry);
+    waiter.next = c.waiters;
+    c.waiters = &waiter;
+    return ara::core::Result<void>{};
 }
 
 std::optional<QualifiedState> DMEvent::GetQualifiedState(const MonitorId &id) {
-    std::lock_guard<std::mutex> lk(g_mutex);
-    auto it = g_monitors.find(id);
-    if (it == g_monitors.end()) return std::nullopt;
-    return it->second.qualified;
+    common::ProfiledLockGuard lk(g_mutex);
+    MonitorInstance *entry = find_monitor(id);
+    if (entry == nullptr) return std::nullopt;
+    return entry->qualified;
 }
 
-std::error_code DMEvent::SetQualifiedState(const MonitorId &id, QualifiedState state) {
-    std::unique_lock<std::mutex> lk(g_mutex);
-    auto it = g_monitors.find(id);
-    if (it == g_monitors.end()) return make_error_code(std::errc::no_such_file_or_directory);
-    MonitorInstance &mi = it->second;
-    mi.qualified = state;
-    QualifiedNotifier notifier = mi.notifier;
-    MonitorId mid = it->first;
-    lk.unlock();
-    if (notifier) notifier(mid, state);
-    return std::error_code{};
+// A reported qualified result also moves the debounce state to match it.
+static void apply_qualified(MonitorInstance &mi, QualifiedState state, steady_clock::time_point now,
+                            NotificationList &out) {
+    with_group(mi.policy, [&](auto &group) {
+        using Policy = typename std::decay_t<decltype(group)>::PolicyType;
+        DebounceTimers timers{timer_wheel(), mi.slot};
+        Policy::OnQualified(group.ParamsOf(mi.slot), group.states[mi.slot], state, timers);
+    });
+    set_qualified(mi, state, now, out);
 }
 
-std::error_code DMEvent::FreezeDebouncing(const MonitorId &id) {
-    std::lock_guard<std::mutex> lk(g_mutex);
-    auto it = g_monitors.find(id);
-    if (it == g_monitors.end()) return make_error_code(std::errc::no_such_file_or_directory);
-    it->second.frozen = true;
-    return std::error_code{};
+ara::core::Result<void> DMEvent::SetQualifiedState(const MonitorId &id, QualifiedState state) {
+    const common::ApiCallScope scope("DMEvent::SetQualifiedState");
+    const std::uint64_t dispatched = trace_dispatch();
+    PendingNotifications pending;
+    {
+        common::ProfiledLockGuard lk(g_mutex);
+        MonitorInstance *entry = find_monitor(id);
+        if (entry == nullptr) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        t_applying = AppliedReport{dispatched, dispatched};
+        apply_qualified(*entry, state, common::DmClock::Now(), pending);
+        t_applying = AppliedReport{};
+    }
+    deliver(pending);
+    return ara::core::Result<void>{};
 }
 
-std::error_code DMEvent::ResetDebouncing(const MonitorId &id) {
-    std::unique_lock<std::mutex> lk(g_mutex);
-    auto it = g_monitors.find(id);
-    if (it == g_monitors.end()) return make_error_code(std::errc::no_such_file_or_directory);
-    MonitorInstance &mi = it->second;
-    mi.counter = 0;
-    mi.preStartTime.reset();
-    mi.lastPreFailed.reset();
-    mi.armedForTimeQualification = false;
-    mi.frozen = false;
-    mi.qualified = QualifiedState::Unqualified;
-    QualifiedNotifier notifier = mi.notifier;
-    MonitorId mid = it->first;
-    // notify de-qualification
-    lk.unlock();
-    if (notifier) notifier(mid, mi.qualified);
-    return std::error_code{};
-}
-
-std::error_code DMEvent::TriggerFdcThresholdReached(const MonitorId &id) {
-    std::unique_lock<std::mutex> lk(g_mutex);
-    auto it = g_monitors.find(id);
-    if (it == g_monitors.end()) return make_error_code(std::errc::no_such_file_or_directory);
-    // signal consumer that FDC threshold reached; here we call notifier with current qualified state
-    QualifiedNotifier notifier = it->second.notifier;
-    QualifiedState state = it->second.qualified;
-    MonitorId mid = it->first;
-    lk.unlock();
-    if (notifier) notifier(mid, state);
-    return std::error_code{};
-}
-
-std::error_code DMEvent::ResetTestFailed(const MonitorId &id) {
-    std::unique_lock<std::mutex> lk(g_mutex);
-    auto it = g_monitors.find(id);
-    if (it == g_monitors.end()) return make_error_code(std::errc::no_such_file_or_directory);
-    // reset only the TestFailed status: we interpret as de-qualify (Unqualified) but keep counters
-    MonitorInstance &mi = it->second;
-    mi.qualified = QualifiedState::Unqualified;
-    QualifiedNotifier notifier = mi.notifier;
-    MonitorId mid = it->first;
-    lk.unlock();
-    if (notifier) notifier(mid, mi.qualified);
-    return std::error_code{};
-}
-
-// Ensure worker stopped at unload (best effort)
+std::size_t DMEvent::SetQualifiedStates(const QualifiedUpdate *updates, std::size_t count) {
+    const common::ApiCallScope scope("DMEvent::SetQualifiedStates");
+    const std::uint64_t dispatched = trace_dispatch();
+    PendingNotifications pending;
+    std::size_t applied = 0;
+    {
+        common::ProfiledLockGuard lk(g_mutex);
+        const auto now = common::DmClock::Now();
+        t_applying.dispatchedNs = dispatched;
+        for (std::size_t i = 0; i < count; ++i) {
+            MonitorInstance *entry = find_monitor(*updates[i].id);
+            if (entry == nullptr) continue;
+            t_applying.reportedNs = trace_reported(dispatched, updates[i].reportedNs);
+            apply_qualified(*entry, updates[i].state, now, pending);
+            ++applied;
+        }
+        t_applying = AppliedReport{};
+    }
+    deliver(pending);
+    return applied;
+}
+
+ara::core::Result<void> DMEvent::FreezeDebouncing(const MonitorId &id) {
+    const common::ApiCallScope scope("DMEvent::FreezeDebouncing");
+    common::ProfiledLockGuard lk(g_mutex);
+    MonitorInstance *entry = find_monitor(id);
+    if (entry == nullptr) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    entry->frozen = true;
+    refresh_repeat_filter(*entry);
+    return ara::core::Result<void>{};
+}
+
+ara::core::Result<void> DMEvent::ResetDebouncing(const MonitorId &id) {
+    const common::ApiCallScope scope("DMEvent::ResetDebouncing");
+    PendingNotifications pending;
+    {
+        common::ProfiledLockGuard lk(g_mutex);
+        MonitorInstance *entry = find_monitor(id);
+        if (entry == nullptr) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        MonitorInstance &mi = *entry;
+        with_group(mi.policy, [&](auto &group) {
+            using Policy = typename std::decay_t<decltype(group)>::PolicyType;
+            DebounceTimers timers{timer_wheel(), mi.slot};
+            Policy::Reset(group.states[mi.slot], timers);
+        });
+        mi.frozen = false;
+        // notify de-qualification
+        set_qualified(mi, QualifiedState::Unqualified, common::DmClock::Now(), pending);
+    }
+    deliver(pending);
+    return ara::core::Result<void>{};
+}
+
+ara::core::Result<void> DMEvent::TriggerFdcThresholdReached(const MonitorId &id) {
+    const common::ApiCallScope scope("DMEvent::TriggerFdcThresholdReached");
+    PendingNotifications pending;
+    {
+        common::ProfiledLockGuard lk(g_mutex);
+        MonitorInstance *entry = find_monitor(id);
+        if (entry == nullptr) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        // signal consumer that FDC threshold reached; here we call notifier with current qualified state
+        queue_fdc_reached(*entry, pending);
+    }
+    deliver(pending);
+    return ara::core::Result<void>{};
+}
+
+ara::core::Result<void> DMEvent::ResetTestFailed(const MonitorId &id) {
+    const common::ApiCallScope scope("DMEvent::ResetTestFailed");
+    PendingNotifications pending;
+    {
+        common::ProfiledLockGuard lk(g_mutex);
+        MonitorInstance *entry = find_monitor(id);
+        if (entry == nullptr) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        // reset only the TestFailed status: we interpret as de-qualify (Unqualified) but keep counters
+        set_qualified(*entry, QualifiedState::Unqualified, common::DmClock::Now(), pending);
+    }
+    deliver(pending);
+    return ara::core::Result<void>{};
+}
+
+std::optional<std::uint8_t> DMEvent::GetEventStatus(const MonitorId &id) {
+    common::ProfiledLockGuard lk(g_mutex);
+    MonitorInstance *entry = find_monitor(id);
+    if (entry == nullptr) return std::nullopt;
+    return entry->statusByte;
+}
+
+ara::core::Result<void> DMEvent::SetEventStatusNotifier(const MonitorId &id, EventStatusNotifier notifier,
+                                                        milliseconds minInterval) {
+    const common::ApiCallScope scope("DMEvent::SetEventStatusNotifier");
+    if (notifier && minInterval.count() > 0) {
+        auto started = common::Executor::Start();
+        if (started.HasError()) return started;
+    }
+    common::ProfiledLockGuard lk(g_mutex);
+    MonitorInstance *entry = find_monitor(id);
+    if (entry == nullptr) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    if (minInterval.count() < 0) return ara::core::Result<void>{ std::make_error_code(std::errc::invalid_argument) };
+    MonitorInstance &mi = *entry;
+    MonitorCold &c = cold(mi);
+    const MonitorNotifiers *current = c.notifiers.Get();
+    const bool replacing = notifier && current != nullptr && current->status;
+    set_notifiers(mi, current != nullptr ? current->qualified : nullptr, std::move(notifier));
+    const auto intervalMs = static_cast<std::uint32_t>(std::min<milliseconds::rep>(minInterval.count(), UINT32_MAX));
+    if (intervalMs == 0) {
+        if (mi.paced) g_statusPacing.erase(mi.index);
+        mi.paced = false;
+    } else {
+        g_statusPacing[mi.index].intervalMs = intervalMs;
+        mi.paced = true;
+    }
+    if (!replacing) {
+        // the subscriber reads the current byte itself; only later changes are notified
+        mi.deliveredStatus = mi.statusByte;
+        if (mi.paced) g_statusPacing[mi.index].lastDelivery = steady_clock::time_point::min();
+        mi.statusPending = false;
+    }
+    return ara::core::Result<void>{};
+}
+
+ara::core::Result<StateStreamId> DMEvent::OpenStateStream(std::size_t capacity) {
+    const common::ApiCallScope scope("DMEvent::OpenStateStream");
+    using R = ara::core::Result<StateStreamId>;
+    if (capacity == 0 || capacity > (std::size_t{1} << 24)) return R{ std::make_error_code(std::errc::invalid_argument) };
+    std::size_t rounded = 1;
+    while (rounded < capacity) rounded <<= 1;
+    common::ProfiledLockGuard lk(g_mutex);
+    for (std::uint32_t i = 0; i < kMaxStateStreams; ++i) {
+        if (g_streamStorage[i]) continue;
+        g_streamStorage[i] = common::AllocateUnique<StateStream>(queue_memory(), rounded);
+        g_streams.push_back(g_streamStorage[i].get());
+        g_streamSlots[i].store(g_streamStorage[i].get(), std::memory_order_release);
+        return R{ static_cast<StateStreamId>(i + 1) };
+    }
+    return R{ std::make_error_code(std::errc::too_many_files_open) };
+}
+
+ara::core::Result<void> DMEvent::CloseStateStream(StateStreamId stream) {
+    const common::ApiCallScope scope("DMEvent::CloseStateStream");
+    common::ProfiledLockGuard lk(g_mutex);
+    if (stream == 0 || stream > kMaxStateStreams || !g_streamStorage[stream - 1]) {
+        return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    }
+    StateStream *closed = g_streamStorage[stream - 1].get();
+    g_streams.erase(std::find(g_streams.begin(), g_streams.end(), closed));
+    g_streamSlots[stream - 1].store(nullptr, std::memory_order_release);
+    g_streamStorage[stream - 1].reset();
+    return ara::core::Result<void>{};
+}
+
+std::size_t DMEvent::ReadStateStream(StateStreamId stream, StateChange *out, std::size_t max) {
+    if (stream == 0 || stream > kMaxStateStreams) return 0;
+    StateStream *s = g_streamSlots[stream - 1].load(std::memory_order_acquire);
+    if (s == nullptr) return 0;
+    const std::size_t head = s->head.load(std::memory_order_relaxed);
+    const std::size_t n = std::min(max, s->tail.load(std::memory_order_acquire) - head);
+    for (std::size_t i = 0; i < n; ++i) out[i] = s->ring[(head + i) & s->mask];
+    s->head.store(head + n, std::memory_order_release);
+    return n;
+}
+
+common::MemoryFootprint DMEvent::GetMemoryFootprint() {
+    common::ProfiledLockGuard lk(g_mutex);
+    common::MemoryFootprint f;
+    f.entities = hot_records().size() - g_freeRecords.size();
+    f.hotBytes = hot_records().size() * sizeof(MonitorInstance);
+    f.coldBytes = cold_records().size() * sizeof(MonitorCold) + common::UnorderedMapBytes(g_statusPacing);
+    for (const MonitorCold &c : cold_records()) {
+        if (c.name != nullptr) f.coldBytes += name_bytes(c.name->size);
+        if (const MonitorNotifiers *n = c.notifiers.Get()) f.coldBytes += sizeof(MonitorNotifiers) + n->id.capacity() + 1;
+    }
+    f.indexBytes = common::UnorderedMapBytes(g_monitors) + g_nameIndex.MemoryBytes() +
+                   g_indexed.capacity() * sizeof(const MonitorName *) +
+                   g_freeRecords.capacity() * sizeof(std::uint32_t);
+    f.indexBytes += (g_handleCount + kHandleChunkSize - 1) / kHandleChunkSize * kHandleChunkSize * sizeof(HandleSlot);
+    for (std::size_t p = 0; p < kPolicyCount; ++p) {
+        f.debounceBytes += with_group(static_cast<DebouncePolicy>(p), [](const auto &group) {
+            using Policy = typename std::decay_t<decltype(group)>::PolicyType;
+            return group.paramSets.capacity() * sizeof(typename Policy::Params) +
+                   group.setUsers.capacity() * sizeof(std::uint32_t) + group.paramIds.capacity() * sizeof(std::uint32_t) + group.states.capacity() * sizeof(typename Policy::State) +
+                   group.owners.capacity() * sizeof(std::uint32_t) + group.freeSlots.capacity() * sizeof(std::uint32_t);
+        });
+    }
+    return f;
+}
+
+// Stop the executor before this module's state goes away at unload, so no
+// queued task runs against it (best effort)
 struct WorkerStopper {
-    ~WorkerStopper() { stop_worker(); }
+    ~WorkerStopper() { common::Executor::Shutdown(); }
 };
 static WorkerStopper g_workerStopper;
 
 }  // namespace event
 }  // namespace diagnostic_manager
-
-#endif // DM_EVENT_H
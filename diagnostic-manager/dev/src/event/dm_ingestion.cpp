@@ -0,0 +1,327 @@
+#include "event/dm_ingestion.h"
+#include "common/dm_latency_trace.h"
+#include "common/dm_memory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace diagnostic_manager {
+namespace event {
+
+namespace {
+
+constexpr std::size_t kCacheLine = 64;
+
+struct Record {
+    MonitorHandle handle;
+    bool preFailed;
+    std::uint64_t reportedNs;   // queue time while latency tracing is on, else 0
+};
+
+// Queue of one reporting thread. The producer side is written only by that
+// thread; the consumer side by whichever consumer holds `draining`.
+struct ReportQueue {
+    ReportQueue(std::size_t capacity, std::size_t homeConsumer)
+        : records(capacity), mask(capacity - 1), home(homeConsumer) {
+        common::DmMemory::Track(common::MemorySubsystem::Queues, 1, static_cast<std::ptrdiff_t>(Bytes()));
+    }
+    ~ReportQueue() {
+        common::DmMemory::Track(common::MemorySubsystem::Queues, -1, -static_cast<std::ptrdiff_t>(Bytes()));
+    }
+
+    std::size_t Bytes() const noexcept { return sizeof(ReportQueue) + records.size() * sizeof(Record); }
+
+    std::vector<Record> records;
+    const std::size_t mask;
+    const std::size_t home;
+
+    alignas(kCacheLine) std::atomic<std::uint64_t> tail{0};
+    std::uint64_t headCache{0};               // producer's last view of head
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<bool> closed{false};          // producer thread has exited
+
+    alignas(kCacheLine) std::atomic<std::uint64_t> head{0};
+    std::atomic<bool> draining{false};        // a consumer owns the read side
+};
+
+struct alignas(kCacheLine) ConsumerStats {
+    std::atomic<std::uint64_t> applied{0};
+    std::atomic<std::uint64_t> stale{0};
+    std::atomic<std::uint64_t> batches{0};
+    std::atomic<std::uint64_t> stolen{0};
+};
+
+// Unregisters the thread's queue when the thread exits.
+struct LocalQueue {
+    std::shared_ptr<ReportQueue> queue;
+    std::uint64_t session{0};
+    ~LocalQueue() {
+        if (queue) queue->closed.store(true, std::memory_order_release);
+    }
+};
+
+thread_local LocalQueue t_local;
+
+std::mutex g_ingestionMutex;   // Start / Stop / queue registration
+IngestionConfig g_cfg;
+std::vector<std::shared_ptr<ReportQueue>> g_queues;
+std::atomic<std::uint64_t> g_queuesVersion{0};
+std::size_t g_nextHome{0};
+std::uint64_t g_retiredDropped{0};
+std::atomic<bool> g_running{false};
+std::atomic<std::uint64_t> g_session{0};   // bumped by Start and Stop
+std::atomic<bool> g_stop{false};
+std::vector<std::thread> g_consumers;
+std::unique_ptr<ConsumerStats[]> g_stats;
+
+std::mutex g_sleepMutex;
+std::condition_variable g_sleepCv;
+std::atomic<std::uint32_t> g_sleepers{0};
+
+std::size_t round_up_pow2(std::size_t n) {
+    std::size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+ara::core::Result<void> register_queue() {
+    std::lock_guard<std::mutex> lk(g_ingestionMutex);
+    if (!g_running.load(std::memory_order_relaxed)) {
+        return ara::core::Result<void>{ std::make_error_code(std::errc::not_connected) };
+    }
+    if (t_local.queue) t_local.queue->closed.store(true, std::memory_order_release);
+    t_local.queue = std::make_shared<ReportQueue>(g_cfg.queueCapacity, g_nextHome++ % g_cfg.consumers);
+    t_local.session = g_session.load(std::memory_order_relaxed);
+    g_queues.push_back(t_local.queue);
+    g_queuesVersion.fetch_add(1, std::memory_order_release);
+    return ara::core::Result<void>{};
+}
+
+void wake_consumers() {
+    { std::lock_guard<std::mutex> lk(g_sleepMutex); }
+    g_sleepCv.notify_all();
+}
+
+// Move up to drainBatch records of `q` into DMEvent. The queue stays owned
+// until they are applied, so a reporter's pre-events are never reordered.
+bool drain(ReportQueue &q, std::vector<HandlePreEventUpdate> &batch, ConsumerStats &stats, bool stolen) {
+    bool expected = false;
+    if (!q.draining.compare_exchange_strong(expected, true, std::memory_order_acquire)) return false;
+    const std::uint64_t head = q.head.load(std::memory_order_relaxed);
+    const std::uint64_t tail = q.tail.load(std::memory_order_acquire);
+    if (head == tail) {
+        q.draining.store(false, std::memory_order_release);
+        return false;
+    }
+    const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(tail - head, g_cfg.drainBatch));
+    batch.clear();
+    for (std::size_t i = 0; i < n; ++i) {
+        const Record &r = q.records[(head + i) & q.mask];
+        batch.push_back(HandlePreEventUpdate{r.handle, r.preFailed, r.reportedNs});
+    }
+    q.head.store(head + n, std::memory_order_release);
+    const std::size_t applied = DMEvent::ReportPreEvents(batch.data(), n);
+    q.draining.store(false, std::memory_order_release);
+
+    stats.applied.fetch_add(applied, std::memory_order_relaxed);
+    stats.stale.fetch_add(n - applied, std::memory_order_relaxed);
+    stats.batches.fetch_add(1, std::memory_order_relaxed);
+    if (stolen) stats.stolen.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+std::uint64_t backlog(const ReportQueue &q) {
+    return q.tail.load(std::memory_order_relaxed) - q.head.load(std::memory_order_relaxed);
+}
+
+// Take a new snapshot of the queues, dropping those whose thread has exited
+// and that are fully drained.
+void refresh(std::vector<std::shared_ptr<ReportQueue>> &queues, std::uint64_t &version) {
+    std::lock_guard<std::mutex> lk(g_ingestionMutex);
+    const auto gone = [](const std::shared_ptr<ReportQueue> &q) {
+        if (!q->closed.load(std::memory_order_acquire) || backlog(*q) != 0) return false;
+        g_retiredDropped += q->dropped.load(std::memory_order_relaxed);
+        return true;
+    };
+    const auto end = std::remove_if(g_queues.begin(), g_queues.end(), gone);
+    if (end != g_queues.end()) {
+        g_queues.erase(end, g_queues.end());
+        g_queuesVersion.fetch_add(1, std::memory_order_release);
+    }
+    queues = g_queues;
+    version = g_queuesVersion.load(std::memory_order_acquire);
+}
+
+void consumer_loop(std::size_t self) {
+    ConsumerStats &stats = g_stats[self];
+    std::vector<std::shared_ptr<ReportQueue>> queues;
+    std::uint64_t version = ~std::uint64_t{0};
+    std::vector<HandlePreEventUpdate> batch;
+    batch.reserve(g_cfg.drainBatch);
+    std::uint32_t idle = 0;
+
+    while (!g_stop.load(std::memory_order_acquire)) {
+        if (version != g_queuesVersion.load(std::memory_order_acquire)) refresh(queues, version);
+
+        bool worked = false;
+        for (const auto &q : queues) {
+            if (q->home == self) worked |= drain(*q, batch, stats, false);
+        }
+        if (!worked) {
+            // unbalanced: help with other consumers' backlogs
+            for (const auto &q : queues) {
+                if (q->home != self && backlog(*q) >= g_cfg.stealThreshold) worked |= drain(*q, batch, stats, true);
+            }
+        }
+        if (worked) {
+            idle = 0;
+            continue;
+        }
+        if (++idle < g_cfg.spinBeforeSleep) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Sleep until a reporter sees g_sleepers; the timeout bounds the
+        // latency of queues whose home consumer is asleep.
+        std::unique_lock<std::mutex> lk(g_sleepMutex);
+        g_sleepers.fetch_add(1, std::memory_order_seq_cst);
+        const bool pending = version != g_queuesVersion.load(std::memory_order_seq_cst) ||
+                             std::any_of(queues.begin(), queues.end(), [](const auto &q) { return backlog(*q) != 0; });
+        if (!pending && !g_stop.load(std::memory_order_acquire)) g_sleepCv.wait_for(lk, std::chrono::milliseconds(10));
+        g_sleepers.fetch_sub(1, std::memory_order_relaxed);
+        lk.unlock();
+        // after a wake-up every queue is fair game
+        for (const auto &q : queues) drain(*q, batch, stats, q->home != self);
+        idle = 0;
+    }
+}
+
+void join_consumers() {
+    g_stop.store(true, std::memory_order_release);
+    wake_consumers();
+    for (std::thread &t : g_consumers) t.join();
+    g_consumers.clear();
+}
+
+} // namespace
+
+ara::core::Result<void> DMIngestion::Start(const IngestionConfig &cfg) {
+    if (cfg.consumers == 0 || cfg.queueCapacity == 0 || cfg.drainBatch == 0) {
+        return ara::core::Result<void>{ std::make_error_code(std::errc::invalid_argument) };
+    }
+    std::lock_guard<std::mutex> lk(g_ingestionMutex);
+    if (g_running.load(std::memory_order_relaxed)) {
+        return ara::core::Result<void>{ std::make_error_code(std::errc::already_connected) };
+    }
+    g_cfg = cfg;
+    g_cfg.queueCapacity = round_up_pow2(cfg.queueCapacity);
+    g_queues.clear();
+    g_nextHome = 0;
+    g_retiredDropped = 0;
+    g_stats.reset(new ConsumerStats[cfg.consumers]);
+    g_stop.store(false, std::memory_order_release);
+
+    // Consumers enter their loop (which takes g_ingestionMutex) only once
+    // every one has applied its options; on failure they all just exit.
+    std::vector<std::future<std::error_code>> applied;
+    std::promise<bool> go;
+    const std::shared_future<bool> started = go.get_future().share();
+    for (std::size_t i = 0; i < cfg.consumers; ++i) {
+        const common::WorkerOptions opt = i < cfg.consumerOptions.size() ? cfg.consumerOptions[i] : common::WorkerOptions{};
+        std::promise<std::error_code> result;
+        applied.push_back(result.get_future());
+        g_consumers.emplace_back([i, opt, started, result = std::move(result)]() mutable {
+            const std::error_code ec = common::ApplyWorkerOptions("dm-ingest-" + std::to_string(i), opt);
+            result.set_value(ec);
+            if (started.get()) consumer_loop(i);
+        });
+    }
+    std::error_code failed;
+    for (auto &f : applied) {
+        const std::error_code ec = f.get();
+        if (ec && !failed) failed = ec;
+    }
+    go.set_value(!failed);
+    if (failed) {
+        join_consumers();
+        return ara::core::Result<void>{ failed };
+    }
+    g_session.fetch_add(1, std::memory_order_release);
+    g_running.store(true, std::memory_order_release);
+    return ara::core::Result<void>{};
+}
+
+void DMIngestion::Stop() {
+    std::vector<std::shared_ptr<ReportQueue>> queues;
+    {
+        std::lock_guard<std::mutex> lk(g_ingestionMutex);
+        if (!g_running.load(std::memory_order_relaxed)) return;
+        g_running.store(false, std::memory_order_release);
+        g_session.fetch_add(1, std::memory_order_release);
+        queues = g_queues;
+    }
+    join_consumers();
+
+    std::vector<HandlePreEventUpdate> batch;
+    batch.reserve(g_cfg.drainBatch);
+    for (const auto &q : queues) {
+        while (drain(*q, batch, g_stats[q->home], false)) {
+        }
+    }
+}
+
+ara::core::Result<void> DMIngestion::ReportPreEvent(MonitorHandle handle, bool preFailed) {
+    const common::ApiCallScope scope("DMIngestion::ReportPreEvent");
+    if (!t_local.queue || t_local.session != g_session.load(std::memory_order_acquire)) {
+        auto registered = register_queue();
+        if (registered.HasError()) return registered;
+    }
+    if (DMEvent::FilterRepeatedPreEvent(handle, preFailed)) return ara::core::Result<void>{};
+    ReportQueue &q = *t_local.queue;
+    const std::uint64_t tail = q.tail.load(std::memory_order_relaxed);
+    if (tail - q.headCache >= q.records.size()) {
+        q.headCache = q.head.load(std::memory_order_acquire);
+        if (tail - q.headCache >= q.records.size()) {
+            q.dropped.fetch_add(1, std::memory_order_relaxed);
+            return ara::core::Result<void>{ std::make_error_code(std::errc::resource_unavailable_try_again) };
+        }
+    }
+    const std::uint64_t reportedNs = common::LatencyTrace::Enabled() ? common::LatencyTrace::NowNs() : 0;
+    q.records[tail & q.mask] = Record{handle, preFailed, reportedNs};
+    q.tail.store(tail + 1, std::memory_order_release);
+
+    // pairs with the sleeper count update before a consumer's last check
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (g_sleepers.load(std::memory_order_relaxed) != 0) wake_consumers();
+    return ara::core::Result<void>{};
+}
+
+IngestionStatistics DMIngestion::GetStatistics() {
+    IngestionStatistics s;
+    std::lock_guard<std::mutex> lk(g_ingestionMutex);
+    s.dropped = g_retiredDropped;
+    for (const auto &q : g_queues) {
+        if (!q->closed.load(std::memory_order_relaxed)) ++s.queues;
+        s.dropped += q->dropped.load(std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; g_stats && i < g_cfg.consumers; ++i) {
+        s.applied += g_stats[i].applied.load(std::memory_order_relaxed);
+        s.stale += g_stats[i].stale.load(std::memory_order_relaxed);
+        s.batches += g_stats[i].batches.load(std::memory_order_relaxed);
+        s.stolenBatches += g_stats[i].stolen.load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+} // namespace event
+} // namespace diagnostic_manager
@@ -0,0 +1,729 @@
+#include "ipc/dm_ipc_server.h"
+
+#include "config/dm_config.h"
+#include "event/dm_event.h"
+#include "ara/diag/ipc/report_ring.h"
+#include "ara/diag/monitor_types.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace diagnostic_manager {
+namespace ipc {
+
+using ara::diag::MonitorAction;
+using ara::diag::ipc::DebounceKind;
+using ara::diag::ipc::HandshakeMessage;
+using ara::diag::ipc::kReportLanes;
+using ara::diag::ipc::MessageType;
+using ara::diag::ipc::ReportRecord;
+using ara::diag::ipc::ReportRing;
+using ara::diag::ipc::ClientSegment;
+using ara::diag::ipc::StatusRecord;
+using ara::diag::ipc::StatusRing;
+using event::DMEvent;
+using event::MonitorId;
+
+struct ClientConnection;
+
+// epoll user data: tells the loop which descriptor became ready.
+struct PollTag {
+    enum class Kind { Listen, Stop, Socket, Wakeup } kind;
+    ClientConnection *client{nullptr};
+};
+
+// Producer side of a client's status ring. Status changes are published
+// from DMEvent notifier threads, so unlike the rest of the connection this
+// is shared and locked; `closed` is set before the segment is unmapped.
+struct StatusSink {
+    std::mutex mutex;
+    StatusRing *ring{nullptr};
+    int eventFd{-1};
+    bool closed{false};
+};
+
+struct ClientConnection {
+    int socketFd{-1};
+    int eventFd{-1};
+    ClientSegment *segment{nullptr};
+    ReportRing *lanes{nullptr};           // segment->reports, kReportLanes rings
+    std::shared_ptr<StatusSink> statusSink;
+    std::vector<std::uint32_t> handles;   // monitors offered through this client
+    std::vector<std::pair<std::uint32_t, MonitorId>> subscriptions;   // status subscriptions by handle
+    std::uint32_t nextSubscription{1};
+    bool closing{false};                  // reaped after the current epoll batch
+    PollTag socketTag{PollTag::Kind::Socket, nullptr};
+    PollTag wakeTag{PollTag::Kind::Wakeup, nullptr};
+};
+
+// Everything below is owned by the drain thread except where noted.
+static std::unordered_map<int, std::unique_ptr<ClientConnection>> g_clients;  // by socket fd
+static std::vector<MonitorId> g_handleNames{MonitorId{}};                      // handle 0 is invalid
+static std::vector<event::MonitorHandle> g_handleMonitors{0};                  // DMEvent handle per IPC handle
+static std::vector<std::uint32_t> g_freeHandles;
+static std::unordered_set<MonitorId> g_offeredConfigured;                    // manifest monitors with a live handle
+static std::vector<ReportRecord> g_batch;
+static std::vector<event::QualifiedUpdate> g_qualifiedBatch;   // kPassed/kFailed run of the current batch
+static std::vector<event::HandlePreEventUpdate> g_preBatch;    // kPrepassed/kPrefailed run of the current batch
+static IpcServerConfig g_cfg;
+static int g_listenFd{-1};
+static int g_epollFd{-1};
+static int g_stopFd{-1};
+static PollTag g_listenTag{PollTag::Kind::Listen, nullptr};
+static PollTag g_stopTag{PollTag::Kind::Stop, nullptr};
+
+// Status subscribers per event (drain thread writes, notifier threads read).
+struct Subscription {
+    std::shared_ptr<StatusSink> sink;
+    std::uint32_t handle;
+    std::chrono::milliseconds interval;
+};
+struct EventSubscribers {
+    std::vector<Subscription> subs;
+    std::chrono::milliseconds interval{0};   // smallest interval any subscriber asked for
+};
+static std::mutex g_subsMutex;
+static std::unordered_map<MonitorId, EventSubscribers> g_subscriptions;
+
+// Start/Stop serialisation and statistics (any thread).
+static std::mutex g_ipcMutex;
+static std::thread g_ipcThread;
+static std::atomic<bool> g_ipcStop{false};
+static std::atomic<std::uint64_t> g_statClients{0};
+static std::atomic<std::uint64_t> g_statDrained{0};
+static std::atomic<std::uint64_t> g_statBatches{0};
+static std::atomic<std::uint64_t> g_statUnknown{0};
+static std::atomic<std::uint64_t> g_statMaxLatency{0};
+static std::atomic<std::uint64_t> g_statTotalLatency{0};
+static std::atomic<std::uint64_t> g_statDroppedClosed{0};   // drops of already closed clients
+static std::atomic<std::uint64_t> g_statDroppedLive{0};     // drops of connected clients, refreshed per pass
+static std::atomic<std::uint64_t> g_statStatusPublished{0};
+static std::atomic<std::uint64_t> g_statStatusDropped{0};
+
+static std::uint64_t monotonic_ns() noexcept {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+static std::string socket_path() {
+    if (!g_cfg.socketPath.empty()) return g_cfg.socketPath;
+    const char *env = std::getenv(ara::diag::ipc::kSocketPathEnv);
+    return (env && *env) ? std::string(env) : std::string(ara::diag::ipc::kDefaultSocketPath);
+}
+
+static event::DebounceConfig to_debounce_config(const HandshakeMessage &msg) {
+    event::DebounceConfig cfg;
+    switch (msg.debounceKind) {
+    case DebounceKind::kCounterBased:
+        cfg.mode = event::DebounceMode::CounterBased;
+        if (msg.counter.failedThreshold != 0) cfg.failedThreshold = std::abs(msg.counter.failedThreshold);
+        if (msg.counter.passedThreshold != 0) cfg.passedThreshold = std::abs(msg.counter.passedThreshold);
+        if (msg.counter.failedStepsize != 0) cfg.failedStep = msg.counter.failedStepsize;
+        if (msg.counter.passedStepsize != 0) cfg.passedStep = msg.counter.passedStepsize;
+        cfg.jumpUp = msg.counter.useJumpToFailed;
+        cfg.jumpDown = msg.counter.useJumpToPassed;
+        cfg.failedJumpValue = msg.counter.failedJumpValue;
+        cfg.passedJumpValue = msg.counter.passedJumpValue;
+        break;
+    case DebounceKind::kTimeBased:
+        cfg.mode = event::DebounceMode::TimeBased;
+        if (msg.time.failedMs != 0) cfg.timeFailedThresholdMs = msg.time.failedMs;
+        if (msg.time.passedMs != 0) cfg.timePassedThresholdMs = msg.time.passedMs;
+        break;
+    case DebounceKind::kMonitorInternal:
+    default:
+        cfg.mode = event::DebounceMode::MonitorInternal;
+        break;
+    }
+    return cfg;
+}
+
+static void flush_qualified() {
+    if (g_qualifiedBatch.empty()) return;
+    DMEvent::SetQualifiedStates(g_qualifiedBatch.data(), g_qualifiedBatch.size());
+    g_qualifiedBatch.clear();
+}
+
+static void flush_pre_events() {
+    if (g_preBatch.empty()) return;
+    DMEvent::ReportPreEvents(g_preBatch.data(), g_preBatch.size());
+    g_preBatch.clear();
+}
+
+static void flush_batches() {
+    flush_qualified();
+    flush_pre_events();
+}
+
+// Qualified results and pre-events are collected in runs and applied with
+// one DMEvent call per run; switching kind or any other action flushes the
+// pending run first so per-monitor ordering is kept.
+// Pre-events go by DMEvent handle, so the overload policy applies to them.
+// The report timestamp is passed on for latency tracing.
+static void dispatch(std::uint32_t handle, MonitorAction action, std::uint64_t reportedNs) {
+    const MonitorId &id = g_handleNames[handle];
+    switch (action) {
+    case MonitorAction::kPassed:
+    case MonitorAction::kFailed:
+        flush_pre_events();
+        g_qualifiedBatch.push_back(event::QualifiedUpdate{
+            &id,
+            action == MonitorAction::kFailed ? event::QualifiedState::QualifiedFailed : event::QualifiedState::QualifiedPassed,
+            reportedNs});
+        return;
+    case MonitorAction::kPrepassed:
+    case MonitorAction::kPrefailed:
+        flush_qualified();
+        g_preBatch.push_back(
+            event::HandlePreEventUpdate{g_handleMonitors[handle], action == MonitorAction::kPrefailed, reportedNs});
+        return;
+    default:
+        break;
+    }
+
+    flush_batches();
+    switch (action) {
+    case MonitorAction::kPassed:
+    case MonitorAction::kFailed:
+    case MonitorAction::kPrepassed:
+    case MonitorAction::kPrefailed:
+        break;
+    case MonitorAction::kFdcThresholdReached:
+        DMEvent::TriggerFdcThresholdReached(id);
+        break;
+    case MonitorAction::kResetTestFailed:
+        DMEvent::ResetTestFailed(id);
+        break;
+    case MonitorAction::kFreezeDebouncing:
+        DMEvent::FreezeDebouncing(id);
+        break;
+    case MonitorAction::kResetDebouncing:
+        DMEvent::ResetDebouncing(id);
+        break;
+    }
+}
+
+// DMEvent status notifier: fan the change out to every subscribed client.
+// The status path is rare and coalesced, so the eventfd is always signalled.
+static void publish_status(const MonitorId &id, std::uint8_t status) {
+    std::lock_guard<std::mutex> lk(g_subsMutex);
+    auto it = g_subscriptions.find(id);
+    if (it == g_subscriptions.end()) return;
+    for (const Subscription &sub : it->second.subs) {
+        StatusSink &sink = *sub.sink;
+        std::lock_guard<std::mutex> sinkLock(sink.mutex);
+        if (sink.closed) continue;
+        if (!sink.ring->TryPush(StatusRecord{sub.handle, status})) {
+            sink.ring->dropped.fetch_add(1, std::memory_order_relaxed);
+            g_statStatusDropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        const std::uint64_t one = 1;
+        (void)!write(sink.eventFd, &one, sizeof(one));
+        g_statStatusPublished.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// (Re-)install the DMEvent status notifier for an event with subscribers,
+// e.g. after its monitor was offered again.
+static void attach_status_notifier(const MonitorId &id) {
+    std::chrono::milliseconds interval;
+    {
+        std::lock_guard<std::mutex> lk(g_subsMutex);
+        auto it = g_subscriptions.find(id);
+        if (it == g_subscriptions.end()) return;
+        interval = it->second.interval;
+    }
+    DMEvent::SetEventStatusNotifier(id, publish_status, interval);
+}
+
+static void remove_subscription(ClientConnection *client, std::uint32_t handle) {
+    auto &subs = client->subscriptions;
+    auto found = std::find_if(subs.begin(), subs.end(), [handle](const auto &s) { return s.first == handle; });
+    if (found == subs.end()) return;
+
+    bool last = false;
+    bool intervalChanged = false;
+    {
+        std::lock_guard<std::mutex> lk(g_subsMutex);
+        auto it = g_subscriptions.find(found->second);
+        if (it != g_subscriptions.end()) {
+            auto &list = it->second.subs;
+            list.erase(std::remove_if(list.begin(), list.end(),
+                                      [&](const Subscription &s) {
+                                          return s.sink == client->statusSink && s.handle == handle;
+                                      }),
+                       list.end());
+            if (list.empty()) {
+                g_subscriptions.erase(it);
+                last = true;
+            } else {
+                // the fastest subscriber may have left: coalesce for the ones that remain
+                auto fastest = std::min_element(list.begin(), list.end(), [](const auto &a, const auto &b) {
+                    return a.interval < b.interval;
+                })->interval;
+                intervalChanged = fastest != it->second.interval;
+                it->second.interval = fastest;
+            }
+        }
+    }
+    if (last) DMEvent::SetEventStatusNotifier(found->second, nullptr);
+    else if (intervalChanged) attach_status_notifier(found->second);
+    subs.erase(found);
+}
+
+static std::uint32_t allocate_handle(const MonitorId &id) {
+    if (!g_freeHandles.empty()) {
+        std::uint32_t h = g_freeHandles.back();
+        g_freeHandles.pop_back();
+        g_handleNames[h] = id;
+        g_handleMonitors[h] = DMEvent::GetMonitorHandle(id).value_or(0);
+        return h;
+    }
+    g_handleNames.push_back(id);
+    g_handleMonitors.push_back(DMEvent::GetMonitorHandle(id).value_or(0));
+    return static_cast<std::uint32_t>(g_handleNames.size() - 1);
+}
+
+static void release_handle(std::uint32_t handle) {
+    if (handle == 0 || handle >= g_handleNames.size() || g_handleNames[handle].empty()) return;
+    if (g_offeredConfigured.erase(g_handleNames[handle]) == 0) DMEvent::UnregisterMonitor(g_handleNames[handle]);
+    g_handleNames[handle].clear();
+    g_handleMonitors[handle] = 0;
+    g_freeHandles.push_back(handle);
+}
+
+static bool send_with_fds(int sock, const HandshakeMessage &msg, const int *fds, int fdCount) {
+    iovec iov{const_cast<HandshakeMessage *>(&msg), sizeof(msg)};
+    alignas(cmsghdr) char control[CMSG_SPACE(3 * sizeof(int))]{};
+    msghdr mh{};
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+    if (fdCount > 0) {
+        mh.msg_control = control;
+        mh.msg_controllen = CMSG_SPACE(static_cast<std::size_t>(fdCount) * sizeof(int));
+        cmsghdr *c = CMSG_FIRSTHDR(&mh);
+        c->cmsg_level = SOL_SOCKET;
+        c->cmsg_type = SCM_RIGHTS;
+        c->cmsg_len = CMSG_LEN(static_cast<std::size_t>(fdCount) * sizeof(int));
+        std::memcpy(CMSG_DATA(c), fds, static_cast<std::size_t>(fdCount) * sizeof(int));
+    }
+    return sendmsg(sock, &mh, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(msg));
+}
+
+static void drain_client_fully(ClientConnection &client);
+
+static void close_client(ClientConnection *client) {
+    drain_client_fully(*client);
+    for (std::uint32_t h : client->handles) release_handle(h);
+    while (!client->subscriptions.empty()) remove_subscription(client, client->subscriptions.back().first);
+    if (client->statusSink) {
+        std::lock_guard<std::mutex> lk(client->statusSink->mutex);
+        client->statusSink->closed = true;
+        close(client->statusSink->eventFd);
+    }
+    if (client->segment != nullptr) {
+        for (std::uint32_t i = 0; i < kReportLanes; ++i) {
+            g_statDroppedClosed.fetch_add(client->lanes[i].dropped.load(std::memory_order_relaxed));
+        }
+        munmap(client->segment, sizeof(ClientSegment));
+    }
+    if (client->eventFd >= 0) {
+        epoll_ctl(g_epollFd, EPOLL_CTL_DEL, client->eventFd, nullptr);
+        close(client->eventFd);
+    }
+    epoll_ctl(g_epollFd, EPOLL_CTL_DEL, client->socketFd, nullptr);
+    close(client->socketFd);
+    g_clients.erase(client->socketFd);
+    g_statClients.fetch_sub(1);
+}
+
+// Create the shared segment and both wakeup eventfds and pass them to the client.
+static void handle_hello(ClientConnection *client, HandshakeMessage &msg) {
+    msg.type = MessageType::kHelloAck;
+    if (client->segment != nullptr || msg.version != ara::diag::ipc::kProtocolVersion) {
+        msg.status = client->segment != nullptr ? EALREADY : EPROTO;
+        send_with_fds(client->socketFd, msg, nullptr, 0);
+        return;
+    }
+
+    int memFd = memfd_create("dm-client-segment", MFD_CLOEXEC);
+    int evFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    int statusFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    void *mem = MAP_FAILED;
+    if (memFd >= 0 && evFd >= 0 && statusFd >= 0 && ftruncate(memFd, sizeof(ClientSegment)) == 0) {
+        mem = mmap(nullptr, sizeof(ClientSegment), PROT_READ | PROT_WRITE, MAP_SHARED, memFd, 0);
+    }
+    if (mem == MAP_FAILED) {
+        msg.status = errno != 0 ? errno : EIO;
+        if (memFd >= 0) close(memFd);
+        if (evFd >= 0) close(evFd);
+        if (statusFd >= 0) close(statusFd);
+        send_with_fds(client->socketFd, msg, nullptr, 0);
+        return;
+    }
+
+    client->segment = new (mem) ClientSegment();
+    client->lanes = client->segment->reports;
+    client->eventFd = evFd;
+    client->statusSink = std::make_shared<StatusSink>();
+    client->statusSink->ring = &client->segment->status;
+    client->statusSink->eventFd = statusFd;
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = &client->wakeTag;
+    epoll_ctl(g_epollFd, EPOLL_CTL_ADD, evFd, &ev);
+
+    msg.status = 0;
+    const int fds[3] = {memFd, evFd, statusFd};
+    send_with_fds(client->socketFd, msg, fds, 3);
+    close(memFd);   // the mapping keeps the memory alive
+}
+
+static void handle_offer(ClientConnection *client, HandshakeMessage &msg) {
+    msg.specifier[sizeof(msg.specifier) - 1] = '\0';
+    MonitorId id(msg.specifier);
+    msg.type = MessageType::kOfferAck;
+    msg.handle = 0;
+
+    // A monitor from the manifest is already registered with the configured
+    // debounce parameters; the offer only attaches to it, one client at a time.
+    ara::core::Result<void> res;
+    if (config::DMConfig::IsConfiguredMonitor(id)) {
+        if (!g_offeredConfigured.insert(id).second) res = ara::core::Result<void>{ std::make_error_code(std::errc::file_exists) };
+    } else {
+        res = DMEvent::RegisterMonitor(id, to_debounce_config(msg), nullptr);
+    }
+    if (res.HasError()) {
+        msg.status = res.Error().value();
+    } else {
+        msg.status = 0;
+        msg.handle = allocate_handle(id);
+        client->handles.push_back(msg.handle);
+        attach_status_notifier(id);
+    }
+    send_with_fds(client->socketFd, msg, nullptr, 0);
+}
+
+static void handle_stop_offer(ClientConnection *client, const HandshakeMessage &msg) {
+    drain_client_fully(*client);
+    auto &handles = client->handles;
+    for (auto it = handles.begin(); it != handles.end(); ++it) {
+        if (*it == msg.handle) {
+            release_handle(msg.handle);
+            handles.erase(it);
+            break;
+        }
+    }
+}
+
+// Subscribe to status changes of an event whose monitor is registered. The
+// ack carries the status read after the notifier was installed, so no change
+// can fall between the two.
+static void handle_subscribe(ClientConnection *client, HandshakeMessage &msg) {
+    msg.specifier[sizeof(msg.specifier) - 1] = '\0';
+    MonitorId id(msg.specifier);
+    msg.type = MessageType::kSubscribeAck;
+    const std::chrono::milliseconds interval(msg.intervalMs);
+    msg.handle = 0;
+
+    if (client->statusSink == nullptr || !DMEvent::GetEventStatus(id).has_value()) {
+        msg.status = client->statusSink == nullptr ? ENOTCONN : ENOENT;
+        send_with_fds(client->socketFd, msg, nullptr, 0);
+        return;
+    }
+
+    const std::uint32_t handle = client->nextSubscription++;
+    {
+        std::lock_guard<std::mutex> lk(g_subsMutex);
+        EventSubscribers &entry = g_subscriptions[id];
+        if (entry.subs.empty() || interval < entry.interval) entry.interval = interval;
+        entry.subs.push_back(Subscription{client->statusSink, handle, interval});
+    }
+    client->subscriptions.emplace_back(handle, id);
+    attach_status_notifier(id);
+
+    auto status = DMEvent::GetEventStatus(id);
+    if (!status.has_value()) {   // monitor went away meanwhile
+        remove_subscription(client, handle);
+        msg.status = ENOENT;
+    } else {
+        msg.status = 0;
+        msg.handle = handle;
+        msg.eventStatus = status.value();
+    }
+    send_with_fds(client->socketFd, msg, nullptr, 0);
+}
+
+static void handle_get_status(ClientConnection *client, HandshakeMessage &msg) {
+    msg.specifier[sizeof(msg.specifier) - 1] = '\0';
+    msg.type = MessageType::kGetStatusAck;
+    auto status = DMEvent::GetEventStatus(MonitorId(msg.specifier));
+    msg.status = status.has_value() ? 0 : ENOENT;
+    msg.eventStatus = status.value_or(0);
+    send_with_fds(client->socketFd, msg, nullptr, 0);
+}
+
+static void service_socket(ClientConnection *client) {
+    for (;;) {
+        HandshakeMessage msg;
+        ssize_t n = recv(client->socketFd, &msg, sizeof(msg), MSG_DONTWAIT);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        if (n < 0 && errno == EINTR) continue;
+        if (n != static_cast<ssize_t>(sizeof(msg))) {
+            client->closing = true;   // orderly shutdown, error or malformed message
+            return;
+        }
+        switch (msg.type) {
+        case MessageType::kHello: handle_hello(client, msg); break;
+        case MessageType::kOffer: handle_offer(client, msg); break;
+        case MessageType::kStopOffer: handle_stop_offer(client, msg); break;
+        case MessageType::kSubscribe: handle_subscribe(client, msg); break;
+        case MessageType::kUnsubscribe: remove_subscription(client, msg.handle); break;
+        case MessageType::kGetStatus: handle_get_status(client, msg); break;
+        default:
+            client->closing = true;
+            return;
+        }
+    }
+}
+
+static void accept_clients() {
+    for (;;) {
+        int fd = accept4(g_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        auto client = std::make_unique<ClientConnection>();
+        client->socketFd = fd;
+        client->socketTag.client = client.get();
+        client->wakeTag.client = client.get();
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.ptr = &client->socketTag;
+        epoll_ctl(g_epollFd, EPOLL_CTL_ADD, fd, &ev);
+        g_clients.emplace(fd, std::move(client));
+        g_statClients.fetch_add(1);
+    }
+}
+
+// Dispatch up to one batch from one lane of a client; returns records taken.
+static std::size_t drain_lane(ReportRing &ring) {
+    std::size_t n = ring.PopBatch(g_batch.data(), g_batch.size());
+    if (n == 0) return 0;
+
+    const std::uint64_t now = monotonic_ns();
+    std::uint64_t maxLatency = 0;
+    std::uint64_t sumLatency = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const ReportRecord &r = g_batch[i];
+        const std::uint64_t latency = now > r.timestampNs ? now - r.timestampNs : 0;
+        if (latency > maxLatency) maxLatency = latency;
+        sumLatency += latency;
+        if (r.handle == 0 || r.handle >= g_handleNames.size() || g_handleNames[r.handle].empty()) {
+            g_statUnknown.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        dispatch(r.handle, static_cast<MonitorAction>(r.action), r.timestampNs);
+    }
+    flush_batches();
+    g_statDrained.fetch_add(n, std::memory_order_relaxed);
+    g_statBatches.fetch_add(1, std::memory_order_relaxed);
+    g_statTotalLatency.fetch_add(sumLatency, std::memory_order_relaxed);
+    std::uint64_t prev = g_statMaxLatency.load(std::memory_order_relaxed);
+    while (maxLatency > prev && !g_statMaxLatency.compare_exchange_weak(prev, maxLatency)) {}
+    return n;
+}
+
+// Up to one batch from every lane of a client; returns records taken.
+static std::size_t drain_client(ClientConnection &client) {
+    if (client.lanes == nullptr) return 0;
+    std::size_t n = 0;
+    for (std::uint32_t i = 0; i < kReportLanes; ++i) n += drain_lane(client.lanes[i]);
+    return n;
+}
+
+// Reports already in the ring must be applied before their handle goes away.
+static void drain_client_fully(ClientConnection &client) {
+    while (drain_client(client) != 0) {}
+}
+
+// Drain every ring once; returns number of records dispatched.
+static std::size_t drain_rings() {
+    std::size_t total = 0;
+    std::uint64_t dropped = 0;
+    for (auto &p : g_clients) {
+        ClientConnection &client = *p.second;
+        if (client.lanes == nullptr) continue;
+        for (std::uint32_t i = 0; i < kReportLanes; ++i) dropped += client.lanes[i].dropped.load(std::memory_order_relaxed);
+        total += drain_client(client);
+    }
+    g_statDroppedLive.store(dropped, std::memory_order_relaxed);
+    return total;
+}
+
+static void set_consumer_waiting(std::uint32_t waiting) {
+    for (auto &p : g_clients) {
+        if (p.second->lanes == nullptr) continue;
+        for (std::uint32_t i = 0; i < kReportLanes; ++i) {
+            p.second->lanes[i].consumerWaiting.store(waiting, std::memory_order_relaxed);
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+static bool all_rings_empty() {
+    for (auto &p : g_clients) {
+        if (p.second->lanes == nullptr) continue;
+        for (std::uint32_t i = 0; i < kReportLanes; ++i) {
+            if (!p.second->lanes[i].Empty()) return false;
+        }
+    }
+    return true;
+}
+
+static void server_loop() {
+    constexpr int kMaxEvents = 32;
+    epoll_event events[kMaxEvents];
+    std::uint32_t idlePasses = 0;
+
+    while (!g_ipcStop.load(std::memory_order_relaxed)) {
+        // Busy: poll descriptors without blocking. Idle: ask producers to
+        // signal the eventfd, re-check to close the race, then block.
+        int timeout = 0;
+        if (idlePasses >= g_cfg.spinBeforeSleep) {
+            set_consumer_waiting(1);
+            timeout = all_rings_empty() ? -1 : 0;
+        }
+        int n = epoll_wait(g_epollFd, events, kMaxEvents, timeout);
+        if (timeout != 0) set_consumer_waiting(0);
+
+        for (int i = 0; i < n; ++i) {
+            auto *tag = static_cast<PollTag *>(events[i].data.ptr);
+            switch (tag->kind) {
+            case PollTag::Kind::Listen:
+                accept_clients();
+                break;
+            case PollTag::Kind::Stop:
+                break;
+            case PollTag::Kind::Wakeup: {
+                std::uint64_t value;
+                (void)!read(tag->client->eventFd, &value, sizeof(value));
+                break;
+            }
+            case PollTag::Kind::Socket:
+                if (!tag->client->closing) service_socket(tag->client);
+                break;
+            }
+        }
+
+        idlePasses = drain_rings() != 0 ? 0 : idlePasses + 1;
+
+        // Reap closed clients only after their last records were drained.
+        for (auto it = g_clients.begin(); it != g_clients.end();) {
+            ClientConnection *client = (it++)->second.get();
+            if (client->closing) close_client(client);
+        }
+    }
+}
+
+ara::core::Result<void> DMIpcServer::Start(const IpcServerConfig &cfg) {
+    std::lock_guard<std::mutex> lk(g_ipcMutex);
+    if (g_ipcThread.joinable()) {
+        return ara::core::Result<void>{ std::make_error_code(std::errc::already_connected) };
+    }
+
+    g_cfg = cfg;
+    if (g_cfg.drainBatch == 0) g_cfg.drainBatch = 1;
+    g_batch.assign(g_cfg.drainBatch, ReportRecord{});
+    g_qualifiedBatch.reserve(g_cfg.drainBatch);
+    g_preBatch.reserve(g_cfg.drainBatch);
+
+    const std::string path = socket_path();
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return ara::core::Result<void>{ std::make_error_code(std::errc::filename_too_long) };
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    unlink(path.c_str());   // stale socket from a previous run
+    g_listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    g_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    g_stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (g_listenFd < 0 || g_epollFd < 0 || g_stopFd < 0 ||
+        bind(g_listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        listen(g_listenFd, SOMAXCONN) != 0) {
+        std::error_code ec(errno, std::generic_category());
+        if (g_listenFd >= 0) close(g_listenFd);
+        if (g_epollFd >= 0) close(g_epollFd);
+        if (g_stopFd >= 0) close(g_stopFd);
+        g_listenFd = g_epollFd = g_stopFd = -1;
+        return ara::core::Result<void>{ ec };
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = &g_listenTag;
+    epoll_ctl(g_epollFd, EPOLL_CTL_ADD, g_listenFd, &ev);
+    ev.data.ptr = &g_stopTag;
+    epoll_ctl(g_epollFd, EPOLL_CTL_ADD, g_stopFd, &ev);
+
+    g_ipcStop = false;
+    g_ipcThread = std::thread(server_loop);
+    return ara::core::Result<void>{};
+}
+
+void DMIpcServer::Stop() {
+    std::lock_guard<std::mutex> lk(g_ipcMutex);
+    if (!g_ipcThread.joinable()) return;
+
+    g_ipcStop = true;
+    const std::uint64_t one = 1;
+    (void)!write(g_stopFd, &one, sizeof(one));
+    g_ipcThread.join();
+
+    drain_rings();
+    while (!g_clients.empty()) close_client(g_clients.begin()->second.get());
+    close(g_listenFd);
+    close(g_epollFd);
+    close(g_stopFd);
+    g_listenFd = g_epollFd = g_stopFd = -1;
+    unlink(socket_path().c_str());
+}
+
+IpcStatistics DMIpcServer::GetStatistics() {
+    IpcStatistics s;
+    s.clients = g_statClients.load();
+    s.reportsDrained = g_statDrained.load();
+    s.batches = g_statBatches.load();
+    s.unknownHandles = g_statUnknown.load();
+    s.maxLatencyNs = g_statMaxLatency.load();
+    s.totalLatencyNs = g_statTotalLatency.load();
+    s.reportsDropped = g_statDroppedClosed.load() + g_statDroppedLive.load();
+    s.statusPublished = g_statStatusPublished.load();
+    s.statusDropped = g_statStatusDropped.load();
+    return s;
+}
+
+} // namespace ipc
+} // namespace diagnostic_manager
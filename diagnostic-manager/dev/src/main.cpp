@@ -1,14 +1,59 @@
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
 #include "ara-diag/dev/inc/public/ara/diag/event_types.h"
+#include "common/dm_lock_profile.h"
+#include "common/dm_memory.h"
+#include "common/dm_startup_profile.h"
 
 // include a DM header to ensure compilation of project sources
+#include "config/dm_config.h"
 #include "event/dm_event.h"
 #include "dtc/dm_dtc.h"
+#include "ipc/dm_ipc_server.h"
 
 int main(int argc, char **argv) {
     (void)argc; (void)argv;
+    diagnostic_manager::common::StartupProfile::Begin();
     std::cout << "diagnostic-manager binary started\n";
 
+    // Strict mode: once ready, any heap use of the DM's containers aborts.
+    if (std::getenv(diagnostic_manager::common::kNoHeapAfterInitEnv) != nullptr) {
+        diagnostic_manager::common::MemoryConfig memory;
+        memory.abortOnHeapAfterInit = true;
+        auto configured = diagnostic_manager::common::DmMemory::Configure(memory);
+        if (configured.HasError()) {
+            std::cerr << "memory configuration failed: " << configured.Error().message() << "\n";
+            return 1;
+        }
+    }
+
+    // Block termination signals before any thread is spawned so only
+    // sigwait() below receives them; SIGUSR1 dumps the lock profile.
+    sigset_t stopSignals;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    sigaddset(&stopSignals, SIGUSR1);
+    const char *lockProfileOut = std::getenv(diagnostic_manager::common::kLockProfileOutEnv);
+    const auto dumpLockProfile = [lockProfileOut] {
+        if (lockProfileOut == nullptr) return;
+        auto dumped = diagnostic_manager::common::LockProfile::DumpToFile(lockProfileOut);
+        if (dumped.HasError()) std::cerr << "lock profile: " << dumped.Error().message() << "\n";
+    };
+    pthread_sigmask(SIG_BLOCK, &stopSignals, nullptr);
+
+    // Static configuration compiled by dm_manifest_gen, if one is given.
+    if (const char *manifest = std::getenv(diagnostic_manager::config::kManifestPathEnv)) {
+        auto loaded = diagnostic_manager::config::DMConfig::LoadManifest(manifest);
+        if (loaded.HasError()) {
+            std::cerr << "manifest " << manifest << " failed to load: " << loaded.Error().message() << "\n";
+            return 1;
+        }
+        std::cout << "manifest loaded: " << loaded.Value().monitors << " monitors, " << loaded.Value().dtcs
+                  << " DTCs, " << loaded.Value().cycles << " operation cycles\n";
+    }
+
     diagnostic_manager::event::DebounceConfig cfg;
     diagnostic_manager::event::MonitorId mid = "dummy_monitor";
     diagnostic_manager::event::QualifiedNotifier qn = [](const diagnostic_manager::event::MonitorId &id,
@@ -16,13 +61,16 @@ int main(int argc, char **argv) {
         (void)id; (void)s;
         std::cout << "Qualified notifier fired for " << id << "\n";
     };
-    diagnostic_manager::event::DMEvent::RegisterMonitor(mid, cfg, qn);
+    {
+        diagnostic_manager::common::StartupPhaseScope phase("register.builtin");
+        diagnostic_manager::event::DMEvent::RegisterMonitor(mid, cfg, qn);
 
-    diagnostic_manager::dtc::DMDtc::RegisterDtc(0x1234, [](diagnostic_manager::dtc::DtcId id,
-                                                          diagnostic_manager::dtc::UdsStatusByte /*oldS*/,
-                                                          diagnostic_manager::dtc::UdsStatusByte newS) {
-        std::cout << "DTC " << id << " status changed to " << int(newS) << "\n";
-    });
+        diagnostic_manager::dtc::DMDtc::RegisterDtc(0x1234, [](diagnostic_manager::dtc::DtcId id,
+                                                              diagnostic_manager::dtc::UdsStatusByte /*oldS*/,
+                                                              diagnostic_manager::dtc::UdsStatusByte newS) {
+            std::cout << "DTC " << id << " status changed to " << int(newS) << "\n";
+        });
+    }
 
     std::cout << __func__ << ":" << __LINE__ << std::endl;
     ara::diag::EventStatusByte status(ara::diag::EventStatusBit::FailedAndTested,
@@ -33,6 +81,22 @@ int main(int argc, char **argv) {
     status.IsSet(ara::diag::EventStatusBit::FailedAndTested);
     status.IsNotSet(ara::diag::EventStatusBit::PassedAndTested);
 
-    std::cout << "diagnostic-manager binary ready\n";
+    auto ipc = [] {
+        diagnostic_manager::common::StartupPhaseScope phase("ipc.offer");
+        return diagnostic_manager::ipc::DMIpcServer::Start();
+    }();
+    if (ipc.HasError()) {
+        std::cerr << "IPC server failed to start: " << ipc.Error().message() << "\n";
+        return 1;
+    }
+
+    std::cout << "diagnostic-manager binary ready" << std::endl;
+    diagnostic_manager::common::DmMemory::Initialize();
+    diagnostic_manager::common::StartupProfile::Ready();
+
+    int sig = 0;
+    while (sigwait(&stopSignals, &sig) == 0 && sig == SIGUSR1) dumpLockProfile();
+    diagnostic_manager::ipc::DMIpcServer::Stop();
+    dumpLockProfile();
     return 0;
 }
\ No newline at end of file
@@ -1,74 +1,205 @@
 #include "operationcycle/dm_operation_cycle.h"
+#include "common/dm_epoch.h"
+#include "common/dm_lock_profile.h"
+#include "common/dm_memory.h"
+#include "common/dm_perfect_hash.h"
+#include <memory>
+#include <memory_resource>
 #include <unordered_map>
 #include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace diagnostic_manager {
 namespace operation_cycle {
 
+constexpr std::uint32_t kNotIndexed = UINT32_MAX;
+
+static std::pmr::memory_resource *cycle_memory() noexcept {
+    return common::DmMemory::Resource(common::MemorySubsystem::OperationCycles);
+}
+
 struct OpCycleInstance {
+    std::pmr::string name{cycle_memory()};   // viewed by the key in g_opCycles
     bool active{false};
     bool initialized{false};
-    OpCycleNotifier notifier;
+    common::EpochSlot<OpCycleNotifier> notifier;   // called after unlocking, under an epoch pin
+    std::uint32_t nameIndex{kNotIndexed};   // slot of the name in g_indexed, if indexed
+    OpCycleStateWaiter *waiters{nullptr};   // fired on the next state change
 };
 
-static std::unordered_map<OpCycleId, OpCycleInstance> g_opCycles;
-static std::mutex g_opCyclesMutex;
+static std::pmr::unordered_map<std::string_view, OpCycleInstance> g_opCycles{cycle_memory()};
+// Perfect hash over the names known after the last bulk registration, with
+// the instance of each by slot (nullptr once unregistered); see DMEvent.
+static common::PerfectHash g_nameIndex{cycle_memory()};
+static std::pmr::vector<OpCycleInstance *> g_indexed{cycle_memory()};
+static common::ProfiledMutex g_opCyclesMutex{"operation_cycle.registry"};
+
+static OpCycleInstance *find_cycle(const OpCycleId &id) {
+    if (!g_indexed.empty()) {
+        OpCycleInstance *inst = g_indexed[g_nameIndex.Slot(id)];
+        if (inst != nullptr && std::string_view(inst->name) == id) return inst;
+    }
+    auto it = g_opCycles.find(id);
+    return it == g_opCycles.end() ? nullptr : &it->second;
+}
+
+// Replace the notifier of `inst`; the old one is retired. g_opCyclesMutex held.
+static void set_notifier(OpCycleInstance &inst, OpCycleNotifier notifier) {
+    const std::ptrdiff_t delta = (notifier ? 1 : 0) - (inst.notifier.Get() != nullptr ? 1 : 0);
+    common::DmMemory::Track(common::MemorySubsystem::Notifiers, delta, delta * static_cast<std::ptrdiff_t>(sizeof(OpCycleNotifier)));
+    if (!notifier) {
+        inst.notifier.Reset();
+        return;
+    }
+    inst.notifier.Reset(std::make_unique<OpCycleNotifier>(std::move(notifier)));
+}
+
+// Fire a detached waiter list; a waiter may be gone once fired.
+static void fire_waiters(OpCycleStateWaiter *w, bool active, bool unregistered) {
+    while (w != nullptr) {
+        OpCycleStateWaiter *next = w->next;
+        w->next = nullptr;
+        w->active = active;
+        w->unregistered = unregistered;
+        w->fire(*w);
+        w = next;
+    }
+}
+
+static void rebuild_name_index() {
+    std::pmr::vector<std::string_view> names{cycle_memory()};
+    names.reserve(g_opCycles.size());
+    for (auto &p : g_opCycles) {
+        p.second.nameIndex = kNotIndexed;
+        names.push_back(p.first);
+    }
+    g_indexed.clear();
+    auto built = common::PerfectHash::Build(names.data(), names.size(), cycle_memory());
+    if (built.HasError()) {
+        g_nameIndex = common::PerfectHash{cycle_memory()};
+        return;
+    }
+    g_nameIndex = std::move(built).Value();
+    g_indexed.assign(g_opCycles.size(), nullptr);
+    for (auto &p : g_opCycles) {
+        p.second.nameIndex = g_nameIndex.Slot(p.first);
+        g_indexed[p.second.nameIndex] = &p.second;
+    }
+}
 
 ara::core::Result<void> DMOperationCycle::RegisterOperationCycle(const OpCycleId &id, OpCycleNotifier notifier) {
-    std::lock_guard<std::mutex> lk(g_opCyclesMutex);
+    const common::ApiCallScope scope("DMOperationCycle::RegisterOperationCycle");
+    common::ProfiledLockGuard lk(g_opCyclesMutex);
     if (g_opCycles.find(id) != g_opCycles.end()) {
         return ara::core::Result<void>{ std::make_error_code(std::errc::file_exists) };
     }
-    OpCycleInstance inst;
-    inst.notifier = std::move(notifier);
-    inst.active = false;
-    inst.initialized = true;
-    g_opCycles.emplace(id, std::move(inst));
+    OpCycleInstance &added = common::EmplaceNamed(g_opCycles, id).first->second;
+    set_notifier(added, std::move(notifier));
+    added.initialized = true;
+    common::DmMemory::Track(common::MemorySubsystem::OperationCycles, 1);
+    return ara::core::Result<void>{};
+}
+
+ara::core::Result<void> DMOperationCycle::RegisterOperationCycles(const OperationCycleRegistration *cycles, std::size_t count) {
+    const common::ApiCallScope scope("DMOperationCycle::RegisterOperationCycles");
+    for (std::size_t i = 0; i < count; ++i) {
+        if (cycles[i].id.empty()) return ara::core::Result<void>{ std::make_error_code(std::errc::invalid_argument) };
+    }
+
+    common::ProfiledLockGuard lk(g_opCyclesMutex);
+    g_opCycles.reserve(g_opCycles.size() + count);   // no rehash below, `entries` stay valid
+    std::pmr::vector<decltype(g_opCycles)::iterator> entries{cycle_memory()};
+    entries.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto res = common::EmplaceNamed(g_opCycles, cycles[i].id);
+        if (!res.second) {
+            // registered before or earlier in this batch
+            for (auto it : entries) g_opCycles.erase(it);
+            return ara::core::Result<void>{ std::make_error_code(std::errc::file_exists) };
+        }
+        entries.push_back(res.first);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        OpCycleInstance &inst = entries[i]->second;
+        set_notifier(inst, cycles[i].notifier);
+        inst.initialized = true;
+        common::DmMemory::Track(common::MemorySubsystem::OperationCycles, 1);
+    }
+    rebuild_name_index();
     return ara::core::Result<void>{};
 }
 
 ara::core::Result<void> DMOperationCycle::UnregisterOperationCycle(const OpCycleId &id) {
-    std::lock_guard<std::mutex> lk(g_opCyclesMutex);
-    auto it = g_opCycles.find(id);
-    if (it == g_opCycles.end()) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
-    g_opCycles.erase(it);
+    const common::ApiCallScope scope("DMOperationCycle::UnregisterOperationCycle");
+    OpCycleStateWaiter *waiters = nullptr;
+    bool active = false;
+    {
+        common::ProfiledLockGuard lk(g_opCyclesMutex);
+        auto it = g_opCycles.find(id);
+        if (it == g_opCycles.end()) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        if (it->second.nameIndex != kNotIndexed) g_indexed[it->second.nameIndex] = nullptr;
+        waiters = it->second.waiters;
+        active = it->second.active;
+        set_notifier(it->second, nullptr);
+        g_opCycles.erase(it);
+        common::DmMemory::Track(common::MemorySubsystem::OperationCycles, -1);
+    }
+    fire_waiters(waiters, active, true);
     return ara::core::Result<void>{};
 }
 
 ara::core::Result<void> DMOperationCycle::SetOperationCycleState(const OpCycleId &id, bool active) {
-    OpCycleNotifier notifierCopy;
+    const common::ApiCallScope scope("DMOperationCycle::SetOperationCycleState");
+    const common::EpochGuard pin;   // keeps `notifier` alive if it is replaced meanwhile
+    const OpCycleNotifier *notifier = nullptr;
+    OpCycleStateWaiter *waiters = nullptr;
     bool changed = false;
     {
-        std::lock_guard<std::mutex> lk(g_opCyclesMutex);
-        auto it = g_opCycles.find(id);
-        if (it == g_opCycles.end()) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
-        OpCycleInstance &inst = it->second;
+        common::ProfiledLockGuard lk(g_opCyclesMutex);
+        OpCycleInstance *entry = find_cycle(id);
+        if (entry == nullptr) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+        OpCycleInstance &inst = *entry;
         if (!inst.initialized) inst.initialized = true;
         if (inst.active != active) {
             inst.active = active;
-            notifierCopy = inst.notifier;
+            notifier = inst.notifier.Get();
+            waiters = std::exchange(inst.waiters, nullptr);
             changed = true;
         }
     }
 
-    if (changed && notifierCopy) {
-        notifierCopy(id, active);
+    if (changed && notifier != nullptr) {
+        (*notifier)(id, active);
     }
+    fire_waiters(waiters, active, false);
     return ara::core::Result<void>{};
 }
 
 ara::core::Result<bool> DMOperationCycle::GetOperationCycleState(const OpCycleId &id) {
-    std::lock_guard<std::mutex> lk(g_opCyclesMutex);
-    auto it = g_opCycles.find(id);
-    if (it == g_opCycles.end()) return ara::core::Result<bool>{ std::make_error_code(std::errc::no_such_file_or_directory) };
-    return ara::core::Result<bool>{ it->second.active };
+    common::ProfiledLockGuard lk(g_opCyclesMutex);
+    OpCycleInstance *entry = find_cycle(id);
+    if (entry == nullptr) return ara::core::Result<bool>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    return ara::core::Result<bool>{ entry->active };
 }
 
 ara::core::Result<void> DMOperationCycle::SetOpCycleNotifier(const OpCycleId &id, OpCycleNotifier notifier) {
-    std::lock_guard<std::mutex> lk(g_opCyclesMutex);
-    auto it = g_opCycles.find(id);
-    if (it == g_opCycles.end()) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
-    it->second.notifier = std::move(notifier);
+    const common::ApiCallScope scope("DMOperationCycle::SetOpCycleNotifier");
+    common::ProfiledLockGuard lk(g_opCyclesMutex);
+    OpCycleInstance *entry = find_cycle(id);
+    if (entry == nullptr) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    set_notifier(*entry, std::move(notifier));
+    return ara::core::Result<void>{};
+}
+
+ara::core::Result<void> DMOperationCycle::AddStateWaiter(const OpCycleId &id, OpCycleStateWaiter &waiter) {
+    const common::ApiCallScope scope("DMOperationCycle::AddStateWaiter");
+    common::ProfiledLockGuard lk(g_opCyclesMutex);
+    OpCycleInstance *entry = find_cycle(id);
+    if (entry == nullptr) return ara::core::Result<void>{ std::make_error_code(std::errc::no_such_file_or_directory) };
+    waiter.next = entry->waiters;
+    entry->waiters = &waiter;
     return ara::core::Result<void>{};
 }
 
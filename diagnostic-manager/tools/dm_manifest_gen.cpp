@@ -0,0 +1,163 @@
+/*
+ * dm_manifest_gen - compile a text configuration into a binary manifest.
+ *
+ * Usage: dm_manifest_gen <input.txt> <output.dmm>
+ *
+ * One entity per line, '#' starts a comment, fields are separated by blanks:
+ *
+ *   cycle   <name>
+ *   dtc     <id> [suppressed]                      id in decimal or 0x hex
+ *   monitor <name> counter  [failed=N] [passed=N] [failed-step=N] [passed-step=N]
+ *                           [jump-up=N] [jump-down=N] [fdc=N] [dtc=ID]... [cycle=NAME]...
+ *   monitor <name> time     [failed-ms=N] [passed-ms=N] [fdc-ms=N] [dtc=ID]... [cycle=NAME]...
+ *   monitor <name> internal [dtc=ID]... [cycle=NAME]...
+ *
+ * jump-up/jump-down enable the jump and give the counter value to jump to.
+ * Omitted values keep the DebounceConfig defaults.
+ */
+#include "config/dm_manifest.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using diagnostic_manager::config::Manifest;
+using diagnostic_manager::config::ManifestBuilder;
+using diagnostic_manager::event::DebounceConfig;
+using diagnostic_manager::event::DebounceMode;
+
+namespace {
+
+struct ParseError {
+    std::string message;
+};
+
+std::int64_t parse_number(const std::string &text, std::int64_t min, std::int64_t max) {
+    errno = 0;
+    char *end = nullptr;
+    const long long v = std::strtoll(text.c_str(), &end, 0);
+    if (text.empty() || *end != '\0' || errno != 0 || v < min || v > max) throw ParseError{"bad number '" + text + "'"};
+    return v;
+}
+
+std::int32_t parse_i32(const std::string &text) { return static_cast<std::int32_t>(parse_number(text, INT32_MIN, INT32_MAX)); }
+std::uint32_t parse_u32(const std::string &text) { return static_cast<std::uint32_t>(parse_number(text, 0, UINT32_MAX)); }
+
+void parse_monitor(std::istringstream &in, ManifestBuilder &builder) {
+    std::string name, mode;
+    if (!(in >> name >> mode)) throw ParseError{"expected: monitor <name> <counter|time|internal> ..."};
+
+    DebounceConfig cfg;
+    if (mode == "counter") cfg.mode = DebounceMode::CounterBased;
+    else if (mode == "time") cfg.mode = DebounceMode::TimeBased;
+    else if (mode == "internal") cfg.mode = DebounceMode::MonitorInternal;
+    else throw ParseError{"unknown debounce mode '" + mode + "'"};
+
+    std::string field;
+    while (in >> field) {
+        const auto eq = field.find('=');
+        if (eq == std::string::npos) throw ParseError{"expected key=value, got '" + field + "'"};
+        const std::string key = field.substr(0, eq);
+        const std::string value = field.substr(eq + 1);
+        const bool counter = cfg.mode == DebounceMode::CounterBased;
+        const bool time = cfg.mode == DebounceMode::TimeBased;
+
+        if (key == "dtc") builder.LinkDtc(name, parse_u32(value));
+        else if (key == "cycle") builder.LinkCycle(name, value);
+        else if (counter && key == "failed") cfg.failedThreshold = parse_i32(value);
+        else if (counter && key == "passed") cfg.passedThreshold = parse_i32(value);
+        else if (counter && key == "failed-step") cfg.failedStep = parse_i32(value);
+        else if (counter && key == "passed-step") cfg.passedStep = parse_i32(value);
+        else if (counter && key == "jump-up") { cfg.jumpUp = true; cfg.failedJumpValue = parse_i32(value); }
+        else if (counter && key == "jump-down") { cfg.jumpDown = true; cfg.passedJumpValue = parse_i32(value); }
+        else if (counter && key == "fdc") cfg.fdcThreshold = parse_i32(value);
+        else if (time && key == "failed-ms") cfg.timeFailedThresholdMs = parse_u32(value);
+        else if (time && key == "passed-ms") cfg.timePassedThresholdMs = parse_u32(value);
+        else if (time && key == "fdc-ms") cfg.timeFdcThresholdMs = parse_u32(value);
+        else throw ParseError{"unknown key '" + key + "' for " + mode + " monitor"};
+    }
+    builder.AddMonitor(name, cfg);
+}
+
+void parse_line(const std::string &line, ManifestBuilder &builder) {
+    std::istringstream in(line.substr(0, line.find('#')));
+    std::string kind;
+    if (!(in >> kind)) return;
+
+    if (kind == "monitor") {
+        parse_monitor(in, builder);
+        return;
+    }
+    std::string name, extra;
+    if (kind == "cycle") {
+        if (!(in >> name) || in >> extra) throw ParseError{"expected: cycle <name>"};
+        builder.AddCycle(name);
+    } else if (kind == "dtc") {
+        if (!(in >> name)) throw ParseError{"expected: dtc <id> [suppressed]"};
+        bool suppressed = false;
+        if (in >> extra) {
+            if (extra != "suppressed") throw ParseError{"unexpected '" + extra + "'"};
+            suppressed = true;
+        }
+        builder.AddDtc(parse_u32(name), suppressed);
+    } else {
+        throw ParseError{"unknown entry '" + kind + "'"};
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <input.txt> <output.dmm>\n";
+        return 2;
+    }
+
+    std::ifstream input(argv[1]);
+    if (!input) {
+        std::cerr << argv[1] << ": cannot open\n";
+        return 1;
+    }
+    ManifestBuilder builder;
+    std::string line;
+    for (unsigned lineNo = 1; std::getline(input, line); ++lineNo) {
+        try {
+            parse_line(line, builder);
+        } catch (const ParseError &e) {
+            std::cerr << argv[1] << ":" << lineNo << ": " << e.message << "\n";
+            return 1;
+        }
+    }
+
+    auto image = builder.Build();
+    if (image.HasError()) {
+        const std::error_code &e = image.Error();
+        const std::string what = e == std::errc::file_exists ? "duplicate monitor, DTC or cycle"
+                               : e == std::errc::no_such_file_or_directory ? "dtc= or cycle= refers to an undefined entry"
+                                                                           : e.message();
+        std::cerr << argv[1] << ": " << what << "\n";
+        return 1;
+    }
+    // Round-trip through the loader's validation before writing.
+    auto manifest = Manifest::FromBuffer(image.Value());
+    if (manifest.HasError()) {
+        std::cerr << "internal error: generated manifest does not validate: " << manifest.Error().message() << "\n";
+        return 1;
+    }
+
+    std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char *>(image.Value().data()), static_cast<std::streamsize>(image.Value().size()));
+    if (!output) {
+        std::cerr << argv[2] << ": write failed\n";
+        return 1;
+    }
+    std::cout << argv[2] << ": " << manifest.Value().MonitorCount() << " monitors, " << manifest.Value().DtcCount()
+              << " DTCs, " << manifest.Value().CycleCount() << " operation cycles, " << image.Value().size() << " bytes\n";
+    return 0;
+}
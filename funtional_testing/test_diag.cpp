@@ -1,8 +1,46 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "common/dm_clock.h"
+#include "common/dm_coro.h"
+#include "common/dm_epoch.h"
+#include "common/dm_executor.h"
+#include "common/dm_latency_trace.h"
+#include "common/dm_lock_profile.h"
+#include "common/dm_memory.h"
+#include "common/dm_perfect_hash.h"
+#include "common/dm_startup_profile.h"
+#include "ara/core/instance_specifier.h"
+#include "ara/core/result_future.h"
+#include "ara/diag/event.h"
 #include "ara/diag/event_types.h"
+#include "ara/diag/fdc_polling.h"
+#include "ara/diag/ipc/report_ring.h"
+#include "ara/diag/monitor.h"
+#include "config/dm_config.h"
+#include "config/dm_manifest.h"
 #include "event/dm_event.h"
+#include "event/dm_ingestion.h"
 #include "dtc/dm_dtc.h"
+#include "ipc/dm_ipc_server.h"
+#include "operationcycle/dm_operation_cycle.h"
 
 // Dummy callback for monitor
 void TestMonitorCallback(const diagnostic_manager::event::MonitorId& id,
@@ -23,7 +61,7 @@ TEST(AraDiagTest, MonitorRegistrationAndCallback) {
     diagnostic_manager::event::QualifiedNotifier notifier = TestMonitorCallback;
 
     auto result = diagnostic_manager::event::DMEvent::RegisterMonitor(mid, cfg, notifier);
-    EXPECT_EQ(1, 1);
+    EXPECT_TRUE(result.HasValue());
 
     diagnostic_manager::event::DMEvent::ReportPreEvent(mid, true);
     diagnostic_manager::event::DMEvent::ReportPreEvent(mid, false);
@@ -31,7 +69,7 @@ TEST(AraDiagTest, MonitorRegistrationAndCallback) {
 
 TEST(AraDiagTest, DtcRegistrationAndCallback) {
     auto result = diagnostic_manager::dtc::DMDtc::RegisterDtc(0x42, TestDtcCallback);
-    EXPECT_EQ(1, 1);
+    EXPECT_TRUE(result.HasValue());
 
     diagnostic_manager::dtc::DMDtc::ReportDtcStatus(0x42, 0x01);
     diagnostic_manager::dtc::DMDtc::ReportDtcStatus(0x42, 0x02);
@@ -40,3 +78,1342 @@ TEST(AraDiagTest, DtcRegistrationAndCallback) {
 TEST(DummyTest, AlwaysPasses) {
     EXPECT_EQ(1, 1);
 }
+
+TEST(AraDiagTest, ResultCombinatorsPassErrorsAndValuesThrough) {
+    using ara::core::Result;
+    const std::error_code invalid = std::make_error_code(std::errc::invalid_argument);
+    const std::error_code missing = std::make_error_code(std::errc::no_such_file_or_directory);
+
+    const Result<int> value{ 20 };
+    const Result<int> error{ invalid };
+    EXPECT_EQ(value.Map([](int v) { return std::to_string(v + 1); }).Value(), "21");
+    EXPECT_EQ(error.Map([](int v) { return std::to_string(v + 1); }).Error(), invalid);
+
+    const auto half = [&invalid](int v) {
+        return v % 2 == 0 ? Result<int>{ v / 2 } : Result<int>{ invalid };
+    };
+    EXPECT_EQ(value.AndThen(half).AndThen(half).Value(), 5);
+    EXPECT_EQ(value.AndThen(half).AndThen(half).AndThen(half).Error(), invalid);
+    int calls = 0;
+    EXPECT_EQ(error.AndThen([&calls](int v) { ++calls; return Result<int>{ v }; }).Error(), invalid);
+    EXPECT_EQ(calls, 0);
+
+    EXPECT_EQ(value.OrElse([&calls](const std::error_code &) { ++calls; return Result<int>{ 0 }; }).Value(), 20);
+    EXPECT_EQ(calls, 0);
+    EXPECT_EQ(error.OrElse([](const std::error_code &) { return Result<int>{ 0 }; }).Value(), 0);
+    EXPECT_EQ(error.OrElse([&](const std::error_code &) { return Result<int>{ missing }; }).Error(), missing);
+
+    // move-only values go through the rvalue overloads
+    auto owned = Result<std::unique_ptr<int>>{ std::make_unique<int>(3) }.Map([](std::unique_ptr<int> p) { return *p; });
+    EXPECT_EQ(owned.Value(), 3);
+
+    const Result<void> ok;
+    const Result<void> failed{ invalid };
+    EXPECT_EQ(ok.Map([] { return 1; }).Value(), 1);
+    EXPECT_EQ(failed.Map([] { return 1; }).Error(), invalid);
+    EXPECT_EQ(ok.AndThen([&missing] { return Result<void>{ missing }; }).Error(), missing);
+    EXPECT_EQ(failed.AndThen([&calls] { ++calls; return Result<void>{}; }).Error(), invalid);
+    EXPECT_EQ(calls, 0);
+    EXPECT_TRUE(failed.OrElse([](const std::error_code &) { return Result<void>{}; }).HasValue());
+    EXPECT_TRUE(ok.OrElse([&calls](const std::error_code &e) { ++calls; return Result<void>{ e }; }).HasValue());
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(AraDiagTest, FutureCarriesValuesErrorsAndBrokenPromises) {
+    using ara::core::Future;
+    using ara::core::Promise;
+    using ara::core::Result;
+
+    // set before get_future: handed out ready, without shared state
+    Promise<int> early;
+    early.set_value(7);
+    Future<int> ready = early.get_future();
+    EXPECT_TRUE(ready.is_ready());
+    EXPECT_EQ(ready.GetResult().Value(), 7);
+    EXPECT_FALSE(ready.valid());
+
+    // set from another thread while the consumer waits
+    Promise<int> late;
+    Future<int> pending = late.get_future();
+    EXPECT_FALSE(pending.is_ready());
+    std::thread producer([&late] { late.set_value(42); });
+    EXPECT_EQ(pending.GetResult().Value(), 42);
+    producer.join();
+
+    Promise<int> failing;
+    Future<int> failed = failing.get_future();
+    failing.SetError(std::make_error_code(std::errc::timed_out));
+    EXPECT_EQ(failed.GetResult().Error(), std::make_error_code(std::errc::timed_out));
+
+    // a second get_future gets an error instead of a future that never completes
+    Promise<int> once;
+    Future<int> first = once.get_future();
+    Future<int> second = once.get_future();
+    ASSERT_TRUE(second.is_ready());
+    EXPECT_EQ(second.GetResult().Error(), std::make_error_code(std::future_errc::future_already_retrieved));
+    once.set_value(1);
+    EXPECT_EQ(first.GetResult().Value(), 1);
+
+    Future<void> broken;
+    {
+        Promise<void> dropped;
+        broken = dropped.get_future();
+    }
+    ASSERT_TRUE(broken.is_ready());
+    EXPECT_EQ(broken.GetResult().Error(), std::make_error_code(std::future_errc::broken_promise));
+    EXPECT_EQ(Future<int>{}.GetResult().Error(), std::make_error_code(std::future_errc::no_state));
+}
+
+TEST(AraDiagTest, FutureThenChainsOnReadyAndPendingFutures) {
+    using ara::core::Future;
+    using ara::core::Promise;
+    using ara::core::Result;
+
+    // ready: the continuation runs on the calling thread before then() returns
+    bool ran = false;
+    Future<int> doubled = Future<int>(Result<int>{ 21 }).then([&ran](Future<int> f) {
+        ran = true;
+        return f.GetResult().Value() * 2;
+    });
+    EXPECT_TRUE(ran);
+    ASSERT_TRUE(doubled.is_ready());
+    EXPECT_EQ(doubled.GetResult().Value(), 42);
+
+    // pending: runs when the promise is fulfilled; Result and Future returns are unwrapped
+    Promise<int> source;
+    Promise<std::string> inner;
+    Future<std::string> chained = source.get_future()
+        .then([](Future<int> f) { return Result<int>{ f.GetResult().Value() + 1 }; })
+        .then([&inner](Future<int> f) {
+            EXPECT_EQ(f.GetResult().Value(), 2);
+            return inner.get_future();
+        });
+    EXPECT_FALSE(chained.is_ready());
+    source.set_value(1);
+    EXPECT_FALSE(chained.is_ready());
+    inner.set_value("done");
+    EXPECT_EQ(chained.GetResult().Value(), "done");
+
+    // errors reach the continuation unchanged and can be passed on
+    Promise<int> failing;
+    Future<int> propagated = failing.get_future().then([](Future<int> f) {
+        return f.GetResult().Map([](int v) { return v + 1; });
+    });
+    failing.SetError(std::make_error_code(std::errc::io_error));
+    EXPECT_EQ(propagated.GetResult().Error(), std::make_error_code(std::errc::io_error));
+
+    // a continuation on a broken promise sees broken_promise
+    std::error_code seen;
+    Future<void> after;
+    {
+        Promise<int> dropped;
+        after = dropped.get_future().then([&seen](Future<int> f) { seen = f.GetResult().Error(); });
+    }
+    EXPECT_TRUE(after.GetResult().HasValue());
+    EXPECT_EQ(seen, std::make_error_code(std::future_errc::broken_promise));
+}
+
+// In-process diagnostic-manager IPC server for the transport and ara-diag
+// client tests. The client channel connects on its first request, so this
+// runs before any ara-diag object is used.
+static const std::string &IpcSocketPath() {
+    static const std::string path = [] {
+        const std::string p = "/tmp/dm_test_" + std::to_string(getpid()) + ".sock";
+        setenv(ara::diag::ipc::kSocketPathEnv, p.c_str(), 1);
+        diagnostic_manager::ipc::IpcServerConfig cfg;
+        cfg.socketPath = p;
+        if (diagnostic_manager::ipc::DMIpcServer::Start(cfg).HasValue()) std::atexit(diagnostic_manager::ipc::DMIpcServer::Stop);
+        return p;
+    }();
+    return path;
+}
+
+template <typename Predicate>
+static bool WaitUntil(Predicate done, std::chrono::milliseconds timeout = std::chrono::seconds(2)) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// The server unregisters a stopped offer on its own thread; wait for it so
+// the next test starts with a quiet registry.
+static void StopOfferAndWait(ara::diag::Monitor &monitor, const ara::core::InstanceSpecifier &id) {
+    monitor.StopOffer();
+    EXPECT_TRUE(WaitUntil([&] { return !diagnostic_manager::event::DMEvent::GetQualifiedState(id.GetName()).has_value(); }));
+}
+
+// Speaks the handshake protocol directly, so tests control the ring.
+struct RawIpcClient {
+    int sock{-1};
+    int fds[3]{-1, -1, -1};   // segment memfd, report eventfd, status eventfd
+    ara::diag::ipc::ClientSegment *segment{nullptr};
+
+    RawIpcClient() {
+        sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, IpcSocketPath().c_str(), sizeof(addr.sun_path) - 1);
+        if (connect(sock, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) Close();
+    }
+    ~RawIpcClient() {
+        if (segment != nullptr) munmap(segment, sizeof(*segment));
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+        Close();
+    }
+
+    void Close() {
+        if (sock >= 0) close(sock);
+        sock = -1;
+    }
+
+    // Sends msg and returns the reply; descriptors passed with it are kept.
+    ara::diag::ipc::HandshakeMessage Request(ara::diag::ipc::HandshakeMessage msg) {
+        EXPECT_EQ(send(sock, &msg, sizeof(msg), MSG_NOSIGNAL), static_cast<ssize_t>(sizeof(msg)));
+        iovec iov{&msg, sizeof(msg)};
+        alignas(cmsghdr) char control[CMSG_SPACE(3 * sizeof(int))];
+        msghdr mh{};
+        mh.msg_iov = &iov;
+        mh.msg_iovlen = 1;
+        mh.msg_control = control;
+        mh.msg_controllen = sizeof(control);
+        EXPECT_EQ(recvmsg(sock, &mh, MSG_CMSG_CLOEXEC), static_cast<ssize_t>(sizeof(msg)));
+        for (cmsghdr *c = CMSG_FIRSTHDR(&mh); c != nullptr; c = CMSG_NXTHDR(&mh, c)) {
+            if (c->cmsg_type == SCM_RIGHTS) std::memcpy(fds, CMSG_DATA(c), sizeof(fds));
+        }
+        return msg;
+    }
+
+    bool Hello() {
+        ara::diag::ipc::HandshakeMessage hello;
+        if (Request(hello).status != 0 || fds[0] < 0) return false;
+        void *mem = mmap(nullptr, sizeof(*segment), PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+        if (mem == MAP_FAILED) return false;
+        segment = static_cast<ara::diag::ipc::ClientSegment *>(mem);
+        return true;
+    }
+
+    std::uint32_t Offer(const std::string &specifier) {
+        ara::diag::ipc::HandshakeMessage msg;
+        msg.type = ara::diag::ipc::MessageType::kOffer;
+        msg.debounceKind = ara::diag::ipc::DebounceKind::kCounterBased;
+        std::strncpy(msg.specifier, specifier.c_str(), sizeof(msg.specifier) - 1);
+        msg = Request(msg);
+        return msg.status == 0 ? msg.handle : 0;
+    }
+
+    void Wakeup() {
+        const std::uint64_t one = 1;
+        EXPECT_EQ(write(fds[1], &one, sizeof(one)), static_cast<ssize_t>(sizeof(one)));
+    }
+};
+
+static ara::diag::ipc::ReportRecord Record(std::uint32_t handle, ara::diag::MonitorAction action) {
+    return ara::diag::ipc::ReportRecord{handle, static_cast<std::uint32_t>(action), 0};
+}
+
+TEST(AraDiagTest, IpcHandshakeHandsOutTheSharedSegment) {
+    using namespace diagnostic_manager;
+    using namespace ara::diag::ipc;
+
+    RawIpcClient client;
+    ASSERT_GE(client.sock, 0);
+    ASSERT_TRUE(client.Hello());
+    for (const ReportRing &lane : client.segment->reports) {
+        EXPECT_EQ(lane.magic, kRingMagic);
+        EXPECT_EQ(lane.version, kProtocolVersion);
+        EXPECT_EQ(lane.capacity, kRingCapacity);
+    }
+    EXPECT_EQ(client.segment->status.magic, kRingMagic);
+    HandshakeMessage again;
+    EXPECT_EQ(client.Request(again).status, EALREADY);
+
+    // a report through any lane reaches DMEvent
+    const std::string id = "/ipc/handshake/DiagnosticMonitor_0";
+    const std::uint32_t handle = client.Offer(id);
+    ASSERT_NE(handle, 0u);
+    ASSERT_TRUE(client.segment->reports[kReportLanes - 1].TryPush(Record(handle, ara::diag::MonitorAction::kFailed)));
+    client.Wakeup();
+    EXPECT_TRUE(WaitUntil([&] { return event::DMEvent::GetQualifiedState(id) == event::QualifiedState::QualifiedFailed; }));
+
+    RawIpcClient stale;
+    HandshakeMessage oldVersion;
+    oldVersion.version = kProtocolVersion - 1;
+    EXPECT_EQ(stale.Request(oldVersion).status, EPROTO);
+}
+
+TEST(AraDiagTest, IpcRingWrapsAroundItsIndices) {
+    using Ring = ara::diag::ipc::SpscRing<ara::diag::ipc::ReportRecord, 8>;
+    auto ring = std::make_unique<Ring>();
+    // free-running indices just below the 32-bit wrap
+    ring->head = 0xfffffffcu;
+    ring->tail = 0xfffffffcu;
+
+    ara::diag::ipc::ReportRecord out[8];
+    std::uint32_t next = 0;
+    std::uint32_t expected = 0;
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 5; ++i) ASSERT_TRUE(ring->TryPush(ara::diag::ipc::ReportRecord{next++, 0, 0}));
+        const std::size_t n = ring->PopBatch(out, 8);
+        ASSERT_EQ(n, 5u);
+        for (std::size_t i = 0; i < n; ++i) EXPECT_EQ(out[i].handle, expected++);
+    }
+    EXPECT_LT(ring->tail.load(), 0xfffffffcu);   // wrapped
+    EXPECT_TRUE(ring->Empty());
+}
+
+TEST(AraDiagTest, IpcFullRingPushesBackUntilDrained) {
+    using namespace diagnostic_manager;
+    using namespace ara::diag::ipc;
+
+    RawIpcClient client;
+    ASSERT_TRUE(client.Hello());
+    const std::string id = "/ipc/backpressure/DiagnosticMonitor_0";
+    const std::uint32_t handle = client.Offer(id);
+    ASSERT_NE(handle, 0u);
+    ReportRing &lane = client.segment->reports[0];
+
+    // once idle the daemon only drains after a wakeup, so the ring can fill up
+    ASSERT_TRUE(WaitUntil([&] { return lane.consumerWaiting.load() != 0; }));
+    const std::uint64_t drained = ipc::DMIpcServer::GetStatistics().reportsDrained;
+    for (std::uint32_t i = 0; i < kRingCapacity - 1; ++i) {
+        ASSERT_TRUE(lane.TryPush(Record(handle, ara::diag::MonitorAction::kPrepassed)));
+    }
+    ASSERT_TRUE(lane.TryPush(Record(handle, ara::diag::MonitorAction::kFailed)));
+    EXPECT_FALSE(lane.TryPush(Record(handle, ara::diag::MonitorAction::kPassed)));
+
+    client.Wakeup();
+    ASSERT_TRUE(WaitUntil([&] { return ipc::DMIpcServer::GetStatistics().reportsDrained >= drained + kRingCapacity; }));
+    EXPECT_EQ(event::DMEvent::GetQualifiedState(id), event::QualifiedState::QualifiedFailed);
+    ASSERT_TRUE(lane.TryPush(Record(handle, ara::diag::MonitorAction::kPassed)));
+    client.Wakeup();
+    EXPECT_TRUE(WaitUntil([&] { return event::DMEvent::GetQualifiedState(id) == event::QualifiedState::QualifiedPassed; }));
+}
+
+TEST(AraDiagTest, IpcDisconnectAppliesPendingReportsAndReleasesMonitors) {
+    using namespace diagnostic_manager;
+    using namespace ara::diag::ipc;
+
+    auto client = std::make_unique<RawIpcClient>();
+    ASSERT_TRUE(client->Hello());
+    const std::string id = "/ipc/disconnect/DiagnosticMonitor_0";
+    const std::uint32_t handle = client->Offer(id);
+    ASSERT_NE(handle, 0u);
+    ASSERT_TRUE(event::DMEvent::GetMonitorHandle(id).has_value());
+    const std::uint64_t clients = ipc::DMIpcServer::GetStatistics().clients;
+
+    ReportRing &lane = client->segment->reports[3];
+    ASSERT_TRUE(WaitUntil([&] { return lane.consumerWaiting.load() != 0; }));
+    const std::uint64_t drained = ipc::DMIpcServer::GetStatistics().reportsDrained;
+    for (int i = 0; i < 100; ++i) ASSERT_TRUE(lane.TryPush(Record(handle, ara::diag::MonitorAction::kPrefailed)));
+    client.reset();   // no wakeup: the reports are only drained because the socket closed
+
+    EXPECT_TRUE(WaitUntil([&] { return ipc::DMIpcServer::GetStatistics().clients == clients - 1; }));
+    EXPECT_EQ(ipc::DMIpcServer::GetStatistics().reportsDrained, drained + 100);
+    EXPECT_FALSE(event::DMEvent::GetMonitorHandle(id).has_value());
+}
+
+TEST(AraDiagTest, IpcClientGivesEachReportingThreadItsOwnLane) {
+    using namespace diagnostic_manager;
+    IpcSocketPath();
+    constexpr int kThreads = 4;
+    constexpr int kReports = 1000;   // below the lane capacity: nothing can be dropped
+
+    std::vector<std::unique_ptr<ara::core::InstanceSpecifier>> ids;
+    std::vector<std::unique_ptr<ara::diag::Monitor>> monitors;
+    for (int t = 0; t < kThreads; ++t) {
+        ids.push_back(std::make_unique<ara::core::InstanceSpecifier>("/ipc/lanes/DiagnosticMonitor_" + std::to_string(t)));
+        monitors.push_back(std::make_unique<ara::diag::Monitor>(*ids.back(), nullptr, ara::diag::CounterBased{}));
+        ASSERT_TRUE(monitors.back()->Offer().HasValue());
+    }
+    const ipc::IpcStatistics before = ipc::DMIpcServer::GetStatistics();
+
+    std::vector<std::thread> reporters;
+    for (int t = 0; t < kThreads; ++t) {
+        reporters.emplace_back([&, t] {
+            for (int i = 0; i < kReports; ++i) monitors[t]->ReportMonitorAction(ara::diag::MonitorAction::kPrepassed);
+            monitors[t]->ReportMonitorAction(ara::diag::MonitorAction::kFailed);
+        });
+    }
+    for (auto &t : reporters) t.join();
+
+    // every thread's reports arrive, the last one of each thread last
+    EXPECT_TRUE(WaitUntil([&] {
+        return ipc::DMIpcServer::GetStatistics().reportsDrained == before.reportsDrained + kThreads * (kReports + 1);
+    }));
+    EXPECT_EQ(ipc::DMIpcServer::GetStatistics().reportsDropped, before.reportsDropped);
+    for (const auto &id : ids) {
+        EXPECT_EQ(event::DMEvent::GetQualifiedState(id->GetName()), event::QualifiedState::QualifiedFailed);
+    }
+    for (int t = 0; t < kThreads; ++t) StopOfferAndWait(*monitors[t], *ids[t]);
+}
+
+TEST(AraDiagTest, IpcStatusNotifierSurvivesRejectedUpdatesAndStopsOnUnsubscribe) {
+    using namespace diagnostic_manager;
+    IpcSocketPath();
+    ara::core::InstanceSpecifier id("/ipc/notify/DiagnosticMonitor_0");
+    ara::diag::Monitor monitor(id, nullptr, ara::diag::CounterBased{});
+    ASSERT_TRUE(monitor.Offer().HasValue());
+    ara::diag::Event event(id);
+
+    std::atomic<int> calls{0};
+    std::atomic<bool> failed{false};
+    ASSERT_TRUE(event.SetEventStatusChangedNotifier([&](ara::diag::EventStatusByte status) {
+        failed = status.IsFailedAndTested();
+        ++calls;
+    }).HasValue());
+    monitor.ReportMonitorAction(ara::diag::MonitorAction::kFailed);
+    EXPECT_TRUE(WaitUntil([&] { return calls.load() == 1 && failed.load(); }));
+
+    // a rejected update keeps the installed notifier
+    auto rejected = event.SetEventStatusChangedNotifier([](ara::diag::EventStatusByte) {}, std::chrono::milliseconds(-1));
+    ASSERT_TRUE(rejected.HasError());
+    EXPECT_EQ(rejected.Error(), std::errc::invalid_argument);
+    monitor.ReportMonitorAction(ara::diag::MonitorAction::kPassed);
+    EXPECT_TRUE(WaitUntil([&] { return calls.load() == 2 && !failed.load(); }));
+
+    ASSERT_TRUE(event.SetEventStatusChangedNotifier(nullptr).HasValue());
+    monitor.ReportMonitorAction(ara::diag::MonitorAction::kFailed);
+    EXPECT_TRUE(WaitUntil([&] {
+        return event::DMEvent::GetQualifiedState(id.GetName()) == event::QualifiedState::QualifiedFailed;
+    }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(calls.load(), 2);
+    StopOfferAndWait(monitor, id);
+}
+
+TEST(AraDiagTest, IpcStatusCoalescingFollowsTheRemainingSubscribers) {
+    using namespace diagnostic_manager;
+    IpcSocketPath();
+    ara::core::InstanceSpecifier id("/ipc/coalesce/DiagnosticMonitor_0");
+    ara::diag::Monitor monitor(id, nullptr, ara::diag::CounterBased{});
+    ASSERT_TRUE(monitor.Offer().HasValue());
+    ara::diag::Event fast(id);
+    ara::diag::Event slow(id);
+
+    std::atomic<int> fastCalls{0};
+    std::atomic<int> slowCalls{0};
+    std::atomic<bool> slowFailed{false};
+    ASSERT_TRUE(fast.SetEventStatusChangedNotifier([&](ara::diag::EventStatusByte) { ++fastCalls; }).HasValue());
+    ASSERT_TRUE(slow.SetEventStatusChangedNotifier([&](ara::diag::EventStatusByte status) {
+        slowFailed = status.IsFailedAndTested();
+        ++slowCalls;
+    }, std::chrono::milliseconds(300)).HasValue());
+
+    // once the unthrottled subscriber leaves, a burst is coalesced for the other
+    ASSERT_TRUE(fast.SetEventStatusChangedNotifier(nullptr).HasValue());
+    for (int i = 0; i < 20; ++i) {
+        monitor.ReportMonitorAction(i % 2 == 0 ? ara::diag::MonitorAction::kFailed : ara::diag::MonitorAction::kPassed);
+    }
+    monitor.ReportMonitorAction(ara::diag::MonitorAction::kFailed);
+    EXPECT_TRUE(WaitUntil([&] { return slowCalls.load() >= 1 && slowFailed.load(); }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    EXPECT_LE(slowCalls.load(), 2);
+    EXPECT_TRUE(slowFailed.load());
+    EXPECT_EQ(fastCalls.load(), 0);
+    StopOfferAndWait(monitor, id);
+}
+
+TEST(AraDiagTest, FdcPollingSamplesAllMonitorsOnSharedWorkersAndWaitsOnRemove) {
+    using namespace diagnostic_manager;
+    IpcSocketPath();
+    ara::diag::FdcPollingConfig cfg;
+    cfg.period = std::chrono::milliseconds(2);
+    cfg.workerCount = 2;
+    cfg.batchSize = 4;
+    const auto configured = ara::diag::ConfigureFdcPolling(cfg);
+    ASSERT_TRUE(configured.HasValue() || configured.Error() == std::errc::device_or_resource_busy);   // repeated runs
+
+    constexpr int kMonitors = 10;
+    std::atomic<std::int8_t> fdc[kMonitors] = {};
+    std::atomic<int> samples[kMonitors] = {};
+    std::mutex threadsMutex;
+    std::vector<std::thread::id> threads;
+    std::atomic<bool> block{false};
+    std::atomic<bool> inside{false};
+
+    std::vector<std::unique_ptr<ara::core::InstanceSpecifier>> ids;
+    std::vector<std::unique_ptr<ara::diag::Monitor>> monitors;
+    for (int m = 0; m < kMonitors; ++m) {
+        ids.push_back(std::make_unique<ara::core::InstanceSpecifier>("/fdc/poll/DiagnosticMonitor_" + std::to_string(m)));
+        monitors.push_back(std::make_unique<ara::diag::Monitor>(*ids.back(), nullptr, [&, m]() -> std::int8_t {
+            ++samples[m];
+            {
+                std::lock_guard<std::mutex> lk(threadsMutex);
+                if (std::find(threads.begin(), threads.end(), std::this_thread::get_id()) == threads.end()) {
+                    threads.push_back(std::this_thread::get_id());
+                }
+            }
+            if (m == 0 && block.load()) {
+                inside = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+                inside = false;
+            }
+            return fdc[m].load();
+        }));
+        ASSERT_TRUE(monitors.back()->Offer().HasValue());
+    }
+
+    // every monitor is sampled each period, on the configured workers only
+    ASSERT_TRUE(WaitUntil([&] {
+        for (const auto &n : samples) {
+            if (n.load() < 5) return false;
+        }
+        return true;
+    }));
+    {
+        std::lock_guard<std::mutex> lk(threadsMutex);
+        EXPECT_LE(threads.size(), 2u);
+    }
+
+    fdc[3] = 127;
+    fdc[4] = -128;
+    EXPECT_TRUE(WaitUntil([&] {
+        return event::DMEvent::GetQualifiedState(ids[3]->GetName()) == event::QualifiedState::QualifiedFailed &&
+               event::DMEvent::GetQualifiedState(ids[4]->GetName()) == event::QualifiedState::QualifiedPassed;
+    }));
+
+    // removing a monitor while it is sampled waits for the sample to finish
+    block = true;
+    ASSERT_TRUE(WaitUntil([&] { return inside.load(); }));
+    monitors[0]->StopOffer();
+    EXPECT_FALSE(inside.load());
+    const int sampled = samples[0].load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(samples[0].load(), sampled);
+    EXPECT_GT(samples[1].load(), 0);
+
+    for (int m = 0; m < kMonitors; ++m) StopOfferAndWait(*monitors[m], *ids[m]);
+}
+
+TEST(AraDiagTest, CounterJumpUpSkipsPassedRange) {
+    using namespace diagnostic_manager::event;
+    DebounceConfig cfg;
+    cfg.jumpUp = true;
+    cfg.failedJumpValue = 2;
+    const MonitorId mid = "jump_monitor";
+    ASSERT_TRUE(DMEvent::RegisterMonitor(mid, cfg, nullptr).HasValue());
+
+    for (int i = 0; i < 3; ++i) DMEvent::ReportPreEvent(mid, false);
+    EXPECT_EQ(DMEvent::GetQualifiedState(mid), QualifiedState::QualifiedPassed);
+
+    // -3 jumps to 2, one step reaches the failed threshold
+    DMEvent::ReportPreEvent(mid, true);
+    EXPECT_EQ(DMEvent::GetQualifiedState(mid), QualifiedState::QualifiedFailed);
+    DMEvent::UnregisterMonitor(mid);
+}
+
+TEST(AraDiagTest, CounterFdcThresholdNotifiesOnce) {
+    using namespace diagnostic_manager::event;
+    DebounceConfig cfg;
+    cfg.failedThreshold = 5;
+    cfg.fdcThreshold = 2;
+    int calls = 0;
+    const MonitorId mid = "fdc_monitor";
+    ASSERT_TRUE(DMEvent::RegisterMonitor(mid, cfg, [&](const MonitorId &, QualifiedState) { ++calls; }).HasValue());
+
+    DMEvent::ReportPreEvent(mid, true);
+    EXPECT_EQ(calls, 0);
+    DMEvent::ReportPreEvent(mid, true);   // counter 2: threshold crossed
+    DMEvent::ReportPreEvent(mid, true);
+    EXPECT_EQ(calls, 1);
+    DMEvent::UnregisterMonitor(mid);
+}
+
+TEST(AraDiagTest, TimeBasedUsesSeparateFailedAndPassedDelays) {
+    using namespace diagnostic_manager::event;
+    DebounceConfig cfg;
+    cfg.mode = DebounceMode::TimeBased;
+    cfg.timeFailedThresholdMs = 20;
+    cfg.timePassedThresholdMs = 300;
+    cfg.timeFdcThresholdMs = 5;
+    std::atomic<int> calls{0};
+    const MonitorId mid = "time_monitor";
+    ASSERT_TRUE(DMEvent::RegisterMonitor(mid, cfg, [&](const MonitorId &, QualifiedState) { ++calls; }).HasValue());
+
+    // qualifies without further reports: FDC deadline, then failed deadline
+    DMEvent::ReportPreEvent(mid, true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(DMEvent::GetQualifiedState(mid), QualifiedState::QualifiedFailed);
+    EXPECT_EQ(calls.load(), 2);
+
+    DMEvent::ReportPreEvent(mid, false);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(DMEvent::GetQualifiedState(mid), QualifiedState::Unqualified);
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    EXPECT_EQ(DMEvent::GetQualifiedState(mid), QualifiedState::QualifiedPassed);
+    DMEvent::UnregisterMonitor(mid);
+}
+
+TEST(AraDiagTest, ManifestLoadRegistersConfiguredEntities) {
+    using namespace diagnostic_manager;
+    config::ManifestBuilder builder;
+    event::DebounceConfig cfg;
+    cfg.failedThreshold = 2;
+    builder.AddMonitor("manifest/b", cfg);
+    builder.AddMonitor("manifest/a", event::DebounceConfig{});
+    builder.AddDtc(0x00AB01);
+    builder.AddDtc(0x00AB02, true);
+    builder.AddCycle("manifest/cycle");
+    builder.LinkDtc("manifest/b", 0x00AB02);
+    builder.LinkDtc("manifest/b", 0x00AB01);
+    builder.LinkCycle("manifest/b", "manifest/cycle");
+    auto image = builder.Build();
+    ASSERT_TRUE(image.HasValue());
+
+    const std::string path = ::testing::TempDir() + "dm_manifest_test.dmm";
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char *>(image.Value().data()),
+                                                static_cast<std::streamsize>(image.Value().size()));
+    auto loaded = config::DMConfig::LoadManifest(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(loaded.HasValue());
+    EXPECT_EQ(loaded.Value().monitors, 2u);
+    EXPECT_TRUE(config::DMConfig::LoadManifest(path).HasError());   // only one manifest
+
+    // registered with the configured debounce parameters
+    event::DMEvent::ReportPreEvent("manifest/b", true);
+    event::DMEvent::ReportPreEvent("manifest/b", true);
+    EXPECT_EQ(event::DMEvent::GetQualifiedState("manifest/b"), event::QualifiedState::QualifiedFailed);
+    EXPECT_EQ(dtc::DMDtc::GetDtcSuppression(0x00AB02), true);
+    EXPECT_TRUE(operation_cycle::DMOperationCycle::GetOperationCycleState("manifest/cycle").HasValue());
+
+    EXPECT_TRUE(config::DMConfig::IsConfiguredMonitor("manifest/a"));
+    EXPECT_FALSE(config::DMConfig::IsConfiguredMonitor("manifest/c"));
+    EXPECT_EQ(config::DMConfig::GetDtcsOfMonitor("manifest/b"), (std::vector<dtc::DtcId>{0x00AB01, 0x00AB02}));
+    EXPECT_EQ(config::DMConfig::GetOperationCyclesOfMonitor("manifest/b").size(), 1u);
+    EXPECT_TRUE(config::DMConfig::GetDtcsOfMonitor("manifest/a").empty());
+}
+
+TEST(AraDiagTest, ManifestRejectsCorruptImage) {
+    using namespace diagnostic_manager;
+    config::ManifestBuilder builder;
+    builder.AddMonitor("corrupt/a", event::DebounceConfig{});
+    auto image = builder.Build();
+    ASSERT_TRUE(image.HasValue());
+    ASSERT_TRUE(config::Manifest::FromBuffer(image.Value()).HasValue());
+
+    std::vector<std::uint8_t> flipped = image.Value();
+    flipped.back() ^= 0xFF;
+    EXPECT_EQ(config::Manifest::FromBuffer(flipped).Error(), std::errc::bad_message);
+    std::vector<std::uint8_t> truncated(image.Value().begin(), image.Value().end() - 8);
+    EXPECT_TRUE(config::Manifest::FromBuffer(truncated).HasError());
+
+    builder.LinkCycle("corrupt/a", "missing");
+    EXPECT_EQ(builder.Build().Error(), std::errc::no_such_file_or_directory);
+}
+
+TEST(AraDiagTest, BulkRegistrationIsAllOrNothing) {
+    using namespace diagnostic_manager;
+    std::vector<event::MonitorRegistration> monitors(3);
+    monitors[0].id = "bulk/a";
+    monitors[1].id = "bulk/b";
+    monitors[2].id = "bulk/a";   // duplicate within the batch
+    EXPECT_EQ(event::DMEvent::RegisterMonitors(monitors.data(), monitors.size()).Error(), std::errc::file_exists);
+    EXPECT_FALSE(event::DMEvent::GetQualifiedState("bulk/b").has_value());
+
+    monitors[2].id = "bulk/c";
+    monitors[2].cfg.mode = event::DebounceMode::TimeBased;
+    ASSERT_TRUE(event::DMEvent::RegisterMonitors(monitors.data(), monitors.size()).HasValue());
+    EXPECT_TRUE(event::DMEvent::GetQualifiedState("bulk/c").has_value());
+    // conflicts with an existing registration
+    EXPECT_TRUE(event::DMEvent::RegisterMonitors(monitors.data() + 1, 1).HasError());
+
+    std::vector<dtc::DtcRegistration> dtcs(2);
+    dtcs[0].dtc = 0x00BB01;
+    dtcs[1].dtc = 0x00BB02;
+    dtcs[1].suppressed = true;
+    ASSERT_TRUE(dtc::DMDtc::RegisterDtcs(dtcs.data(), dtcs.size()).HasValue());
+    EXPECT_EQ(dtc::DMDtc::GetDtcSuppression(0x00BB02), true);
+    dtcs[0].dtc = 0x00BB03;   // new, but 0x00BB02 is taken
+    EXPECT_TRUE(dtc::DMDtc::RegisterDtcs(dtcs.data(), dtcs.size()).HasError());
+    EXPECT_FALSE(dtc::DMDtc::GetDtcSuppression(0x00BB03).has_value());
+
+    std::vector<operation_cycle::OperationCycleRegistration> cycles(2);
+    cycles[0].id = "bulk/cycle";
+    cycles[1].id = "bulk/cycle";
+    EXPECT_TRUE(operation_cycle::DMOperationCycle::RegisterOperationCycles(cycles.data(), cycles.size()).HasError());
+    EXPECT_TRUE(operation_cycle::DMOperationCycle::GetOperationCycleState("bulk/cycle").HasError());
+
+    for (const char *id : {"bulk/a", "bulk/b", "bulk/c"}) event::DMEvent::UnregisterMonitor(id);
+}
+
+TEST(AraDiagTest, PerfectHashResolvesRegisteredNamesOnly) {
+    using namespace diagnostic_manager;
+    std::vector<std::string> names;
+    for (int i = 0; i < 5000; ++i) names.push_back("/ecu/phf/Monitor_" + std::to_string(i));
+    std::vector<std::string_view> views(names.begin(), names.end());
+    auto ph = common::PerfectHash::Build(views);
+    ASSERT_TRUE(ph.HasValue());
+    ASSERT_EQ(ph.Value().Size(), views.size());
+    std::vector<std::string_view> bySlot(views.size());
+    for (std::string_view v : views) {
+        const std::uint32_t slot = ph.Value().Slot(v);
+        ASSERT_LT(slot, views.size());
+        EXPECT_TRUE(bySlot[slot].empty());   // one key per slot, no slot left over
+        bySlot[slot] = v;
+    }
+    // unknown names land in some slot and are rejected by the compare
+    EXPECT_NE(bySlot[ph.Value().Slot("/ecu/phf/Monitor_5000")], "/ecu/phf/Monitor_5000");
+    EXPECT_LT(ph.Value().Slot(""), views.size());
+    views.push_back(views.front());
+    EXPECT_EQ(common::PerfectHash::Build(views).Error(), std::errc::invalid_argument);
+
+    // indexed names stay resolvable across unregister / re-register
+    std::vector<event::MonitorRegistration> monitors(2);
+    monitors[0].id = "phf/a";
+    monitors[1].id = "phf/b";
+    ASSERT_TRUE(event::DMEvent::RegisterMonitors(monitors.data(), monitors.size()).HasValue());
+    ASSERT_TRUE(event::DMEvent::UnregisterMonitor("phf/a").HasValue());
+    EXPECT_FALSE(event::DMEvent::GetQualifiedState("phf/a").has_value());
+    ASSERT_TRUE(event::DMEvent::RegisterMonitor("phf/a", event::DebounceConfig{}, nullptr).HasValue());
+    ASSERT_TRUE(event::DMEvent::SetQualifiedState("phf/a", event::QualifiedState::QualifiedFailed).HasValue());
+    EXPECT_EQ(event::DMEvent::GetQualifiedState("phf/a"), event::QualifiedState::QualifiedFailed);
+    for (const char *id : {"phf/a", "phf/b"}) event::DMEvent::UnregisterMonitor(id);
+}
+
+TEST(AraDiagTest, StartupProfileWritesPhasesWhenEnabled) {
+    using namespace diagnostic_manager::common;
+    unsetenv(kStartupProfileEnv);
+    StartupProfile::Begin();
+    { StartupPhaseScope phase("test.disabled"); }
+    EXPECT_TRUE(StartupProfile::Phases().empty());
+
+    const std::string path = "/tmp/dm_test_startup_profile.jsonl";
+    setenv(kStartupProfileEnv, path.c_str(), 1);
+    StartupProfile::Begin();
+    { StartupPhaseScope phase("test.phase"); }
+    ASSERT_EQ(StartupProfile::Phases().size(), 1u);
+    EXPECT_STREQ(StartupProfile::Phases()[0].name, "test.phase");
+    StartupProfile::Ready();
+    unsetenv(kStartupProfileEnv);
+    EXPECT_FALSE(StartupProfile::Enabled());
+
+    std::ifstream in(path);
+    std::string first, last;
+    std::getline(in, first);
+    std::getline(in, last);
+    EXPECT_EQ(first.rfind("{\"phase\":\"test.phase\",\"start_us\":", 0), 0u);
+    EXPECT_EQ(last.rfind("{\"ready_us\":", 0), 0u);
+    std::remove(path.c_str());
+}
+
+TEST(AraDiagTest, ExecutorLatencyLaneIsNotBlockedByBulkWork) {
+    using namespace diagnostic_manager::common;
+    using namespace std::chrono_literals;
+    Executor::Shutdown();
+    ExecutorConfig cfg;
+    ASSERT_TRUE(Executor::Configure(cfg).HasValue());
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    ASSERT_TRUE(Executor::Post(TaskLane::Bulk, [released] { released.wait(); }).HasValue());
+    std::promise<void> latencyRan;
+    ASSERT_TRUE(Executor::Post(TaskLane::Latency, [&latencyRan] { latencyRan.set_value(); }).HasValue());
+    EXPECT_EQ(latencyRan.get_future().wait_for(1s), std::future_status::ready);
+    EXPECT_EQ(Executor::Configure(cfg).Error(), std::errc::device_or_resource_busy);
+
+    // timed tasks run in deadline order, not posting order
+    std::mutex orderMutex;
+    std::vector<int> order;
+    std::promise<void> bothRan;
+    const auto now = Executor::Clock::now();
+    Executor::PostAt(TaskLane::Latency, now + 20ms, [&] {
+        std::lock_guard<std::mutex> lk(orderMutex);
+        order.push_back(2);
+        bothRan.set_value();
+    });
+    Executor::PostAt(TaskLane::Latency, now + 5ms, [&] {
+        std::lock_guard<std::mutex> lk(orderMutex);
+        order.push_back(1);
+    });
+    EXPECT_EQ(bothRan.get_future().wait_for(1s), std::future_status::ready);
+    {
+        std::lock_guard<std::mutex> lk(orderMutex);
+        EXPECT_EQ(order, (std::vector<int>{1, 2}));
+    }
+
+    release.set_value();
+    Executor::Shutdown();
+    EXPECT_FALSE(Executor::Running());
+    cfg.bulk.workers = 0;
+    EXPECT_EQ(Executor::Configure(cfg).Error(), std::errc::invalid_argument);
+}
+
+TEST(AraDiagTest, IngestionAppliesEachReporterInOrder) {
+    using namespace diagnostic_manager::event;
+    constexpr int kReporters = 4;
+    constexpr int kFailed = 1000;
+    DebounceConfig cfg;
+    cfg.failedThreshold = kFailed;
+    cfg.passedThreshold = kFailed;
+    std::atomic<int> failed{0}, passed{0};
+    const auto notifier = [&](const MonitorId &, QualifiedState state) {
+        if (state == QualifiedState::QualifiedFailed) ++failed;
+        if (state == QualifiedState::QualifiedPassed) ++passed;
+    };
+    std::vector<MonitorHandle> handles;
+    for (int r = 0; r < kReporters; ++r) {
+        const MonitorId mid = "ingest_monitor_" + std::to_string(r);
+        ASSERT_TRUE(DMEvent::RegisterMonitor(mid, cfg, notifier).HasValue());
+        handles.push_back(DMEvent::GetMonitorHandle(mid).value());
+    }
+    EXPECT_EQ(DMIngestion::ReportPreEvent(handles[0], true).Error(), std::errc::not_connected);
+
+    IngestionConfig icfg;
+    icfg.queueCapacity = 256;   // small enough for reporters to hit a full queue
+    ASSERT_TRUE(DMIngestion::Start(icfg).HasValue());
+    EXPECT_EQ(DMIngestion::Start(icfg).Error(), std::errc::already_connected);
+
+    // counter to +kFailed, then to -kFailed: one failed and one passed
+    // qualification each, unless reports were reordered
+    std::vector<std::thread> reporters;
+    for (int r = 0; r < kReporters; ++r) {
+        reporters.emplace_back([&, r] {
+            for (int i = 0; i < 3 * kFailed; ++i) {
+                while (DMIngestion::ReportPreEvent(handles[r], i < kFailed).HasError()) std::this_thread::yield();
+            }
+        });
+    }
+    for (auto &t : reporters) t.join();
+    DMIngestion::Stop();
+
+    const IngestionStatistics stats = DMIngestion::GetStatistics();
+    EXPECT_EQ(stats.applied, static_cast<std::uint64_t>(kReporters) * 3 * kFailed);
+    EXPECT_EQ(stats.stale, 0u);
+    EXPECT_EQ(failed.load(), kReporters);
+    EXPECT_EQ(passed.load(), kReporters);
+    for (int r = 0; r < kReporters; ++r) {
+        const MonitorId mid = "ingest_monitor_" + std::to_string(r);
+        EXPECT_EQ(DMEvent::GetQualifiedState(mid), QualifiedState::QualifiedPassed);
+        DMEvent::UnregisterMonitor(mid);
+    }
+    EXPECT_EQ(DMIngestion::ReportPreEvent(handles[0], true).Error(), std::errc::not_connected);
+}
+
+TEST(AraDiagTest, IngestionStartFailsCleanlyWhenAConsumerOptionCannotBeApplied) {
+    using namespace diagnostic_manager;
+    event::IngestionConfig icfg;
+    icfg.consumers = 2;
+    common::WorkerOptions pinned;
+    pinned.cpu = 1000;   // no such CPU
+    icfg.consumerOptions = {common::WorkerOptions{}, pinned};
+    const auto started = event::DMIngestion::Start(icfg);
+    ASSERT_TRUE(started.HasError());
+    EXPECT_EQ(started.Error(), std::errc::invalid_argument);
+
+    // nothing is left running: a valid configuration starts afterwards
+    icfg.consumerOptions.clear();
+    ASSERT_TRUE(event::DMIngestion::Start(icfg).HasValue());
+    event::DMIngestion::Stop();
+}
+
+
+TEST(AraDiagTest, VirtualClockFiresDeadlinesOnAdvance) {
+    using namespace diagnostic_manager;
+    using namespace std::chrono_literals;
+    using common::DmClock;
+    EXPECT_EQ(DmClock::Advance(1s).Error(), std::errc::operation_not_permitted);
+    DmClock::UseVirtual();
+
+    // default thresholds: 12 s each way
+    event::DebounceConfig cfg;
+    cfg.mode = event::DebounceMode::TimeBased;
+    std::vector<event::QualifiedState> seen;
+    const event::MonitorId mid = "virtual_time_monitor";
+    ASSERT_TRUE(event::DMEvent::RegisterMonitor(mid, cfg, [&](const event::MonitorId &, event::QualifiedState s) {
+        seen.push_back(s);   // runs on this thread, inside Advance
+    }).HasValue());
+
+    event::DMEvent::ReportPreEvent(mid, true);
+    ASSERT_TRUE(DmClock::Advance(11999ms).HasValue());
+    EXPECT_EQ(event::DMEvent::GetQualifiedState(mid), event::QualifiedState::Unqualified);
+    ASSERT_TRUE(DmClock::Advance(2ms).HasValue());
+    EXPECT_EQ(event::DMEvent::GetQualifiedState(mid), event::QualifiedState::QualifiedFailed);
+
+    event::DMEvent::ReportPreEvent(mid, false);
+    ASSERT_TRUE(DmClock::Advance(24h).HasValue());
+    EXPECT_EQ(seen, (std::vector<event::QualifiedState>{event::QualifiedState::QualifiedFailed,
+                                                         event::QualifiedState::Unqualified,
+                                                         event::QualifiedState::QualifiedPassed}));
+    event::DMEvent::UnregisterMonitor(mid);
+    DmClock::UseReal();
+}
+
+TEST(AraDiagTest, RealClockDeadlinesFireOnTimeAfterVirtualAdvance) {
+    using namespace diagnostic_manager;
+    using namespace std::chrono_literals;
+    using common::DmClock;
+    event::DebounceConfig cfg;
+    cfg.mode = event::DebounceMode::TimeBased;
+    cfg.timeFailedThresholdMs = 20;
+    const event::MonitorId mid = "virtual_then_real_monitor";
+    ASSERT_TRUE(event::DMEvent::RegisterMonitor(mid, cfg, nullptr).HasValue());
+
+    // a virtual day leaves the deadline wheel a day ahead of steady_clock
+    DmClock::UseVirtual();
+    event::DMEvent::ReportPreEvent(mid, true);
+    ASSERT_TRUE(DmClock::Advance(24h).HasValue());
+    event::DMEvent::ReportPreEvent(mid, false);
+    ASSERT_TRUE(DmClock::Advance(24h).HasValue());
+    DmClock::UseReal();
+
+    event::DMEvent::ReportPreEvent(mid, true);
+    std::this_thread::sleep_for(100ms);
+    EXPECT_EQ(event::DMEvent::GetQualifiedState(mid), event::QualifiedState::QualifiedFailed);
+    event::DMEvent::UnregisterMonitor(mid);
+}
+
+
+TEST(AraDiagTest, OverloadPolicyFiltersRepeatsAndDefersOverBudget) {
+    using namespace diagnostic_manager;
+    using namespace std::chrono_literals;
+    using event::DMEvent;
+    const event::MonitorId mid = "overload_monitor";
+    ASSERT_TRUE(DMEvent::RegisterMonitor(mid, event::DebounceConfig{}, nullptr).HasValue());
+    const event::MonitorHandle handle = DMEvent::GetMonitorHandle(mid).value();
+    const event::OverloadStatistics before = DMEvent::GetOverloadStatistics();
+
+    // saturated at the failed threshold: further pre-failed reports are dropped
+    DMEvent::SetOverloadPolicy(event::OverloadPolicy{true, 0, event::OverloadAction::Drop});
+    for (int i = 0; i < 10; ++i) ASSERT_TRUE(DMEvent::ReportPreEvent(handle, true).HasValue());
+    EXPECT_EQ(DMEvent::GetQualifiedState(mid), event::QualifiedState::QualifiedFailed);
+    EXPECT_EQ(DMEvent::GetOverloadStatistics().filtered - before.filtered, 7u);
+    DMEvent::ReportPreEvent(handle, false);   // not a repeat
+    DMEvent::ResetDebouncing(mid);
+
+    // budget of 2 per second: the rest collapses to the latest pre-state
+    common::DmClock::UseVirtual();
+    DMEvent::SetOverloadPolicy(event::OverloadPolicy{false, 2, event::OverloadAction::Defer});
+    ASSERT_TRUE(common::DmClock::Advance(1s).HasValue());   // fresh window
+    for (int i = 0; i < 5; ++i) ASSERT_TRUE(DMEvent::ReportPreEvent(handle, true).HasValue());
+    EXPECT_EQ(DMEvent::GetQualifiedState(mid), event::QualifiedState::Unqualified);
+    ASSERT_TRUE(common::DmClock::Advance(1s).HasValue());
+    EXPECT_EQ(DMEvent::GetQualifiedState(mid), event::QualifiedState::QualifiedFailed);
+    const event::OverloadStatistics after = DMEvent::GetOverloadStatistics();
+    EXPECT_EQ(after.deferred - before.deferred, 3u);
+    EXPECT_EQ(after.deferredApplied - before.deferredApplied, 1u);
+
+    DMEvent::SetOverloadPolicy(event::OverloadPolicy{false, 1, event::OverloadAction::Drop});
+    ASSERT_TRUE(common::DmClock::Advance(1s).HasValue());
+    EXPECT_TRUE(DMEvent::ReportPreEvent(handle, false).HasValue());
+    EXPECT_EQ(DMEvent::ReportPreEvent(handle, false).Error(), std::errc::resource_unavailable_try_again);
+
+    DMEvent::SetOverloadPolicy(event::OverloadPolicy{});
+    common::DmClock::UseReal();
+    DMEvent::UnregisterMonitor(mid);
+    EXPECT_EQ(DMEvent::ReportPreEvent(handle, true).Error(), std::errc::no_such_file_or_directory);
+}
+
+TEST(AraDiagTest, OverloadBudgetSkipsDeferredReportsOfFrozenMonitors) {
+    using namespace diagnostic_manager;
+    using namespace std::chrono_literals;
+    using event::DMEvent;
+    event::DebounceConfig cfg;
+    cfg.failedThreshold = 1;
+    cfg.passedThreshold = 4;
+    const event::MonitorId frozen = "overload_frozen_monitor";
+    const event::MonitorId live = "overload_live_monitor";
+    ASSERT_TRUE(DMEvent::RegisterMonitor(frozen, cfg, nullptr).HasValue());
+    ASSERT_TRUE(DMEvent::RegisterMonitor(live, cfg, nullptr).HasValue());
+    const event::MonitorHandle frozenHandle = DMEvent::GetMonitorHandle(frozen).value();
+    const event::MonitorHandle liveHandle = DMEvent::GetMonitorHandle(live).value();
+
+    // one report per second: both monitors are deferred, the frozen one first
+    common::DmClock::UseVirtual();
+    DMEvent::SetOverloadPolicy(event::OverloadPolicy{false, 1, event::OverloadAction::Defer});
+    ASSERT_TRUE(common::DmClock::Advance(1s).HasValue());   // fresh window
+    ASSERT_TRUE(DMEvent::ReportPreEvent(frozenHandle, false).HasValue());
+    ASSERT_TRUE(DMEvent::ReportPreEvent(frozenHandle, true).HasValue());
+    ASSERT_TRUE(DMEvent::ReportPreEvent(liveHandle, true).HasValue());
+    ASSERT_TRUE(DMEvent::FreezeDebouncing(frozen).HasValue());
+
+    // the next window's single report goes to the live monitor
+    ASSERT_TRUE(common::DmClock::Advance(1s).HasValue());
+    EXPECT_EQ(DMEvent::GetQualifiedState(live), event::QualifiedState::QualifiedFailed);
+    EXPECT_NE(DMEvent::GetQualifiedState(frozen), event::QualifiedState::QualifiedFailed);
+
+    DMEvent::SetOverloadPolicy(event::OverloadPolicy{});
+    common::DmClock::UseReal();
+    DMEvent::UnregisterMonitor(frozen);
+    DMEvent::UnregisterMonitor(live);
+}
+
+TEST(AraDiagTest, StateStreamIsOrderedAndShowsGaps) {
+    using namespace diagnostic_manager::event;
+    const MonitorId mid = "stream_monitor";
+    ASSERT_TRUE(DMEvent::RegisterMonitor(mid, DebounceConfig{}, nullptr).HasValue());
+    const StateStreamId stream = DMEvent::OpenStateStream(4).Value();
+    const MonitorHandle handle = DMEvent::GetMonitorHandle(mid).value();
+
+    // six changes into a ring of four: the last two are dropped
+    for (int i = 0; i < 6; ++i) {
+        DMEvent::SetQualifiedState(mid, i % 2 == 0 ? QualifiedState::QualifiedFailed : QualifiedState::QualifiedPassed);
+    }
+    StateChange out[8];
+    ASSERT_EQ(DMEvent::ReadStateStream(stream, out, 8), 4u);
+    for (std::size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(out[i].handle, handle);
+        EXPECT_EQ(out[i].sequence, i + 1);
+        EXPECT_EQ(out[i].state, i % 2 == 0 ? QualifiedState::QualifiedFailed : QualifiedState::QualifiedPassed);
+    }
+    DMEvent::SetQualifiedState(mid, QualifiedState::QualifiedFailed);
+    DMEvent::SetQualifiedState(mid, QualifiedState::QualifiedFailed);   // no change, no entry
+    ASSERT_EQ(DMEvent::ReadStateStream(stream, out, 8), 1u);
+    EXPECT_EQ(out[0].sequence, 7u);   // 5 and 6 were lost
+
+    EXPECT_TRUE(DMEvent::CloseStateStream(stream).HasValue());
+    EXPECT_EQ(DMEvent::ReadStateStream(stream, out, 8), 0u);
+    EXPECT_EQ(DMEvent::CloseStateStream(stream).Error(), std::errc::no_such_file_or_directory);
+    DMEvent::UnregisterMonitor(mid);
+}
+
+TEST(AraDiagTest, RetiredNotifiersOutliveInFlightCallbacks) {
+    using namespace diagnostic_manager;
+    using event::DMEvent;
+
+    // a replaced object is kept while a pin taken before the replacement is held
+    auto tracker = std::make_shared<int>(42);
+    std::weak_ptr<int> weak = tracker;
+    common::EpochSlot<std::shared_ptr<int>> slot;
+    slot.Reset(std::make_unique<std::shared_ptr<int>>(std::move(tracker)));
+    {
+        const common::EpochGuard pin;
+        const std::shared_ptr<int> *held = slot.Get();
+        slot.Reset();
+        common::Epoch::Reclaim();
+        EXPECT_FALSE(weak.expired());
+        EXPECT_EQ(**held, 42);
+    }
+    common::Epoch::Reclaim();
+    EXPECT_TRUE(weak.expired());
+
+    // a notifier may unregister its own monitor
+    const event::MonitorId mid = "self_unregistering_monitor";
+    tracker = std::make_shared<int>(7);
+    weak = tracker;
+    int seen = 0;
+    ASSERT_TRUE(DMEvent::RegisterMonitor(mid, event::DebounceConfig{},
+                                         [mid, tracker, &seen](const event::MonitorId &, event::QualifiedState) {
+                                             DMEvent::UnregisterMonitor(mid);
+                                             seen = *tracker;
+                                         }).HasValue());
+    tracker.reset();
+    DMEvent::SetQualifiedState(mid, event::QualifiedState::QualifiedFailed);
+    EXPECT_EQ(seen, 7);
+    EXPECT_FALSE(DMEvent::GetQualifiedState(mid).has_value());
+    common::Epoch::Reclaim();
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(AraDiagTest, ReplacingAnInternedDebounceConfigUpdatesAllItsMonitors) {
+    using namespace diagnostic_manager::event;
+    DebounceConfig shared;
+    shared.failedThreshold = 17;
+    DebounceConfig other = shared;
+    other.failedStep = 2;
+    const MonitorId ids[] = {"interned_a", "interned_b", "interned_c"};
+    for (const auto &id : ids) ASSERT_TRUE(DMEvent::RegisterMonitor(id, shared, nullptr).HasValue());
+    ASSERT_TRUE(DMEvent::RegisterMonitor("interned_other", other, nullptr).HasValue());
+
+    DebounceConfig quick = shared;
+    quick.failedThreshold = 1;
+    EXPECT_TRUE(DMEvent::ReplaceDebounceConfig(shared, quick).HasValue());
+    for (const auto &id : ids) {
+        DMEvent::ReportPreEvent(id, true);
+        EXPECT_EQ(DMEvent::GetQualifiedState(id), QualifiedState::QualifiedFailed);
+    }
+    DMEvent::ReportPreEvent("interned_other", true);
+    EXPECT_EQ(DMEvent::GetQualifiedState("interned_other"), QualifiedState::Unqualified);
+
+    EXPECT_EQ(DMEvent::ReplaceDebounceConfig(shared, quick).Error(), std::errc::no_such_file_or_directory);
+    DebounceConfig timed;
+    timed.mode = DebounceMode::TimeBased;
+    EXPECT_EQ(DMEvent::ReplaceDebounceConfig(quick, timed).Error(), std::errc::invalid_argument);
+    for (const auto &id : ids) DMEvent::UnregisterMonitor(id);
+    DMEvent::UnregisterMonitor("interned_other");
+}
+
+TEST(AraDiagTest, MergedAndUnusedDebounceConfigsCannotBeReplaced) {
+    using namespace diagnostic_manager::event;
+    DebounceConfig first;
+    first.failedThreshold = 23;
+    DebounceConfig second = first;
+    second.passedThreshold = 23;
+    ASSERT_TRUE(DMEvent::RegisterMonitor("merged_a", first, nullptr).HasValue());
+    ASSERT_TRUE(DMEvent::RegisterMonitor("merged_b", second, nullptr).HasValue());
+
+    // `first` is merged into `second`: only `second` names a set any more
+    EXPECT_TRUE(DMEvent::ReplaceDebounceConfig(first, second).HasValue());
+    DebounceConfig quick = second;
+    quick.failedThreshold = 1;
+    EXPECT_EQ(DMEvent::ReplaceDebounceConfig(first, quick).Error(), std::errc::no_such_file_or_directory);
+    EXPECT_TRUE(DMEvent::ReplaceDebounceConfig(second, quick).HasValue());
+    DMEvent::ReportPreEvent("merged_a", true);
+    EXPECT_EQ(DMEvent::GetQualifiedState("merged_a"), QualifiedState::QualifiedFailed);
+
+    // a set whose monitors are all unregistered is gone as well
+    DMEvent::UnregisterMonitor("merged_a");
+    DMEvent::UnregisterMonitor("merged_b");
+    EXPECT_EQ(DMEvent::ReplaceDebounceConfig(quick, second).Error(), std::errc::no_such_file_or_directory);
+}
+
+TEST(AraDiagTest, MemoryFootprintCountsHotAndColdRecords) {
+    using namespace diagnostic_manager;
+    using event::DMEvent;
+    using dtc::DMDtc;
+
+    std::vector<event::MonitorId> ids;
+    std::vector<event::MonitorRegistration> monitors;
+    for (int i = 0; i < 1000; ++i) ids.push_back("footprint_monitor_" + std::to_string(i));
+    for (const auto &id : ids) monitors.push_back(event::MonitorRegistration{id, event::DebounceConfig{}, nullptr});
+    const common::MemoryFootprint before = DMEvent::GetMemoryFootprint();
+    ASSERT_TRUE(DMEvent::RegisterMonitors(monitors.data(), monitors.size()).HasValue());
+    const common::MemoryFootprint after = DMEvent::GetMemoryFootprint();
+    EXPECT_EQ(after.entities, before.entities + 1000);
+    EXPECT_LE(after.hotBytes - before.hotBytes, 1000 * 16u);   // 16 bytes per record, free ones reused first
+    EXPECT_EQ(after.hotBytes % 16, 0u);
+    EXPECT_GT(after.coldBytes, before.coldBytes);
+    EXPECT_GT(after.indexBytes, before.indexBytes);
+    EXPECT_GT(after.debounceBytes, before.debounceBytes);
+
+    // records of unregistered monitors are reused
+    ASSERT_TRUE(DMEvent::UnregisterMonitor(ids[0]).HasValue());
+    ASSERT_TRUE(DMEvent::RegisterMonitor("footprint_monitor_new", event::DebounceConfig{}, nullptr).HasValue());
+    EXPECT_EQ(DMEvent::GetMemoryFootprint().hotBytes, after.hotBytes);
+    DMEvent::UnregisterMonitor("footprint_monitor_new");
+    for (std::size_t i = 1; i < ids.size(); ++i) DMEvent::UnregisterMonitor(ids[i]);
+
+    // DTCs without notifier or waiters have no side entry
+    std::vector<dtc::DtcRegistration> dtcs;
+    for (dtc::DtcId d = 0; d < 1000; ++d) dtcs.push_back(dtc::DtcRegistration{0x500000 + d, nullptr});
+    const common::MemoryFootprint dtcBefore = DMDtc::GetMemoryFootprint();
+    ASSERT_TRUE(DMDtc::RegisterDtcs(dtcs.data(), dtcs.size()).HasValue());
+    const common::MemoryFootprint dtcAfter = DMDtc::GetMemoryFootprint();
+    EXPECT_EQ(dtcAfter.entities, dtcBefore.entities + 1000);
+    EXPECT_EQ(dtcAfter.coldBytes, dtcBefore.coldBytes);
+    ASSERT_TRUE(DMDtc::SetDtcStatusNotifier(0x500000, TestDtcCallback).HasValue());
+    const std::size_t withNotifier = DMDtc::GetMemoryFootprint().coldBytes;
+    EXPECT_GT(withNotifier, dtcAfter.coldBytes);
+    ASSERT_TRUE(DMDtc::SetDtcStatusNotifier(0x500000, nullptr).HasValue());
+    EXPECT_LT(DMDtc::GetMemoryFootprint().coldBytes, withNotifier);
+    for (const auto &d : dtcs) DMDtc::UnregisterDtc(d.dtc);
+}
+
+TEST(AraDiagTest, MemoryStatisticsAttributeAllocationsToApiCalls) {
+    using namespace diagnostic_manager;
+    using common::MemorySubsystem;
+    using event::DMEvent;
+
+    const common::MemoryStatistics before = common::DmMemory::GetMemoryStatistics();
+    const event::MonitorId mid = "/ecu/accounting_swc/DiagnosticMonitor_Accounting";
+    ASSERT_TRUE(DMEvent::RegisterMonitor(mid, event::DebounceConfig{}, TestMonitorCallback).HasValue());
+    ASSERT_TRUE(dtc::DMDtc::RegisterDtc(0x600001, TestDtcCallback).HasValue());
+    ASSERT_TRUE(operation_cycle::DMOperationCycle::RegisterOperationCycle("accounting_cycle", nullptr).HasValue());
+    const common::MemoryStatistics after = common::DmMemory::GetMemoryStatistics();
+    EXPECT_EQ(after[MemorySubsystem::Monitors].objects, before[MemorySubsystem::Monitors].objects + 1);
+    EXPECT_EQ(after[MemorySubsystem::Dtcs].objects, before[MemorySubsystem::Dtcs].objects + 1);
+    EXPECT_EQ(after[MemorySubsystem::OperationCycles].objects, before[MemorySubsystem::OperationCycles].objects + 1);
+    EXPECT_EQ(after[MemorySubsystem::Notifiers].objects, before[MemorySubsystem::Notifiers].objects + 2);
+    EXPECT_GT(after[MemorySubsystem::Notifiers].bytes, before[MemorySubsystem::Notifiers].bytes);
+    EXPECT_GT(after[MemorySubsystem::Monitors].bytes, 0u);
+
+    struct Seen {
+        std::vector<std::pair<std::string, MemorySubsystem>> events;
+    } seen;
+    common::DmMemory::SetAllocationHook(
+        [](const common::AllocationEvent &e, void *context) {
+            static_cast<Seen *>(context)->events.emplace_back(e.call != nullptr ? e.call : "", e.subsystem);
+        },
+        &seen);
+    const event::MonitorId other = "/ecu/accounting_swc/DiagnosticMonitor_AccountingOther";
+    ASSERT_TRUE(DMEvent::RegisterMonitor(other, event::DebounceConfig{}, nullptr).HasValue());
+    ASSERT_FALSE(seen.events.empty());
+    for (const auto &e : seen.events) EXPECT_EQ(e.first, "DMEvent::RegisterMonitor");
+
+    // a steady-state report allocates nothing
+    const event::MonitorHandle handle = DMEvent::GetMonitorHandle(mid).value();
+    for (int i = 0; i < 8; ++i) DMEvent::ReportPreEvent(handle, i % 2 == 0);
+    seen.events.clear();
+    for (int i = 0; i < 64; ++i) DMEvent::ReportPreEvent(handle, i % 2 == 0);
+    dtc::DMDtc::ReportDtcStatus(0x600001, 0x09);
+    EXPECT_TRUE(seen.events.empty());
+    common::DmMemory::SetAllocationHook(nullptr);
+
+    DMEvent::UnregisterMonitor(mid);
+    DMEvent::UnregisterMonitor(other);
+    dtc::DMDtc::UnregisterDtc(0x600001);
+    operation_cycle::DMOperationCycle::UnregisterOperationCycle("accounting_cycle");
+    const common::MemoryStatistics end = common::DmMemory::GetMemoryStatistics();
+    EXPECT_EQ(end[MemorySubsystem::Monitors].objects, before[MemorySubsystem::Monitors].objects);
+    EXPECT_EQ(end[MemorySubsystem::Notifiers].objects, before[MemorySubsystem::Notifiers].objects);
+}
+
+TEST(AraDiagTest, LatencyTraceFollowsAReportToTheDtcNotifier) {
+    using namespace diagnostic_manager;
+    using common::LatencyTrace;
+    using common::TraceStage;
+    using event::DMEvent;
+
+    ASSERT_TRUE(dtc::DMDtc::RegisterDtc(0x600002, TestDtcCallback).HasValue());
+    event::DebounceConfig cfg;
+    cfg.failedThreshold = 2;
+    const event::MonitorId mid = "/ecu/trace_swc/DiagnosticMonitor_Trace";
+    ASSERT_TRUE(DMEvent::RegisterMonitor(mid, cfg, [](const event::MonitorId &, event::QualifiedState s) {
+                    dtc::DMDtc::ReportDtcStatus(0x600002, s == event::QualifiedState::QualifiedFailed ? 0x09 : 0x00);
+                }).HasValue());
+    const event::MonitorHandle handle = DMEvent::GetMonitorHandle(mid).value();
+
+    LatencyTrace::Reset();
+    LatencyTrace::Enable(true);
+    const std::uint64_t reported = LatencyTrace::NowNs() - 2000000;   // stamped by the app 2 ms ago
+    event::HandlePreEventUpdate first{handle, true, reported};
+    DMEvent::ReportPreEvents(&first, 1);   // debouncing: no qualification yet
+    auto stats = LatencyTrace::GetStatistics();
+    EXPECT_EQ(stats[TraceStage::Transport].count, 1u);
+    EXPECT_GE(stats[TraceStage::Transport].maxNs, 2000000u);
+    EXPECT_EQ(stats[TraceStage::Debounce].count, 0u);
+
+    event::HandlePreEventUpdate second{handle, true, reported};
+    DMEvent::ReportPreEvents(&second, 1);
+    stats = LatencyTrace::GetStatistics();
+    for (TraceStage s : {TraceStage::Debounce, TraceStage::Notify, TraceStage::DtcUpdate, TraceStage::DtcNotify,
+                         TraceStage::EndToEnd}) {
+        EXPECT_EQ(stats[s].count, 1u) << static_cast<int>(s);
+    }
+    EXPECT_GE(stats[TraceStage::EndToEnd].PercentileNs(0.5), 2000000u);
+    EXPECT_LE(stats[TraceStage::EndToEnd].PercentileNs(0.5), stats[TraceStage::EndToEnd].maxNs);
+
+    // off: nothing is recorded
+    LatencyTrace::Enable(false);
+    DMEvent::ReportPreEvent(handle, false);
+    DMEvent::ReportPreEvent(handle, false);
+    EXPECT_EQ(LatencyTrace::GetStatistics()[TraceStage::Transport].count, 2u);
+    EXPECT_EQ(LatencyTrace::GetStatistics()[TraceStage::Debounce].count, 1u);
+
+    EXPECT_EQ(common::LatencyHistogram::BucketUpperNs(common::LatencyHistogram::BucketOf(1000)), 1023u);
+    DMEvent::UnregisterMonitor(mid);
+    dtc::DMDtc::UnregisterDtc(0x600002);
+}
+
+TEST(AraDiagTest, LockProfileRecordsRegistryLocksPerCallSite) {
+    using namespace diagnostic_manager;
+    using common::LockProfile;
+
+    ASSERT_TRUE(dtc::DMDtc::RegisterDtc(0x600003, nullptr).HasValue());
+    LockProfile::Reset();
+    std::vector<std::thread> reporters;
+    for (int t = 0; t < 4; ++t) {
+        reporters.emplace_back([] {
+            for (int i = 0; i < 2000; ++i) dtc::DMDtc::ReportDtcStatus(0x600003, static_cast<dtc::UdsStatusByte>(i & 1));
+        });
+    }
+    for (auto &t : reporters) t.join();
+    const auto locks = LockProfile::GetStatistics();
+    dtc::DMDtc::UnregisterDtc(0x600003);
+    if (!LockProfile::Compiled()) {
+        EXPECT_TRUE(locks.empty());
+        return;
+    }
+
+    const common::LockStatistics *dtcs = nullptr;
+    for (const auto &l : locks) {
+        if (std::string(l.name) == "dtc.registry") dtcs = &l;
+    }
+    ASSERT_NE(dtcs, nullptr);
+    EXPECT_GE(dtcs->acquisitions, 8000u);
+    EXPECT_EQ(dtcs->wait.count, dtcs->acquisitions);
+    EXPECT_EQ(dtcs->hold.count, dtcs->acquisitions);
+    EXPECT_LE(dtcs->contended, dtcs->acquisitions);
+    ASSERT_FALSE(dtcs->sites.empty());
+    bool reportSite = false;
+    for (const auto &s : dtcs->sites) reportSite |= std::string(s.site) == "ReportDtcStatus" && s.acquisitions >= 8000u;
+    EXPECT_TRUE(reportSite);
+}
+
+#if defined(__cpp_impl_coroutine)
+// Minimal fire-and-forget coroutine for the awaitables
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+Detached AwaitQualified(const diagnostic_manager::event::MonitorId &id, std::atomic<int> *failed) {
+    using namespace diagnostic_manager;
+    auto state = co_await common::NextQualifiedState(id);
+    if (state.HasValue() && state.Value() == event::QualifiedState::QualifiedFailed) ++*failed;
+}
+
+Detached AwaitDtcThenClear(std::promise<std::uint8_t> *seen, std::promise<bool> *cleared) {
+    using namespace diagnostic_manager;
+    auto status = co_await common::DtcStatusMatching(0x77, 0x08);
+    seen->set_value(status.ValueOr(0));
+    auto res = co_await common::ClearDtc(0x77, common::LaneScheduler{common::TaskLane::Latency});
+    cleared->set_value(res.HasValue());
+}
+
+Detached AwaitCycleState(const diagnostic_manager::operation_cycle::OpCycleId &id, std::atomic<int> *active, std::atomic<int> *gone) {
+    using namespace diagnostic_manager;
+    auto state = co_await common::NextOperationCycleState(id);
+    if (state.HasValue() && state.Value()) ++*active;
+    if (state.HasError() && state.Error() == std::errc::no_such_file_or_directory) ++*gone;
+}
+
+TEST(AraDiagTest, CoroutineWaitsResumeWithoutBlockingThreads) {
+    using namespace diagnostic_manager;
+    const event::MonitorId mid = "coro_monitor";
+    ASSERT_TRUE(event::DMEvent::RegisterMonitor(mid, event::DebounceConfig{}, nullptr).HasValue());
+    ASSERT_TRUE(dtc::DMDtc::RegisterDtc(0x77).HasValue());
+
+    std::atomic<int> failed{0};
+    for (int i = 0; i < 100; ++i) AwaitQualified(mid, &failed);
+    std::promise<std::uint8_t> seen;
+    std::promise<bool> cleared;
+    AwaitDtcThenClear(&seen, &cleared);
+
+    for (int i = 0; i < 3; ++i) event::DMEvent::ReportPreEvent(mid, true);
+    EXPECT_EQ(failed.load(), 100);
+
+    dtc::DMDtc::ReportDtcStatus(0x77, 0x01);   // mask not matched
+    dtc::DMDtc::ReportDtcStatus(0x77, 0x09);
+    auto seenFuture = seen.get_future();
+    ASSERT_EQ(seenFuture.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(seenFuture.get(), 0x09);
+    auto clearedFuture = cleared.get_future();
+    ASSERT_EQ(clearedFuture.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_TRUE(clearedFuture.get());
+    EXPECT_EQ(dtc::DMDtc::GetCurrentStatus(0x77), std::optional<std::uint8_t>(0));
+
+    dtc::DMDtc::UnregisterDtc(0x77);
+    event::DMEvent::UnregisterMonitor(mid);
+}
+
+TEST(AraDiagTest, CoroutineWaitsForOperationCycleStateChanges) {
+    using namespace diagnostic_manager;
+    const operation_cycle::OpCycleId cycle = "coro_cycle";
+    ASSERT_TRUE(operation_cycle::DMOperationCycle::RegisterOperationCycle(cycle).HasValue());
+
+    std::atomic<int> active{0};
+    std::atomic<int> gone{0};
+    for (int i = 0; i < 10; ++i) AwaitCycleState(cycle, &active, &gone);
+    operation_cycle::DMOperationCycle::SetOperationCycleState(cycle, false);   // no change
+    EXPECT_EQ(active.load(), 0);
+    operation_cycle::DMOperationCycle::SetOperationCycleState(cycle, true);
+    EXPECT_EQ(active.load(), 10);
+
+    AwaitCycleState(cycle, &active, &gone);
+    operation_cycle::DMOperationCycle::UnregisterOperationCycle(cycle);
+    EXPECT_EQ(gone.load(), 1);
+    AwaitCycleState(cycle, &active, &gone);   // unknown cycle
+    EXPECT_EQ(gone.load(), 2);
+    EXPECT_EQ(active.load(), 10);
+}
+#endif
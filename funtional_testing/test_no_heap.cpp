@@ -0,0 +1,129 @@
+// Steady-state allocation check. Replaces the global operator new and
+// delete, so it is built as a binary of its own (dm_no_heap_test).
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include "common/dm_memory.h"
+#include "dtc/dm_dtc.h"
+#include "event/dm_event.h"
+#include "operationcycle/dm_operation_cycle.h"
+
+static std::atomic<bool> g_counting{false};
+static std::atomic<std::uint64_t> g_allocations{0};
+
+// Scalar and array forms are replaced in pairs, each on the counting
+// allocator, so every delete matches the new that made the block.
+static void *counted_alloc(std::size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+static void counted_free(void *p) noexcept { std::free(p); }
+
+void *operator new(std::size_t size) { return counted_alloc(size); }
+void *operator new[](std::size_t size) { return counted_alloc(size); }
+void operator delete(void *p) noexcept { counted_free(p); }
+void operator delete(void *p, std::size_t) noexcept { counted_free(p); }
+void operator delete[](void *p) noexcept { counted_free(p); }
+void operator delete[](void *p, std::size_t) noexcept { counted_free(p); }
+
+// Runs first: only static initialisation has happened, and that must not
+// create the DM memory pools, or the binary's strict mode cannot be set.
+TEST(NoHeapTest, MemoryCanBeConfiguredAfterStaticInitialisation) {
+    using namespace diagnostic_manager;
+    EXPECT_TRUE(common::DmMemory::Configure(common::MemoryConfig{}).HasValue());
+}
+
+TEST(NoHeapTest, SteadyStateReportsDoNotAllocate) {
+    using namespace diagnostic_manager;
+    using event::DMEvent;
+
+    // Long names: a copy of one would not fit the small-string buffer.
+    const event::MonitorId counter = "/ecu/no_heap_swc/DiagnosticMonitor_CounterBased";
+    const event::MonitorId internal = "/ecu/no_heap_swc/DiagnosticMonitor_MonitorInternal";
+    const operation_cycle::OpCycleId cycle = "/ecu/no_heap_swc/OperationCycle_Ignition";
+    std::uint64_t calls = 0;
+    event::DebounceConfig cfg;
+    cfg.failedThreshold = 2;
+    cfg.passedThreshold = 2;
+    ASSERT_TRUE(DMEvent::RegisterMonitor(counter, cfg, [&calls](const event::MonitorId &, event::QualifiedState) { ++calls; }).HasValue());
+    event::DebounceConfig internalCfg;
+    internalCfg.mode = event::DebounceMode::MonitorInternal;
+    ASSERT_TRUE(DMEvent::RegisterMonitor(internal, internalCfg, nullptr).HasValue());
+    ASSERT_TRUE(DMEvent::SetEventStatusNotifier(internal, [&calls](const event::MonitorId &, std::uint8_t) { ++calls; }).HasValue());
+    ASSERT_TRUE(dtc::DMDtc::RegisterDtc(0x4242, [&calls](dtc::DtcId, dtc::UdsStatusByte, dtc::UdsStatusByte) { ++calls; }).HasValue());
+    ASSERT_TRUE(operation_cycle::DMOperationCycle::RegisterOperationCycle(cycle, [&calls](const operation_cycle::OpCycleId &, bool) { ++calls; }).HasValue());
+    const event::MonitorHandle handle = DMEvent::GetMonitorHandle(counter).value();
+
+    const event::PreEventUpdate batch[] = {{&counter, true}, {&counter, true}, {&counter, false}, {&counter, false}};
+    const event::QualifiedUpdate qualified[] = {{&internal, event::QualifiedState::QualifiedFailed},
+                                                {&internal, event::QualifiedState::QualifiedPassed}};
+    auto steadyState = [&](int round) {
+        const bool failed = round % 2 == 0;
+        DMEvent::ReportPreEvent(counter, failed);
+        DMEvent::ReportPreEvent(counter, failed);
+        DMEvent::ReportPreEvent(handle, !failed);
+        DMEvent::ReportPreEvent(handle, !failed);
+        DMEvent::ReportPreEvents(batch, 4);
+        DMEvent::SetQualifiedStates(qualified, 2);
+        DMEvent::GetQualifiedState(counter);
+        DMEvent::GetEventStatus(internal);
+        dtc::DMDtc::ReportDtcStatus(0x4242, failed ? 0x09 : 0x00);
+        operation_cycle::DMOperationCycle::SetOperationCycleState(cycle, failed);
+    };
+    for (int i = 0; i < 4; ++i) steadyState(i);   // scratch buffers reach their size
+
+    common::DmMemory::Initialize();
+    const std::uint64_t notified = calls;
+    g_counting = true;
+    for (int i = 0; i < 1000; ++i) steadyState(i);
+    g_counting = false;
+
+    EXPECT_EQ(g_allocations.load(), 0u);
+    EXPECT_EQ(common::DmMemory::HeapAllocationsAfterInit(), 0u);
+    EXPECT_GT(calls - notified, 1000u);
+}
+
+TEST(NoHeapTest, OverloadModeAndStateStreamsDoNotAllocateAfterInit) {
+    using namespace diagnostic_manager;
+    using event::DMEvent;
+
+    const event::MonitorId filtered = "/ecu/no_heap_swc/DiagnosticMonitor_OverloadFiltered";
+    const event::MonitorId streamed = "/ecu/no_heap_swc/DiagnosticMonitor_Streamed";
+    event::DebounceConfig cfg;
+    cfg.failedThreshold = 2;
+    cfg.passedThreshold = 2;
+    ASSERT_TRUE(DMEvent::RegisterMonitor(filtered, cfg, nullptr).HasValue());
+    ASSERT_TRUE(DMEvent::RegisterMonitor(streamed, cfg, nullptr).HasValue());
+    const event::MonitorHandle handle = DMEvent::GetMonitorHandle(filtered).value();
+    const event::HandlePreEventUpdate batch[] = {{handle, true}, {handle, true}, {handle, true}, {handle, false}};
+
+    common::DmMemory::Initialize();
+    const std::uint64_t heapBefore = common::DmMemory::HeapAllocationsAfterInit();
+    g_counting = true;
+    DMEvent::SetOverloadPolicy(event::OverloadPolicy{true, 200, event::OverloadAction::Drop});
+    for (int i = 0; i < 1000; ++i) {
+        DMEvent::ReportPreEvents(batch, 4);
+        DMEvent::ReportPreEvent(handle, i % 2 == 0);
+    }
+    DMEvent::SetOverloadPolicy(event::OverloadPolicy{});
+
+    // the stream and the handle it publishes for `streamed` come from the pools
+    const auto stream = DMEvent::OpenStateStream(64);
+    ASSERT_TRUE(stream.HasValue());
+    event::StateChange changes[8];
+    std::size_t read = 0;
+    for (int i = 0; i < 100; ++i) {
+        DMEvent::ReportPreEvent(streamed, i % 4 < 2);
+        read += DMEvent::ReadStateStream(stream.Value(), changes, 8);
+    }
+    EXPECT_TRUE(DMEvent::CloseStateStream(stream.Value()).HasValue());
+    g_counting = false;
+
+    EXPECT_EQ(g_allocations.load(), 0u);
+    EXPECT_EQ(common::DmMemory::HeapAllocationsAfterInit(), heapBefore);
+    EXPECT_GT(DMEvent::GetOverloadStatistics().filtered, 0u);
+    EXPECT_EQ(read, 50u);
+}